@@ -9,6 +9,25 @@
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "RMDLBinarySpacePartitioning.hpp"
+#include "RMDLFixed.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+// Same representation as Fixed (int, 8 fractional bits); does the arithmetic in integers.
+using NativeFixed = fixed::Fixed<int, 8>;
+
+static NativeFixed  sNative(const Fixed &f)
+{
+    return (NativeFixed::fromRaw(f.getRawBits()));
+}
+
+static Fixed        sFromNative(NativeFixed f)
+{
+    Fixed   result;
+    result.setRawBits(f.raw());
+    return (result);
+}
 
 Fixed::Fixed() : _fixedPointValue(0)
 {
@@ -18,7 +37,7 @@ Fixed::Fixed(const int n) : _fixedPointValue(n <<  _fractionalBits)
 {
 }
 
-Fixed::Fixed(const float n) : _fixedPointValue( std::roundf(n * (1 << _fractionalBits)) )
+Fixed::Fixed(const float n) : _fixedPointValue( NativeFixed::fromFloat(n).raw() )
 {
 }
 
@@ -91,22 +110,22 @@ bool    Fixed::operator != (const Fixed &rhs) const
 
 Fixed   Fixed::operator + (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() + rhs.toFloat()));
+    return (sFromNative(sNative(*this) + sNative(rhs)));
 }
 
 Fixed   Fixed::operator - (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() - rhs.toFloat()));
+    return (sFromNative(sNative(*this) - sNative(rhs)));
 }
 
 Fixed   Fixed::operator * (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() * rhs.toFloat()));
+    return (sFromNative(sNative(*this) * sNative(rhs)));
 }
 
 Fixed   Fixed::operator / (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() / rhs.toFloat()));
+    return (sFromNative(sNative(*this) / sNative(rhs)));
 }
 
 Fixed   &Fixed::operator ++ ()
@@ -221,12 +240,291 @@ bool bsp(Point const a, Point const b, Point const c, Point const point)
     Fixed   pabArea = abs(area(point, a, b));
     Fixed   pbcArea = abs(area(point, b, c));
     Fixed   pcaArea = abs(area(point, c, a));
-    std::cout << "abcArea: " << abcArea << ", pabArea: " << pabArea
-              << ", pbcArea: " << pbcArea << ", pcaArea: " << pcaArea << std::endl << std::endl;
 
     return (abcArea == pabArea + pbcArea + pcaArea);
 }
 
+namespace
+{
+    struct WorkPolygon
+    {
+        uint32_t    firstVertex;
+        uint32_t    vertexCount;
+        uint32_t    sourceTriangle;
+    };
+
+    enum PolygonSide
+    {
+        kPolygonOn,
+        kPolygonFront,
+        kPolygonBack,
+        kPolygonSpanning
+    };
+
+    class BspBuilder
+    {
+    public:
+        BspBuilder(const spatial::BspBuildSettings& settings,
+                   std::vector<spatial::BspNode>& nodes, std::vector<spatial::BspPolygon>& polygons,
+                   std::vector<simd_float3>& vertices, std::vector<spatial::BspLeaf>& leaves)
+            : _settings(settings), _nodes(nodes), _polygons(polygons), _vertices(vertices), _leaves(leaves),
+              _splitCount(0), _depth(0)
+        {
+        }
+
+        std::vector<simd_float3>    workVertices;
+
+        int32_t     build(std::vector<WorkPolygon> input);
+        uint32_t    splitCount() const { return (_splitCount); }
+        uint32_t    depth() const { return (_depth); }
+
+    private:
+        PolygonSide classify(const WorkPolygon& polygon, simd_float4 plane) const;
+        simd_float4 planeOf(const WorkPolygon& polygon) const;
+        size_t      chooseSplitter(const std::vector<WorkPolygon>& polygons) const;
+        void        split(const WorkPolygon& polygon, simd_float4 plane, std::vector<WorkPolygon>& front, std::vector<WorkPolygon>& back);
+
+        const spatial::BspBuildSettings&    _settings;
+        std::vector<spatial::BspNode>&      _nodes;
+        std::vector<spatial::BspPolygon>&   _polygons;
+        std::vector<simd_float3>&           _vertices;
+        std::vector<spatial::BspLeaf>&      _leaves;
+        uint32_t                            _splitCount;
+        uint32_t                            _depth;
+    };
+
+    inline float sDistance(simd_float4 plane, simd_float3 p)
+    {
+        return (simd_dot(plane.xyz, p) - plane.w);
+    }
+
+    simd_float4 BspBuilder::planeOf(const WorkPolygon& polygon) const
+    {
+        // Newell's method: robust for the slightly non-planar fragments splitting can produce.
+        simd_float3 normal = simd_make_float3(0.f, 0.f, 0.f);
+        simd_float3 centroid = simd_make_float3(0.f, 0.f, 0.f);
+        for (uint32_t i = 0; i < polygon.vertexCount; ++i)
+        {
+            const simd_float3 a = workVertices[polygon.firstVertex + i];
+            const simd_float3 b = workVertices[polygon.firstVertex + (i + 1) % polygon.vertexCount];
+            normal += simd_make_float3((a.y - b.y) * (a.z + b.z), (a.z - b.z) * (a.x + b.x), (a.x - b.x) * (a.y + b.y));
+            centroid += a;
+        }
+        normal = simd_normalize(normal);
+        centroid /= (float)polygon.vertexCount;
+        return (simd_make_float4(normal, simd_dot(normal, centroid)));
+    }
+
+    PolygonSide BspBuilder::classify(const WorkPolygon& polygon, simd_float4 plane) const
+    {
+        uint32_t front = 0;
+        uint32_t back = 0;
+        for (uint32_t i = 0; i < polygon.vertexCount; ++i)
+        {
+            const float d = sDistance(plane, workVertices[polygon.firstVertex + i]);
+            front += d > _settings.planeEpsilon;
+            back += d < -_settings.planeEpsilon;
+        }
+        if (front && back)
+            return (kPolygonSpanning);
+        if (front)
+            return (kPolygonFront);
+        if (back)
+            return (kPolygonBack);
+        return (kPolygonOn);
+    }
+
+    size_t BspBuilder::chooseSplitter(const std::vector<WorkPolygon>& polygons) const
+    {
+        const size_t candidates = std::min<size_t>(polygons.size(), std::max<uint32_t>(_settings.maxCandidates, 1));
+        const size_t step = polygons.size() / candidates;
+        size_t best = 0;
+        float bestCost = INFINITY;
+        for (size_t c = 0; c < candidates; ++c)
+        {
+            const simd_float4 plane = planeOf(polygons[c * step]);
+            uint32_t front = 0, back = 0, splits = 0;
+            for (const WorkPolygon& polygon : polygons)
+            {
+                switch (classify(polygon, plane))
+                {
+                    case kPolygonFront:     ++front; break;
+                    case kPolygonBack:      ++back; break;
+                    case kPolygonSpanning:  ++splits; ++front; ++back; break;
+                    case kPolygonOn:        break;
+                }
+            }
+            const float cost = _settings.splitWeight * splits + _settings.balanceWeight * std::abs((float)front - (float)back);
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                best = c * step;
+                if (cost == 0.f)
+                    break;
+            }
+        }
+        return (best);
+    }
+
+    void BspBuilder::split(const WorkPolygon& polygon, simd_float4 plane, std::vector<WorkPolygon>& front, std::vector<WorkPolygon>& back)
+    {
+        // Sutherland-Hodgman against both half-spaces; vertices on the plane go to both sides.
+        // The pieces are appended to workVertices, which may reallocate, so the source vertices
+        // are copied out first.
+        const std::vector<simd_float3> source(workVertices.begin() + polygon.firstVertex,
+                                              workVertices.begin() + polygon.firstVertex + polygon.vertexCount);
+        const float eps = _settings.planeEpsilon;
+        WorkPolygon pieces[2] = { { (uint32_t)workVertices.size(), 0, polygon.sourceTriangle }, { 0, 0, polygon.sourceTriangle } };
+        std::vector<simd_float3> backVertices;
+        backVertices.reserve(polygon.vertexCount + 1);
+        for (uint32_t i = 0; i < polygon.vertexCount; ++i)
+        {
+            const simd_float3 a = source[i];
+            const simd_float3 b = source[(i + 1) % polygon.vertexCount];
+            const float da = sDistance(plane, a);
+            const float db = sDistance(plane, b);
+            if (da >= -eps)
+                workVertices.push_back(a);
+            if (da <= eps)
+                backVertices.push_back(a);
+            if ((da > eps && db < -eps) || (da < -eps && db > eps))
+            {
+                const simd_float3 p = a + (b - a) * (da / (da - db));
+                workVertices.push_back(p);
+                backVertices.push_back(p);
+            }
+        }
+        pieces[0].vertexCount = (uint32_t)workVertices.size() - pieces[0].firstVertex;
+        pieces[1].firstVertex = (uint32_t)workVertices.size();
+        pieces[1].vertexCount = (uint32_t)backVertices.size();
+        workVertices.insert(workVertices.end(), backVertices.begin(), backVertices.end());
+        if (pieces[0].vertexCount >= 3)
+            front.push_back(pieces[0]);
+        if (pieces[1].vertexCount >= 3)
+            back.push_back(pieces[1]);
+        ++_splitCount;
+    }
+
+    int32_t BspBuilder::build(std::vector<WorkPolygon> input)
+    {
+        // An explicit work stack rather than recursion: a soup of many parallel triangles makes
+        // the tree as deep as it has polygons, far past what the call stack holds. The front task
+        // is pushed last so it runs first, which keeps the depth-first node order.
+        struct Task
+        {
+            std::vector<WorkPolygon>    polygons;
+            int32_t                     parent;
+            bool                        front;
+            uint32_t                    depth;
+        };
+        std::vector<Task> stack;
+        stack.push_back(Task{ std::move(input), -1, true, 0 });
+        int32_t root = ~0;
+
+        while (!stack.empty())
+        {
+            Task task = std::move(stack.back());
+            stack.pop_back();
+            _depth = std::max(_depth, task.depth);
+
+            int32_t child;
+            if (task.polygons.empty())
+            {
+                _leaves.push_back(spatial::BspLeaf{ task.parent });
+                child = ~(int32_t)(_leaves.size() - 1);
+            }
+            else
+            {
+                const std::vector<WorkPolygon>& polygons = task.polygons;
+                const size_t splitter = chooseSplitter(polygons);
+                const simd_float4 plane = planeOf(polygons[splitter]);
+                std::vector<WorkPolygon> front;
+                std::vector<WorkPolygon> back;
+                child = (int32_t)_nodes.size();
+                _nodes.push_back(spatial::BspNode{ plane, 0, 0, (uint32_t)_polygons.size(), 0 });
+                for (size_t i = 0; i < polygons.size(); ++i)
+                {
+                    const WorkPolygon& polygon = polygons[i];
+                    // The splitter always stays on its own node so every level makes progress.
+                    switch (i == splitter ? kPolygonOn : classify(polygon, plane))
+                    {
+                        case kPolygonFront:     front.push_back(polygon); break;
+                        case kPolygonBack:      back.push_back(polygon); break;
+                        case kPolygonSpanning:  split(polygon, plane, front, back); break;
+                        case kPolygonOn:
+                            _polygons.push_back(spatial::BspPolygon{ (uint32_t)_vertices.size(), polygon.vertexCount, polygon.sourceTriangle, (uint32_t)child });
+                            _vertices.insert(_vertices.end(), workVertices.begin() + polygon.firstVertex, workVertices.begin() + polygon.firstVertex + polygon.vertexCount);
+                            break;
+                    }
+                }
+                _nodes[child].polygonCount = (uint32_t)_polygons.size() - _nodes[child].firstPolygon;
+                stack.push_back(Task{ std::move(back), child, false, task.depth + 1 });
+                stack.push_back(Task{ std::move(front), child, true, task.depth + 1 });
+            }
+
+            if (task.parent < 0)
+                root = child;
+            else if (task.front)
+                _nodes[task.parent].front = child;
+            else
+                _nodes[task.parent].back = child;
+        }
+        return (root);
+    }
+}
+
+namespace spatial
+{
+    BspTree::BspTree() : _root(~0), _splitCount(0), _depth(0)
+    {
+    }
+
+    void BspTree::build(const void* pPositions, size_t stride, size_t vertexCount,
+                        const uint32_t* pIndices, size_t indexCount,
+                        const BspBuildSettings& settings)
+    {
+        _nodes.clear();
+        _polygons.clear();
+        _vertices.clear();
+        _leaves.clear();
+
+        BspBuilder builder(settings, _nodes, _polygons, _vertices, _leaves);
+        std::vector<WorkPolygon> input;
+        input.reserve(indexCount / 3);
+        builder.workVertices.reserve(indexCount * 2);
+        for (size_t t = 0; t + 2 < indexCount; t += 3)
+        {
+            simd_float3 p[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                assert(pIndices[t + k] < vertexCount);
+                const float* pPosition = (const float *)((const uint8_t *)pPositions + pIndices[t + k] * stride);
+                p[k] = simd_make_float3(pPosition[0], pPosition[1], pPosition[2]);
+            }
+            // Zero-area triangles have no plane and are never visible.
+            if (simd_length_squared(simd_cross(p[1] - p[0], p[2] - p[0])) <= 0.f)
+                continue;
+            input.push_back(WorkPolygon{ (uint32_t)builder.workVertices.size(), 3, (uint32_t)(t / 3) });
+            builder.workVertices.insert(builder.workVertices.end(), p, p + 3);
+        }
+
+        _root = builder.build(std::move(input));
+        _splitCount = builder.splitCount();
+        _depth = builder.depth();
+    }
+
+    uint32_t BspTree::findLeaf(simd_float3 point) const
+    {
+        int32_t child = _root;
+        while (child >= 0)
+        {
+            const BspNode& node = _nodes[child];
+            child = sDistance(node.plane, point) >= 0.f ? node.front : node.back;
+        }
+        return (leafIndex(child));
+    }
+}
+
 /*int main(void)
 {
     Fixed a;
@@ -13,6 +13,9 @@
 
 # include <iostream>
 # include <cmath>
+# include <cstdint>
+# include <vector>
+# include "RMDLSimd.hpp"
 
 class   Fixed {
 public:
@@ -80,4 +83,149 @@ private:
     const Fixed _y;
 };
 
+namespace spatial
+{
+    /// Split-plane selection for BspTree::build. Each candidate plane is scored as
+    /// splitWeight * (polygons it cuts) + balanceWeight * |front count - back count|
+    /// and the cheapest one is used.
+    struct BspBuildSettings
+    {
+        float       splitWeight = 8.f;
+        float       balanceWeight = 1.f;
+        uint32_t    maxCandidates = 32;     // planes tried per node, spread evenly over its polygons
+        float       planeEpsilon = 1e-4f;   // vertices closer than this to a plane lie on it
+    };
+
+    /// Children are node indices when >= 0 and ~leafIndex when < 0.
+    /// Nodes are stored in depth-first order, so a front child directly follows its parent.
+    struct BspNode
+    {
+        simd_float4 plane;          // xyz normal, w distance: dot(normal, p) - w is the signed distance
+        int32_t     front;
+        int32_t     back;
+        uint32_t    firstPolygon;   // polygons lying in the plane, both facings
+        uint32_t    polygonCount;
+    };
+
+    /// A convex polygon, possibly a fragment of a triangle cut by split planes.
+    struct BspPolygon
+    {
+        uint32_t    firstVertex;
+        uint32_t    vertexCount;
+        uint32_t    sourceTriangle;     // index of the input triangle it was cut from
+        uint32_t    node;
+    };
+
+    /// An empty convex region of space; the cells used for visibility.
+    struct BspLeaf
+    {
+        int32_t     parent;             // node index, -1 when the whole tree is one leaf
+    };
+
+    enum class BspOrder
+    {
+        FrontToBack,
+        BackToFront
+    };
+
+    /// Node-based BSP tree compiled from a static triangle soup. Every polygon ends up on exactly
+    /// one node plane, so walking the tree from an eye position yields a strict visibility order
+    /// without any per-frame sorting.
+    class BspTree
+    {
+    public:
+        BspTree();
+
+        /// Builds from a triangle list. Positions are three floats read from pPositions + i * stride,
+        /// so interleaved vertices such as rmdl::Vertex can be passed directly.
+        void    build(const void* pPositions, size_t stride, size_t vertexCount,
+                      const uint32_t* pIndices, size_t indexCount,
+                      const BspBuildSettings& settings = BspBuildSettings());
+
+        /// Calls visit(polygonIndex) for every polygon, ordered front-to-back (opaque, less overdraw)
+        /// or back-to-front (transparent, painter's order) as seen from eye.
+        template <typename Visit>
+        void    traverse(simd_float3 eye, BspOrder order, Visit&& visit) const;
+
+        /// Same walk with its node stack in pStack, which must hold traversalStackSize() entries.
+        /// The overload above keeps the stack in a local array up to kInlineStackDepth and only
+        /// allocates for deeper trees, so callers walking those every frame pass a buffer here.
+        template <typename Visit>
+        void    traverse(simd_float3 eye, BspOrder order, int32_t* pStack, Visit&& visit) const;
+
+        static constexpr uint32_t kInlineStackDepth = 64;
+        uint32_t    traversalStackSize() const { return (_depth + 1); }
+
+        /// Index of the leaf containing point.
+        uint32_t    findLeaf(simd_float3 point) const;
+
+        int32_t                         root() const { return (_root); }
+        const std::vector<BspNode>&     nodes() const { return (_nodes); }
+        const std::vector<BspPolygon>&  polygons() const { return (_polygons); }
+        const std::vector<simd_float3>& vertices() const { return (_vertices); }
+        const std::vector<BspLeaf>&     leaves() const { return (_leaves); }
+        uint32_t                        splitCount() const { return (_splitCount); }
+        uint32_t                        depth() const { return (_depth); }
+
+        static bool     isLeaf(int32_t child) { return (child < 0); }
+        static uint32_t leafIndex(int32_t child) { return ((uint32_t)~child); }
+
+    private:
+        std::vector<BspNode>        _nodes;
+        std::vector<BspPolygon>     _polygons;
+        std::vector<simd_float3>    _vertices;
+        std::vector<BspLeaf>        _leaves;
+        int32_t                     _root;
+        uint32_t                    _splitCount;
+        uint32_t                    _depth;
+    };
+
+    template <typename Visit>
+    void BspTree::traverse(simd_float3 eye, BspOrder order, Visit&& visit) const
+    {
+        if (_depth < kInlineStackDepth)
+        {
+            int32_t stack[kInlineStackDepth];
+            traverse(eye, order, stack, visit);
+        }
+        else
+        {
+            std::vector<int32_t> stack(traversalStackSize());
+            traverse(eye, order, stack.data(), visit);
+        }
+    }
+
+    template <typename Visit>
+    void BspTree::traverse(simd_float3 eye, BspOrder order, int32_t* pStack, Visit&& visit) const
+    {
+        // In-order walk with an explicit stack, since the depth is not bounded: go down the first
+        // side, then pop a node, emit its polygons and continue into its second side. At most one
+        // entry per node on a root-to-leaf path is pending, which _depth bounds.
+        uint32_t top = 0;
+        const bool nearFirst = order == BspOrder::FrontToBack;
+        auto frontFirst = [&](const BspNode& node)
+        {
+            const bool eyeInFront = simd_dot(node.plane.xyz, eye) - node.plane.w >= 0.f;
+            return (eyeInFront == nearFirst);
+        };
+
+        int32_t child = _root;
+        for (;;)
+        {
+            while (child >= 0)
+            {
+                pStack[top++] = child;
+                const BspNode& node = _nodes[child];
+                child = frontFirst(node) ? node.front : node.back;
+            }
+            if (!top)
+                break;
+            const BspNode& node = _nodes[pStack[--top]];
+            for (uint32_t i = 0; i < node.polygonCount; ++i)
+                visit(node.firstPolygon + i);
+            child = frontFirst(node) ? node.back : node.front;
+        }
+    }
+}
+
 #endif /* BSP */
\ No newline at end of file
@@ -0,0 +1,293 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLBroadphase.cpp           +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:58:20      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLBroadphase.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace physics
+{
+    UniformGrid::UniformGrid()
+    : _hashed(false)
+    , _minX(0.f)
+    , _minY(0.f)
+    , _invCellSize(1.f)
+    , _columns(1)
+    , _rows(1)
+    , _cellStart(2, 0)
+    {
+    }
+
+    void UniformGrid::configureBounded(float minX, float minY, float maxX, float maxY, float cellSize)
+    {
+        _hashed = false;
+        _minX = minX;
+        _minY = minY;
+        _invCellSize = 1.f / cellSize;
+        _columns = std::max(1, (int32_t)ceilf((maxX - minX) * _invCellSize));
+        _rows = std::max(1, (int32_t)ceilf((maxY - minY) * _invCellSize));
+        _cellStart.assign((size_t)_columns * _rows + 1, 0);
+    }
+
+    void UniformGrid::configureHashed(float cellSize, uint32_t bucketCount)
+    {
+        uint32_t buckets = 1;
+        while (buckets < bucketCount)
+            buckets <<= 1;
+        _hashed = true;
+        _minX = 0.f;
+        _minY = 0.f;
+        _invCellSize = 1.f / cellSize;
+        _columns = 0;
+        _rows = 0;
+        _cellStart.assign((size_t)buckets + 1, 0);
+    }
+
+    void UniformGrid::configureCells(int32_t columns, int32_t rows)
+    {
+        // Called every tick by the sim; the table only needs resetting when the size changes.
+        if (!_hashed && _minX == 0.f && _minY == 0.f && _invCellSize == 1.f && _columns == columns && _rows == rows)
+            return;
+        configureBounded(0.f, 0.f, (float)columns, (float)rows, 1.f);
+    }
+
+    int32_t UniformGrid::cellX(float x) const
+    {
+        const int32_t cell = (int32_t)floorf((x - _minX) * _invCellSize);
+        return (_hashed ? cell : std::clamp(cell, 0, _columns - 1));
+    }
+
+    int32_t UniformGrid::cellY(float y) const
+    {
+        const int32_t cell = (int32_t)floorf((y - _minY) * _invCellSize);
+        return (_hashed ? cell : std::clamp(cell, 0, _rows - 1));
+    }
+
+    uint32_t UniformGrid::bucket(int32_t x, int32_t y) const
+    {
+        if (!_hashed)
+            return ((uint32_t)(y * _columns + x));
+        const uint32_t h = ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u);
+        return (h & (bucketCount() - 1));
+    }
+
+    void UniformGrid::build(const float* pX, const float* pY, size_t count, size_t stride)
+    {
+        _itemBucket.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            _itemBucket[i] = bucket(cellX(pX[i * stride]), cellY(pY[i * stride]));
+        sortItems(count);
+    }
+
+    void UniformGrid::buildCells(const int32_t* pCellX, const int32_t* pCellY, size_t count)
+    {
+        _itemBucket.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            _itemBucket[i] = bucket(std::clamp(pCellX[i], 0, _columns - 1), std::clamp(pCellY[i], 0, _rows - 1));
+        sortItems(count);
+    }
+
+    std::span<const uint32_t> UniformGrid::cellItems(int32_t x, int32_t y) const
+    {
+        const uint32_t b = bucket(std::clamp(x, 0, _columns - 1), std::clamp(y, 0, _rows - 1));
+        return (std::span<const uint32_t>(_items.data() + _cellStart[b], _cellStart[b + 1] - _cellStart[b]));
+    }
+
+    // Counting sort of the items by _itemBucket: count per bucket, prefix sum, scatter. Stable, so
+    // every bucket lists its items in increasing index order.
+    void UniformGrid::sortItems(size_t count)
+    {
+        const uint32_t buckets = bucketCount();
+        _items.resize(count);
+        std::fill(_cellStart.begin(), _cellStart.end(), 0);
+
+        for (size_t i = 0; i < count; ++i)
+            ++_cellStart[_itemBucket[i] + 1];
+        for (uint32_t b = 0; b < buckets; ++b)
+            _cellStart[b + 1] += _cellStart[b];
+        // Scatter through a running cursor per bucket; _cellStart[b] serves as that cursor and is
+        // shifted back afterwards, so no second table is needed.
+        for (size_t i = 0; i < count; ++i)
+            _items[_cellStart[_itemBucket[i]]++] = (uint32_t)i;
+        for (uint32_t b = buckets; b > 0; --b)
+            _cellStart[b] = _cellStart[b - 1];
+        _cellStart[0] = 0;
+    }
+
+    size_t UniformGrid::findPairs(const float* pX, const float* pY, size_t count, size_t stride, std::vector<CandidatePair>& pairs) const
+    {
+        const size_t capacity = pairs.capacity();
+        size_t found = 0;
+        pairs.clear();
+
+        for (size_t q = 0; q < count; ++q)
+        {
+            const int32_t x = cellX(pX[q * stride]);
+            const int32_t y = cellY(pY[q * stride]);
+            uint32_t visited[9];
+            uint32_t visitedCount = 0;
+
+            for (int32_t dy = -1; dy <= 1; ++dy)
+            {
+                for (int32_t dx = -1; dx <= 1; ++dx)
+                {
+                    if (!_hashed && (x + dx < 0 || x + dx >= _columns || y + dy < 0 || y + dy >= _rows))
+                        continue;
+                    const uint32_t b = bucket(x + dx, y + dy);
+                    // Neighbouring cells may hash to the same bucket; visit it once.
+                    if (_hashed && std::find(visited, visited + visitedCount, b) != visited + visitedCount)
+                        continue;
+                    visited[visitedCount++] = b;
+
+                    const uint32_t end = _cellStart[b + 1];
+                    for (uint32_t k = _cellStart[b]; k < end; ++k, ++found)
+                    {
+                        if (pairs.size() < capacity)
+                            pairs.push_back(CandidatePair{ (uint32_t)q, _items[k] });
+                    }
+                }
+            }
+        }
+        return (found);
+    }
+
+    size_t UniformGrid::findSweptPairs(const float* pX, const float* pY, size_t count, size_t stride,
+                                       float deltaX, float deltaY, std::vector<CandidatePair>& pairs) const
+    {
+        const size_t capacity = pairs.capacity();
+        size_t found = 0;
+        pairs.clear();
+
+        for (size_t q = 0; q < count; ++q)
+        {
+            const float x = pX[q * stride];
+            const float y = pY[q * stride];
+            int32_t minX = cellX(std::min(x, x + deltaX)) - 1;
+            int32_t minY = cellY(std::min(y, y + deltaY)) - 1;
+            int32_t maxX = cellX(std::max(x, x + deltaX)) + 1;
+            int32_t maxY = cellY(std::max(y, y + deltaY)) + 1;
+            if (!_hashed)
+            {
+                minX = std::max(minX, 0);
+                minY = std::max(minY, 0);
+                maxX = std::min(maxX, _columns - 1);
+                maxY = std::min(maxY, _rows - 1);
+            }
+
+            for (int32_t cy = minY; cy <= maxY; ++cy)
+            {
+                for (int32_t cx = minX; cx <= maxX; ++cx)
+                {
+                    const uint32_t b = bucket(cx, cy);
+                    // The range has no fixed size, so rather than keep a visited list, a hashed
+                    // bucket is skipped when an earlier cell of the range maps to it as well.
+                    bool seen = false;
+                    for (int32_t py = minY; _hashed && !seen && (py < cy || (py == cy && minX < cx)); ++py)
+                    {
+                        const int32_t endX = py < cy ? maxX : cx - 1;
+                        for (int32_t px = minX; px <= endX && !seen; ++px)
+                            seen = bucket(px, py) == b;
+                    }
+                    if (seen)
+                        continue;
+
+                    const uint32_t end = _cellStart[b + 1];
+                    for (uint32_t k = _cellStart[b]; k < end; ++k, ++found)
+                    {
+                        if (pairs.size() < capacity)
+                            pairs.push_back(CandidatePair{ (uint32_t)q, _items[k] });
+                    }
+                }
+            }
+        }
+        return (found);
+    }
+
+    void benchmarkBroadphase(FILE* out)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr float kSize = 0.5f;   // kSpriteSize
+        constexpr int kRuns = 5;
+        const size_t counts[] = { 100, 1000, 10000, 100000 };
+
+        fprintf(out, "%10s %12s %12s %12s %12s %12s\n", "entities", "pairs", "hits", "grid ms", "hashed ms", "naive ms");
+        for (size_t count : counts)
+        {
+            // Constant density: about one object per four cells, like a dense wave.
+            const float side = sqrtf((float)count) * kSize * 2.f;
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> coordinate(-side * 0.5f, side * 0.5f);
+            const size_t queries = count / 2;
+            const size_t items = count - queries;
+            std::vector<float> qx(queries), qy(queries), ix(items), iy(items);
+            for (size_t i = 0; i < queries; ++i)
+            {
+                qx[i] = coordinate(rng);
+                qy[i] = coordinate(rng);
+            }
+            for (size_t i = 0; i < items; ++i)
+            {
+                ix[i] = coordinate(rng);
+                iy[i] = coordinate(rng);
+            }
+
+            auto overlaps = [&](const CandidatePair& p)
+            {
+                return (fabsf(qx[p.query] - ix[p.item]) < kSize && fabsf(qy[p.query] - iy[p.item]) < kSize);
+            };
+
+            UniformGrid grid;
+            UniformGrid hashed;
+            grid.configureBounded(-side * 0.5f, -side * 0.5f, side * 0.5f, side * 0.5f, kSize);
+            hashed.configureHashed(kSize, (uint32_t)items * 2);
+            std::vector<CandidatePair> pairs;
+            pairs.reserve(items * 16);
+
+            double gridMs = 1e30;
+            double hashedMs = 1e30;
+            size_t found = 0;
+            size_t hits = 0;
+            for (int run = 0; run < kRuns; ++run)
+            {
+                auto start = Clock::now();
+                grid.build(ix.data(), iy.data(), items);
+                found = grid.findPairs(qx.data(), qy.data(), queries, 1, pairs);
+                gridMs = std::min(gridMs, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+                start = Clock::now();
+                hashed.build(ix.data(), iy.data(), items);
+                hashed.findPairs(qx.data(), qy.data(), queries, 1, pairs);
+                hashedMs = std::min(hashedMs, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            }
+            grid.findPairs(qx.data(), qy.data(), queries, 1, pairs);
+            hits = (size_t)std::count_if(pairs.begin(), pairs.end(), overlaps);
+
+            // The quadratic reference gets slow past a few tens of thousands; skip it there.
+            if (count <= 20000)
+            {
+                const auto start = Clock::now();
+                size_t naiveHits = 0;
+                for (size_t q = 0; q < queries; ++q)
+                {
+                    for (size_t i = 0; i < items; ++i)
+                        naiveHits += overlaps(CandidatePair{ (uint32_t)q, (uint32_t)i });
+                }
+                const double naiveMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                fprintf(out, "%10zu %12zu %12zu %12.3f %12.3f %12.3f%s\n", count, found, hits, gridMs, hashedMs, naiveMs,
+                        naiveHits == hits ? "" : "  MISMATCH");
+            }
+            else
+                fprintf(out, "%10zu %12zu %12zu %12.3f %12.3f %12s\n", count, found, hits, gridMs, hashedMs, "-");
+        }
+    }
+}
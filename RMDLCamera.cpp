@@ -9,6 +9,7 @@
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "RMDLCamera.hpp"
+#include "RMDLMathUtils.hpp"
 
 static simd::float4x4 sInvMatrixLookat( simd::float3 inEye, simd::float3 inTo, simd::float3 inUp )
 {
@@ -75,33 +76,27 @@ bool RMDLCamera::isParallel() const
 
 void RMDLCamera::updateUniforms()
 {
+    // The view is rigid and both projections have closed-form inverses, so no generic 4x4 inversion is needed here.
+    simd::float4x4 orientation = sInvMatrixLookat(simd::float3{0, 0, 0}, _direction, _up);
+    simd::float4x4 invProjection;
     _uniforms.viewMatrix = sInvMatrixLookat(_position, _position + _direction, _up);
     if (_viewAngle != 0)
     {
-        float va_tan = 1.0f / tan(_viewAngle * 0.5f);
-        float ys = va_tan;
-        float xs = ys / _aspectRatio;
-        float zs = _farPlane / (_farPlane - _nearPlane);
-        _uniforms.projectionMatrix = simd::float4x4((simd::float4){ xs,  0,  0, 0},
-                                                    (simd::float4){  0, ys,  0, 0},
-                                                    (simd::float4){  0,  0, zs, 1},
-                                                    (simd::float4){  0,  0, -_nearPlane * zs , 0 } );
+        _uniforms.projectionMatrix = matrix_perspective_left_hand(_viewAngle, _aspectRatio, _nearPlane, _farPlane);
+        invProjection = matrix_inverse_perspective_left_hand(_viewAngle, _aspectRatio, _nearPlane, _farPlane);
     }
     else
     {
-        float ys = 2.0f / _width;
-        float xs = ys / _aspectRatio;
-        float zs = 1.0f / (_farPlane - _nearPlane);
-        _uniforms.projectionMatrix = simd::float4x4((simd::float4){ xs,  0,  0, 0},
-                                                    (simd::float4){  0, ys,  0, 0},
-                                                    (simd::float4){  0,  0, zs, 1},
-                                                    (simd::float4){  0,  0, -_nearPlane * zs , 1} );
+        float halfHeight = _width * 0.5f;
+        float halfWidth = halfHeight * _aspectRatio;
+        _uniforms.projectionMatrix = matrix_ortho_left_hand(-halfWidth, halfWidth, -halfHeight, halfHeight, _nearPlane, _farPlane);
+        invProjection = matrix_inverse_ortho_left_hand(-halfWidth, halfWidth, -halfHeight, halfHeight, _nearPlane, _farPlane);
     }
     _uniforms.viewProjectionMatrix = _uniforms.projectionMatrix * _uniforms.viewMatrix;
-    _uniforms.invProjectionMatrix = simd_inverse(_uniforms.projectionMatrix);
-    _uniforms.invOrientationProjectionMatrix = simd_inverse( _uniforms.projectionMatrix * sInvMatrixLookat( simd::float3{0, 0, 0}, _direction, _up ) );
-    _uniforms.invViewProjectionMatrix = simd_inverse(_uniforms.viewProjectionMatrix);
-    _uniforms.invViewMatrix = simd_inverse(_uniforms.viewMatrix);
+    _uniforms.invProjectionMatrix = invProjection;
+    _uniforms.invViewMatrix = matrix_inverse_rigid(_uniforms.viewMatrix);
+    _uniforms.invOrientationProjectionMatrix = matrix_inverse_rigid(orientation) * invProjection;
+    _uniforms.invViewProjectionMatrix = _uniforms.invViewMatrix * invProjection;
     simd::float4x4 transp_vpm = simd::transpose(_uniforms.viewProjectionMatrix);
     _uniforms.frustumPlanes[0] = sPlaneNormalize(transp_vpm.columns[3] + transp_vpm.columns[0]);
     _uniforms.frustumPlanes[1] = sPlaneNormalize(transp_vpm.columns[3] - transp_vpm.columns[0]);
@@ -0,0 +1,416 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLClusteredLights.cpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 18:10:21      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLClusteredLights.hpp"
+
+#include "RMDLCamera.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace
+{
+    simd_float8 sLoad(const float* p, size_t lanes)
+    {
+        simd_float8 v = {};
+        memcpy(&v, p, lanes * sizeof(float));
+        return (v);
+    }
+
+    // Slice containing view depth z, clamped to the grid.
+    int32_t sSliceOf(const lighting::ClusterGridParams& params, float z)
+    {
+        float slice;
+        if (params.logarithmic)
+            slice = logf(std::max(z, params.nearPlane)) * params.sliceScale + params.sliceBias;
+        else
+            slice = z * params.sliceScale + params.sliceBias;
+        return (std::clamp((int32_t)floorf(slice), 0, (int32_t)params.slices - 1));
+    }
+}
+
+namespace lighting
+{
+    void ClusteredLights::LightSoA::clear()
+    {
+        x.clear(); y.clear(); z.clear(); radius.clear();
+        dirX.clear(); dirY.clear(); dirZ.clear(); cosAngle.clear(); sinAngle.clear();
+        index.clear();
+    }
+
+    void ClusteredLights::LightSoA::append(const LightSoA& from, size_t i)
+    {
+        x.push_back(from.x[i]);
+        y.push_back(from.y[i]);
+        z.push_back(from.z[i]);
+        radius.push_back(from.radius[i]);
+        dirX.push_back(from.dirX[i]);
+        dirY.push_back(from.dirY[i]);
+        dirZ.push_back(from.dirZ[i]);
+        cosAngle.push_back(from.cosAngle[i]);
+        sinAngle.push_back(from.sinAngle[i]);
+        index.push_back(from.index[i]);
+    }
+
+    namespace
+    {
+        // Which of the eight lights at base can reach a box. Sphere against box for every light;
+        // spot lights are also tested as a cone against the box's bounding sphere. Point lights
+        // carry a zero direction and zero angle terms, which makes the cone test always pass.
+        template <typename Lights, typename Box>
+        simd_int8 sTouches(const Lights& lights, size_t base, size_t lanes, const Box& box)
+        {
+            const simd_int8 laneIndex = { 0, 1, 2, 3, 4, 5, 6, 7 };
+            const simd_float8 zero = {};
+            const simd_float8 x = sLoad(lights.x.data() + base, lanes);
+            const simd_float8 y = sLoad(lights.y.data() + base, lanes);
+            const simd_float8 z = sLoad(lights.z.data() + base, lanes);
+            const simd_float8 radius = sLoad(lights.radius.data() + base, lanes);
+
+            const simd_float8 dx = simd_max(box.min[0] - x, zero) + simd_max(x - box.max[0], zero);
+            const simd_float8 dy = simd_max(box.min[1] - y, zero) + simd_max(y - box.max[1], zero);
+            const simd_float8 dz = simd_max(box.min[2] - z, zero) + simd_max(z - box.max[2], zero);
+            simd_int8 touches = (dx * dx + dy * dy + dz * dz <= radius * radius) & (laneIndex < (int)lanes);
+            if (!simd_any(touches))
+                return (touches);
+
+            const float halfX = (box.max[0] - box.min[0]) * 0.5f;
+            const float halfY = (box.max[1] - box.min[1]) * 0.5f;
+            const float halfZ = (box.max[2] - box.min[2]) * 0.5f;
+            const float sphereRadius = sqrtf(halfX * halfX + halfY * halfY + halfZ * halfZ);
+            const simd_float8 vx = (box.min[0] + halfX) - x;
+            const simd_float8 vy = (box.min[1] + halfY) - y;
+            const simd_float8 vz = (box.min[2] + halfZ) - z;
+            const simd_float8 cosAngle = sLoad(lights.cosAngle.data() + base, lanes);
+            const simd_float8 sinAngle = sLoad(lights.sinAngle.data() + base, lanes);
+            const simd_float8 along = vx * sLoad(lights.dirX.data() + base, lanes)
+                                    + vy * sLoad(lights.dirY.data() + base, lanes)
+                                    + vz * sLoad(lights.dirZ.data() + base, lanes);
+            const simd_float8 acrossSq = simd_max(vx * vx + vy * vy + vz * vz - along * along, zero);
+
+            // The sphere is outside the cone when cos * |across| - along * sin > sphereRadius;
+            // squared to avoid the root, with the sign of the right-hand side handled first.
+            const simd_float8 limit = sphereRadius + along * sinAngle;
+            const simd_int8 beside = (limit < 0.f) | (cosAngle * cosAngle * acrossSq > limit * limit);
+            const simd_int8 beyond = along > sphereRadius + radius;
+            const simd_int8 behind = along < -sphereRadius;
+            return (touches & ~(beside | beyond | behind));
+        }
+    }
+
+    ClusteredLights::ClusteredLights(const ClusterSettings& settings)
+    : _settings(settings)
+    , _params()
+    , _gridKey{}
+    , _stats()
+    {
+        _settings.tilesX = std::max(1u, _settings.tilesX);
+        _settings.tilesY = std::max(1u, _settings.tilesY);
+        _settings.slices = std::max(1u, _settings.slices);
+        _sliceWork.resize(_settings.slices);
+        _clusters.resize(clusterCount());
+    }
+
+    void ClusteredLights::updateGrid(RMDLCamera& camera)
+    {
+        const float key[6] = { camera.isPerspective() ? 1.f : 0.f, camera.viewAngle(), camera.aspectRatio(),
+                               camera.width(), camera.nearPlane(), camera.farPlane() };
+        if (!_clusterBoxes.empty() && memcmp(key, _gridKey, sizeof(key)) == 0)
+            return ;
+        memcpy(_gridKey, key, sizeof(key));
+
+        const uint32_t tilesX = _settings.tilesX;
+        const uint32_t tilesY = _settings.tilesY;
+        const uint32_t slices = _settings.slices;
+        const bool perspective = camera.isPerspective();
+        const float nearZ = camera.nearPlane();
+        const float farZ = camera.farPlane();
+
+        _params.tilesX = tilesX;
+        _params.tilesY = tilesY;
+        _params.slices = slices;
+        _params.logarithmic = perspective ? 1 : 0;
+        _params.nearPlane = nearZ;
+        _params.farPlane = farZ;
+        _sliceDepths.resize(slices + 1);
+        if (perspective)
+        {
+            const float logRange = logf(farZ / nearZ);
+            _params.sliceScale = slices / logRange;
+            _params.sliceBias = -(slices * logf(nearZ)) / logRange;
+            for (uint32_t k = 0; k <= slices; ++k)
+                _sliceDepths[k] = nearZ * powf(farZ / nearZ, (float)k / slices);
+        }
+        else
+        {
+            _params.sliceScale = slices / (farZ - nearZ);
+            _params.sliceBias = -nearZ * _params.sliceScale;
+            for (uint32_t k = 0; k <= slices; ++k)
+                _sliceDepths[k] = nearZ + (farZ - nearZ) * k / slices;
+        }
+
+        // Half extents at view depth 1 (perspective) or absolute (parallel).
+        const float halfHeight = perspective ? tanf(camera.viewAngle() * 0.5f) : camera.width() * 0.5f;
+        const float halfWidth = halfHeight * camera.aspectRatio();
+        auto extent = [&](float ndc, float half, float z0, float z1, float& lo, float& hi)
+        {
+            const float a = ndc * half * (perspective ? z0 : 1.f);
+            const float b = ndc * half * (perspective ? z1 : 1.f);
+            lo = std::min(lo, std::min(a, b));
+            hi = std::max(hi, std::max(a, b));
+        };
+
+        _clusterBoxes.resize(clusterCount());
+        _rowBoxes.resize(slices * tilesY);
+        for (uint32_t k = 0; k < slices; ++k)
+        {
+            const float z0 = _sliceDepths[k];
+            const float z1 = _sliceDepths[k + 1];
+            for (uint32_t ty = 0; ty < tilesY; ++ty)
+            {
+                const float y0 = -1.f + 2.f * ty / tilesY;
+                const float y1 = -1.f + 2.f * (ty + 1) / tilesY;
+                Box& row = _rowBoxes[k * tilesY + ty];
+                row = Box{ { INFINITY, INFINITY, z0 }, { -INFINITY, -INFINITY, z1 } };
+                extent(-1.f, halfWidth, z0, z1, row.min[0], row.max[0]);
+                extent(1.f, halfWidth, z0, z1, row.min[0], row.max[0]);
+                extent(y0, halfHeight, z0, z1, row.min[1], row.max[1]);
+                extent(y1, halfHeight, z0, z1, row.min[1], row.max[1]);
+                for (uint32_t tx = 0; tx < tilesX; ++tx)
+                {
+                    const float x0 = -1.f + 2.f * tx / tilesX;
+                    const float x1 = -1.f + 2.f * (tx + 1) / tilesX;
+                    Box& box = _clusterBoxes[(k * tilesY + ty) * tilesX + tx];
+                    box = Box{ { INFINITY, row.min[1], z0 }, { -INFINITY, row.max[1], z1 } };
+                    extent(x0, halfWidth, z0, z1, box.min[0], box.max[0]);
+                    extent(x1, halfWidth, z0, z1, box.min[0], box.max[0]);
+                }
+            }
+        }
+    }
+
+    void ClusteredLights::assign(RMDLCamera& camera, const Light* pLights, size_t lightCount)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        updateGrid(camera);
+
+        const simd::float4x4 view = camera.ViewMatrix();
+        _viewLights.clear();
+        _sliceFirst.clear();
+        _sliceLast.clear();
+        for (size_t i = 0; i < lightCount; ++i)
+        {
+            const Light& light = pLights[i];
+            const simd::float4 p = simd_mul(view, simd::float4{ light.position.x, light.position.y, light.position.z, 1.f });
+            if (p.z + light.radius < _params.nearPlane || p.z - light.radius > _params.farPlane)
+                continue;
+
+            _viewLights.x.push_back(p.x);
+            _viewLights.y.push_back(p.y);
+            _viewLights.z.push_back(p.z);
+            _viewLights.radius.push_back(light.radius);
+            if (light.type == LightType::Spot)
+            {
+                const simd::float4 d = simd_mul(view, simd::float4{ light.direction.x, light.direction.y, light.direction.z, 0.f });
+                const float angle = std::clamp(light.spotAngle, 0.f, (float)M_PI_2);
+                _viewLights.dirX.push_back(d.x);
+                _viewLights.dirY.push_back(d.y);
+                _viewLights.dirZ.push_back(d.z);
+                _viewLights.cosAngle.push_back(cosf(angle));
+                _viewLights.sinAngle.push_back(sinf(angle));
+            }
+            else
+            {
+                _viewLights.dirX.push_back(0.f);
+                _viewLights.dirY.push_back(0.f);
+                _viewLights.dirZ.push_back(0.f);
+                _viewLights.cosAngle.push_back(0.f);
+                _viewLights.sinAngle.push_back(0.f);
+            }
+            _viewLights.index.push_back((uint32_t)i);
+            _sliceFirst.push_back((uint32_t)sSliceOf(_params, p.z - light.radius));
+            _sliceLast.push_back((uint32_t)sSliceOf(_params, p.z + light.radius));
+        }
+
+        parallel::parallelFor(_settings.slices, [this](size_t slice)
+        {
+            assignSlice((uint32_t)slice);
+        }, _settings.threadCount);
+
+        // Slices wrote offsets relative to their own index list; lay the lists end to end.
+        const uint32_t clustersPerSlice = _settings.tilesX * _settings.tilesY;
+        size_t total = 0;
+        for (const SliceWork& work : _sliceWork)
+            total += work.indices.size();
+        _lightIndices.resize(total);
+        uint32_t offset = 0;
+        uint32_t maxPerCluster = 0;
+        for (uint32_t k = 0; k < _settings.slices; ++k)
+        {
+            const std::vector<uint32_t>& indices = _sliceWork[k].indices;
+            if (!indices.empty())
+                memcpy(_lightIndices.data() + offset, indices.data(), indices.size() * sizeof(uint32_t));
+            for (uint32_t c = k * clustersPerSlice; c < (k + 1) * clustersPerSlice; ++c)
+            {
+                _clusters[c].offset += offset;
+                maxPerCluster = std::max(maxPerCluster, _clusters[c].count);
+            }
+            offset += (uint32_t)indices.size();
+        }
+
+        _stats.lights = lightCount;
+        _stats.visibleLights = _viewLights.size();
+        _stats.indices = total;
+        _stats.maxPerCluster = maxPerCluster;
+        _stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void ClusteredLights::assignSlice(uint32_t slice)
+    {
+        SliceWork& work = _sliceWork[slice];
+        work.candidates.clear();
+        work.indices.clear();
+        for (size_t i = 0; i < _viewLights.size(); ++i)
+        {
+            if (_sliceFirst[i] <= slice && slice <= _sliceLast[i])
+                work.candidates.append(_viewLights, i);
+        }
+
+        const uint32_t tilesX = _settings.tilesX;
+        const uint32_t tilesY = _settings.tilesY;
+        for (uint32_t ty = 0; ty < tilesY; ++ty)
+        {
+            ClusterRange* pRow = _clusters.data() + (slice * tilesY + ty) * tilesX;
+            work.row.clear();
+            for (size_t base = 0; base < work.candidates.size(); base += 8)
+            {
+                const size_t lanes = std::min<size_t>(8, work.candidates.size() - base);
+                const simd_int8 touches = sTouches(work.candidates, base, lanes, _rowBoxes[slice * tilesY + ty]);
+                if (!simd_any(touches))
+                    continue;
+                for (size_t lane = 0; lane < lanes; ++lane)
+                {
+                    if (touches[lane])
+                        work.row.append(work.candidates, base + lane);
+                }
+            }
+
+            for (uint32_t tx = 0; tx < tilesX; ++tx)
+            {
+                const Box& box = _clusterBoxes[(slice * tilesY + ty) * tilesX + tx];
+                pRow[tx].offset = (uint32_t)work.indices.size();
+                for (size_t base = 0; base < work.row.size(); base += 8)
+                {
+                    const size_t lanes = std::min<size_t>(8, work.row.size() - base);
+                    const simd_int8 touches = sTouches(work.row, base, lanes, box);
+                    if (!simd_any(touches))
+                        continue;
+                    for (size_t lane = 0; lane < lanes; ++lane)
+                    {
+                        if (touches[lane])
+                            work.indices.push_back(work.row.index[base + lane]);
+                    }
+                }
+                pRow[tx].count = (uint32_t)work.indices.size() - pRow[tx].offset;
+            }
+        }
+    }
+
+    uint32_t ClusteredLights::clusterAt(float ndcX, float ndcY, float viewZ) const
+    {
+        if (_clusterBoxes.empty() || ndcX < -1.f || ndcX > 1.f || ndcY < -1.f || ndcY > 1.f
+            || viewZ < _params.nearPlane || viewZ > _params.farPlane)
+            return (UINT32_MAX);
+        const uint32_t tx = std::min(_params.tilesX - 1, (uint32_t)((ndcX * 0.5f + 0.5f) * _params.tilesX));
+        const uint32_t ty = std::min(_params.tilesY - 1, (uint32_t)((ndcY * 0.5f + 0.5f) * _params.tilesY));
+        const uint32_t slice = (uint32_t)sSliceOf(_params, viewZ);
+        return ((slice * _params.tilesY + ty) * _params.tilesX + tx);
+    }
+
+    void benchmarkClusteredLights(FILE* out)
+    {
+        constexpr int kRuns = 5;
+        constexpr float kNear = 0.1f;
+        constexpr float kFar = 100.f;
+        constexpr float kViewAngle = (float)M_PI / 3.f;
+        constexpr float kAspect = 16.f / 9.f;
+        const size_t counts[] = { 64, 256, 1024, 4096, 16384 };
+
+        RMDLCamera camera;
+        camera.initPerspectiveWithPosition(simd::float3{ 0.f, 0.f, 0.f }, simd::float3{ 0.f, 0.f, 1.f },
+                                           simd::float3{ 0.f, 1.f, 0.f }, kViewAngle, kAspect, kNear, kFar);
+        const simd::float4x4 view = camera.ViewMatrix();
+        const float halfHeight = tanf(kViewAngle * 0.5f);
+        const float halfWidth = halfHeight * kAspect;
+
+        ClusterSettings single;
+        single.threadCount = 1;
+        ClusteredLights serial(single);
+        ClusteredLights threaded;
+
+        fprintf(out, "%10s %10s %10s %12s %10s %10s %10s\n",
+                "lights", "visible", "indices", "max/cluster", "1 thread", "all ms", "missing");
+        for (size_t count : counts)
+        {
+            // Spread through the view volume, one spot light in four, sizes like the game's lamps.
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> unit(-1.f, 1.f);
+            std::uniform_real_distribution<float> depth(kNear, kFar);
+            std::uniform_real_distribution<float> radius(1.f, 8.f);
+            std::vector<Light> lights(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Light& light = lights[i];
+                const float z = depth(rng);
+                light.position = simd::float3{ unit(rng) * halfWidth * z, unit(rng) * halfHeight * z, z };
+                light.radius = radius(rng);
+                light.direction = simd::normalize(simd::float3{ unit(rng), unit(rng), unit(rng) });
+                light.spotAngle = (unit(rng) * 0.5f + 0.5f) * (float)M_PI_4 + 0.1f;
+                light.type = i % 4 == 3 ? LightType::Spot : LightType::Point;
+            }
+
+            double serialMs = 1e30;
+            double threadedMs = 1e30;
+            for (int run = 0; run < kRuns; ++run)
+            {
+                serial.assign(camera, lights.data(), count);
+                serialMs = std::min(serialMs, serial.stats().milliseconds);
+                threaded.assign(camera, lights.data(), count);
+                threadedMs = std::min(threadedMs, threaded.stats().milliseconds);
+            }
+
+            // Every light must be listed in the cluster holding its own center.
+            size_t missing = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const simd::float3 position = lights[i].position;
+                const simd::float4 p = simd_mul(view, simd::float4{ position.x, position.y, position.z, 1.f });
+                const uint32_t cluster = threaded.clusterAt(p.x / (p.z * halfWidth), p.y / (p.z * halfHeight), p.z);
+                if (cluster == UINT32_MAX)
+                    continue;
+                const ClusterRange range = threaded.clusters()[cluster];
+                const uint32_t* pFirst = threaded.lightIndices().data() + range.offset;
+                if (std::find(pFirst, pFirst + range.count, (uint32_t)i) == pFirst + range.count)
+                    ++missing;
+            }
+            const bool same = serial.lightIndices() == threaded.lightIndices()
+                && memcmp(serial.clusters().data(), threaded.clusters().data(), serial.clusters().size() * sizeof(ClusterRange)) == 0;
+
+            const ClusterStats& stats = threaded.stats();
+            fprintf(out, "%10zu %10llu %10llu %12u %10.3f %10.3f %10zu%s\n",
+                    count, (unsigned long long)stats.visibleLights, (unsigned long long)stats.indices, stats.maxPerCluster,
+                    serialMs, threadedMs, missing, same && missing == 0 ? "" : "  MISMATCH");
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLClusteredLights.hpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 18:10:14      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLCLUSTEREDLIGHTS_HPP
+# define RMDLCLUSTEREDLIGHTS_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstddef>
+# include <cstdint>
+# include <cstdio>
+# include <vector>
+
+class RMDLCamera;
+
+namespace lighting
+{
+    enum class LightType : uint8_t
+    {
+        Point,
+        Spot
+    };
+
+    /// World space, as uploaded at BufferIndexLightsData / BufferIndexLightsPosition.
+    struct Light
+    {
+        simd::float3    position;
+        float           radius;         // influence range
+        simd::float3    direction;      // spot lights only, normalized
+        float           spotAngle;      // half angle of the cone in radians, at most pi / 2
+        LightType       type;
+    };
+
+    struct ClusterSettings
+    {
+        uint32_t    tilesX = 16;
+        uint32_t    tilesY = 9;
+        uint32_t    slices = 24;
+        unsigned    threadCount = 0;
+    };
+
+    /// Where a cluster's lights start in lightIndices(), and how many there are.
+    struct ClusterRange
+    {
+        uint32_t    offset;
+        uint32_t    count;
+    };
+
+    /// What a shader needs to find the cluster of a fragment:
+    ///   tile  = floor((ndc.xy * 0.5 + 0.5) * (tilesX, tilesY))
+    ///   slice = floor(log(viewZ) * sliceScale + sliceBias)     when logarithmic
+    ///           floor(viewZ * sliceScale + sliceBias)          otherwise (parallel cameras)
+    ///   index = (slice * tilesY + tileY) * tilesX + tileX
+    struct ClusterGridParams
+    {
+        uint32_t    tilesX;
+        uint32_t    tilesY;
+        uint32_t    slices;
+        uint32_t    logarithmic;
+        float       sliceScale;
+        float       sliceBias;
+        float       nearPlane;
+        float       farPlane;
+    };
+
+    struct ClusterStats
+    {
+        uint64_t    lights;
+        uint64_t    visibleLights;  // touching at least one slice
+        uint64_t    indices;
+        uint32_t    maxPerCluster;
+        double      milliseconds;
+    };
+
+    /// Clustered (froxel) light assignment on the CPU.
+    ///
+    /// The view volume of the camera is cut into tilesX x tilesY screen tiles and `slices` depth
+    /// slices, exponential in view depth for perspective cameras and uniform for parallel ones;
+    /// each cluster is bounded by a view-space box. Lights are moved to view space once, bucketed
+    /// by the slices their sphere spans, and the slices are processed in parallel: per slice each
+    /// row of tiles is tested first, then each cluster of the row, eight lights at a time. Point
+    /// lights are tested sphere against box; spot lights are additionally tested cone against the
+    /// cluster's bounding sphere, which rejects clusters beside or behind the cone.
+    ///
+    /// The result is one ClusterRange per cluster and one shared index list, in cluster order,
+    /// ready to be copied to GPU buffers as is.
+    class ClusteredLights
+    {
+    public:
+        explicit ClusteredLights(const ClusterSettings& settings = ClusterSettings());
+
+        void    assign(RMDLCamera& camera, const Light* pLights, size_t lightCount);
+
+        const std::vector<ClusterRange>&    clusters() const { return (_clusters); }
+        const std::vector<uint32_t>&        lightIndices() const { return (_lightIndices); }
+        const ClusterGridParams&            params() const { return (_params); }
+        const ClusterStats&                 stats() const { return (_stats); }
+
+        uint32_t    clusterCount() const { return (_settings.tilesX * _settings.tilesY * _settings.slices); }
+        /// Cluster of a point given by its normalized device x, y and its view depth; UINT32_MAX
+        /// when outside the grid.
+        uint32_t    clusterAt(float ndcX, float ndcY, float viewZ) const;
+
+    private:
+        // View-space lights, structure of arrays so eight can be tested at once.
+        struct LightSoA
+        {
+            std::vector<float>      x, y, z, radius;
+            std::vector<float>      dirX, dirY, dirZ, cosAngle, sinAngle;
+            std::vector<uint32_t>   index;
+
+            void    clear();
+            void    append(const LightSoA& from, size_t i);
+            size_t  size() const { return (index.size()); }
+        };
+
+        struct Box
+        {
+            float   min[3];
+            float   max[3];
+        };
+
+        struct SliceWork
+        {
+            LightSoA                candidates;
+            LightSoA                row;
+            std::vector<uint32_t>   indices;
+        };
+
+        void    updateGrid(RMDLCamera& camera);
+        void    assignSlice(uint32_t slice);
+
+        ClusterSettings             _settings;
+        ClusterGridParams           _params;
+        float                       _gridKey[6];
+        std::vector<Box>            _clusterBoxes;
+        std::vector<Box>            _rowBoxes;
+        std::vector<float>          _sliceDepths;
+        LightSoA                    _viewLights;
+        std::vector<uint32_t>       _sliceFirst;    // per view light, slice range
+        std::vector<uint32_t>       _sliceLast;
+        std::vector<SliceWork>      _sliceWork;
+        std::vector<ClusterRange>   _clusters;
+        std::vector<uint32_t>       _lightIndices;
+        ClusterStats                _stats;
+    };
+
+    /// Assigns 64 to 16k point and spot lights, spread through a 60 degree, 100 unit deep view,
+    /// to the default 16x9x24 grid on one thread and on every worker, and prints the best times
+    /// to out. Each light is checked against the cluster that holds its center.
+    void    benchmarkClusteredLights(FILE* out);
+}
+
+#endif /* RMDLCLUSTEREDLIGHTS_HPP */
@@ -0,0 +1,422 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLDeterministicSim.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 14:40:19      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLDeterministicSim.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace
+{
+    using sim::Scalar;
+
+    Scalar sMin(Scalar a, Scalar b)
+    {
+        return (a < b ? a : b);
+    }
+
+    Scalar sMax(Scalar a, Scalar b)
+    {
+        return (a > b ? a : b);
+    }
+
+    Scalar sCountdown(Scalar remaining, Scalar dt)
+    {
+        return (sMax(remaining - dt, Scalar()));
+    }
+
+    // Cell of a coordinate in sprite-sized cells from origin, on the raw fixed-point values.
+    int32_t sCell(int64_t raw, Scalar origin, Scalar cellSize)
+    {
+        const int64_t offset = raw - origin.raw();
+        const int64_t size = cellSize.raw();
+        // Everything on the canvas is a small positive offset; a 32-bit divide is much cheaper.
+        if (offset >= 0 && offset <= UINT32_MAX)
+            return ((int32_t)((uint32_t)offset / (uint32_t)size));
+        const int64_t cell = offset >= 0 ? offset / size : -((-offset + size - 1) / size);
+        return ((int32_t)std::clamp<int64_t>(cell, INT32_MIN, INT32_MAX));
+    }
+
+    struct Fnv1a
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        void add(uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        }
+
+        void add(Scalar value)
+        {
+            add((uint64_t)(uint32_t)value.raw());
+        }
+
+        void add(sim::Vec2 value)
+        {
+            add(value.x);
+            add(value.y);
+        }
+    };
+}
+
+namespace sim
+{
+    Config makeConfig(float canvasWidth, float canvasHeight, float spriteSize,
+                      float playerSpeed, float playerBulletSpeed, float playerFireCooldownSecs,
+                      float enemySpeed, float enemyMoveDownStep, float explosionDurationSecs, float rumbleDurationSecs,
+                      uint8_t enemyRows, uint8_t enemyCols, uint8_t maxPlayerBullets, uint8_t maxExplosions,
+                      uint32_t tickRate)
+    {
+        Config config;
+        config.tickRate = std::max(tickRate, 1u);
+        config.tickSeconds = Scalar(1) / Scalar((int)config.tickRate);
+        config.canvasHalfWidth = Scalar::fromFloat(canvasWidth * 0.5f);
+        config.canvasHalfHeight = Scalar::fromFloat(canvasHeight * 0.5f);
+        config.spriteSize = Scalar::fromFloat(spriteSize);
+        config.playerSpeed = Scalar::fromFloat(playerSpeed);
+        config.playerBulletSpeed = Scalar::fromFloat(playerBulletSpeed);
+        config.playerFireCooldown = Scalar::fromFloat(playerFireCooldownSecs);
+        config.enemySpeed = Scalar::fromFloat(enemySpeed);
+        config.enemyMoveDownStep = Scalar::fromFloat(enemyMoveDownStep);
+        config.explosionDuration = Scalar::fromFloat(explosionDurationSecs);
+        config.rumbleDuration = Scalar::fromFloat(rumbleDurationSecs);
+        config.enemyRows = enemyRows;
+        config.enemyCols = enemyCols;
+        config.maxPlayerBullets = maxPlayerBullets;
+        config.maxExplosions = maxExplosions;
+        return (config);
+    }
+
+    void reset(State& state, const Config& config, int32_t startingScore)
+    {
+        const Scalar spacing = config.spriteSize + config.spriteSize / Scalar(2);
+
+        state.tick = 0;
+        state.playerPosition = { Scalar(), -config.canvasHalfHeight + config.spriteSize * Scalar(2) };
+        state.playerFireCooldownRemaining = Scalar();
+        state.playerBulletPositions.clear();
+        state.playerBulletPositions.reserve(config.maxPlayerBullets);
+        state.playerBulletIds.clear();
+        state.playerBulletIds.reserve(config.maxPlayerBullets);
+        state.nextBulletId = 0;
+        state.enemyPositions.clear();
+        for (uint8_t row = 0; row < config.enemyRows; ++row)
+        {
+            for (uint8_t col = 0; col < config.enemyCols; ++col)
+            {
+                const Scalar x = (Scalar((int)col) - Scalar((int)config.enemyCols - 1) / Scalar(2)) * spacing;
+                const Scalar y = config.canvasHalfHeight - config.spriteSize * Scalar(2) - Scalar((int)row) * spacing;
+                state.enemyPositions.push_back({ x, y });
+            }
+        }
+        state.enemyAlive.assign(state.enemyPositions.size(), 1);
+        state.enemiesAlive = (uint32_t)state.enemyPositions.size();
+        state.enemyVelocityX = config.enemySpeed;
+        state.enemyDirection = EnemyDirection::Right;
+        state.enemyMovedownRemaining = Scalar();
+        state.explosionPositions.clear();
+        // A tick appends its explosions before evicting the oldest, one per bullet at most.
+        const size_t explosionCapacity = (size_t)config.maxExplosions + config.maxPlayerBullets;
+        state.explosionPositions.reserve(explosionCapacity);
+        state.explosionCooldownsRemaining.clear();
+        state.explosionCooldownsRemaining.reserve(explosionCapacity);
+        state.explosionIds.clear();
+        state.explosionIds.reserve(explosionCapacity);
+        state.nextExplosionId = 0;
+        state.backgroundPosition = { Scalar(), Scalar() };
+        state.rumbleCountdownRemaining = Scalar();
+        state.gameStatus = state.enemiesAlive ? GameStatus::Ongoing : GameStatus::PlayerWon;
+        state.playerScore = startingScore;
+    }
+
+    void step(State& state, const Config& config, const TickInput& input)
+    {
+        StepScratch scratch;
+        step(state, config, input, scratch);
+    }
+
+    void step(State& state, const Config& config, const TickInput& input, StepScratch& scratch)
+    {
+        const Scalar dt = config.tickSeconds;
+        const Scalar halfSprite = config.spriteSize / Scalar(2);
+        ++state.tick;
+
+        // Timers run even after the game ends so explosions and rumble finish playing.
+        size_t keptExplosions = 0;
+        for (size_t i = 0; i < state.explosionCooldownsRemaining.size(); ++i)
+        {
+            const Scalar remaining = sCountdown(state.explosionCooldownsRemaining[i], dt);
+            if (remaining == Scalar())
+                continue;
+            state.explosionPositions[keptExplosions] = state.explosionPositions[i];
+            state.explosionCooldownsRemaining[keptExplosions] = remaining;
+            state.explosionIds[keptExplosions] = state.explosionIds[i];
+            ++keptExplosions;
+        }
+        state.explosionPositions.resize(keptExplosions);
+        state.explosionCooldownsRemaining.resize(keptExplosions);
+        state.explosionIds.resize(keptExplosions);
+        state.rumbleCountdownRemaining = sCountdown(state.rumbleCountdownRemaining, dt);
+        if (state.gameStatus != GameStatus::Ongoing)
+            return;
+
+        // Player.
+        const Scalar moveX = sMax(Scalar(-1), sMin(Scalar(1), input.moveX));
+        const Scalar playerLimit = config.canvasHalfWidth - halfSprite;
+        state.playerPosition.x = sMax(-playerLimit, sMin(playerLimit, state.playerPosition.x + moveX * config.playerSpeed * dt));
+        state.playerFireCooldownRemaining = sCountdown(state.playerFireCooldownRemaining, dt);
+        if (input.fire && state.playerFireCooldownRemaining == Scalar() && state.playerBulletPositions.size() < config.maxPlayerBullets)
+        {
+            state.playerBulletPositions.push_back({ state.playerPosition.x, state.playerPosition.y + config.spriteSize });
+            state.playerBulletIds.push_back(state.nextBulletId++);
+            state.playerFireCooldownRemaining = config.playerFireCooldown;
+        }
+
+        // Bullets, removed once they leave the top of the canvas.
+        const Scalar bulletStep = config.playerBulletSpeed * dt;
+        const Scalar top = config.canvasHalfHeight + halfSprite;
+        size_t kept = 0;
+        for (size_t b = 0; b < state.playerBulletPositions.size(); ++b)
+        {
+            Vec2 bullet = state.playerBulletPositions[b];
+            bullet.y += bulletStep;
+            if (bullet.y > top)
+                continue;
+            state.playerBulletPositions[kept] = bullet;
+            state.playerBulletIds[kept] = state.playerBulletIds[b];
+            ++kept;
+        }
+        state.playerBulletPositions.resize(kept);
+        state.playerBulletIds.resize(kept);
+
+        // Enemies sweep sideways, step down at the canvas edge, then sweep back.
+        if (state.enemyMovedownRemaining > Scalar())
+        {
+            const Scalar dy = sMin(state.enemyMovedownRemaining, config.enemySpeed * dt);
+            for (Vec2& enemy : state.enemyPositions)
+                enemy.y -= dy;
+            state.enemyMovedownRemaining -= dy;
+            if (state.enemyMovedownRemaining == Scalar())
+                state.enemyDirection = state.enemyVelocityX > Scalar() ? EnemyDirection::Right : EnemyDirection::Left;
+        }
+        else
+        {
+            const Scalar dx = state.enemyVelocityX * dt;
+            const Scalar limit = config.canvasHalfWidth - halfSprite;
+            bool hitEdge = false;
+            for (size_t i = 0; i < state.enemyPositions.size(); ++i)
+            {
+                state.enemyPositions[i].x += dx;
+                if (state.enemyAlive[i])
+                    hitEdge |= state.enemyPositions[i].x.abs() >= limit;
+            }
+            if (hitEdge)
+            {
+                state.enemyVelocityX = -state.enemyVelocityX;
+                state.enemyMovedownRemaining = config.enemyMoveDownStep;
+                state.enemyDirection = EnemyDirection::Down;
+            }
+        }
+
+        // Bullet / enemy hits, in bullet order. A bullet is tested over the whole step it just
+        // moved, so it cannot skip past an enemy at low tick rates, and it stops at the first
+        // enemy on that path: the lowest one, then the lowest index. Enemies are binned into
+        // cells two sprites wide, computed on the fixed-point values so the candidates are the same
+        // on every machine; a bullet reads the cells its hit range covers, which hold every enemy
+        // less than a sprite away from its path.
+        const size_t enemyCount = state.enemyPositions.size();
+        const bool canHit = config.spriteSize > Scalar() && state.enemiesAlive && !state.playerBulletPositions.empty();
+        const Scalar cellSize = config.spriteSize * Scalar(2);
+        const Scalar originX = -config.canvasHalfWidth - config.spriteSize;
+        const Scalar originY = -config.canvasHalfHeight - config.spriteSize;
+        const int32_t columns = canHit ? sCell(config.canvasHalfWidth.raw() + config.spriteSize.raw(), originX, cellSize) + 1 : 1;
+        const int32_t rows = canHit ? sCell(config.canvasHalfHeight.raw() + config.spriteSize.raw(), originY, cellSize) + 1 : 1;
+        if (canHit)
+        {
+            scratch.enemyCellX.resize(enemyCount);
+            scratch.enemyCellY.resize(enemyCount);
+            for (size_t e = 0; e < enemyCount; ++e)
+            {
+                scratch.enemyCellX[e] = sCell(state.enemyPositions[e].x.raw(), originX, cellSize);
+                scratch.enemyCellY[e] = sCell(state.enemyPositions[e].y.raw(), originY, cellSize);
+            }
+            scratch.enemyGrid.configureCells(columns, rows);
+            scratch.enemyGrid.buildCells(scratch.enemyCellX.data(), scratch.enemyCellY.data(), enemyCount);
+        }
+
+        // Hit bullets are dropped and new explosions appended in one pass; the oldest explosions
+        // past maxExplosions are evicted once afterwards.
+        kept = 0;
+        for (size_t b = 0; b < state.playerBulletPositions.size(); ++b)
+        {
+            const Vec2 bullet = state.playerBulletPositions[b];
+            size_t target = enemyCount;
+            if (canHit)
+            {
+                // Enemies outside the grid sit in its border cells, so the range is clamped the same way.
+                const int64_t size = config.spriteSize.raw();
+                const Scalar pathBottom = bullet.y - bulletStep;
+                const int32_t minX = std::clamp(sCell((int64_t)bullet.x.raw() - size, originX, cellSize), 0, columns - 1);
+                const int32_t maxX = std::clamp(sCell((int64_t)bullet.x.raw() + size, originX, cellSize), 0, columns - 1);
+                const int32_t minY = std::clamp(sCell((int64_t)pathBottom.raw() - size, originY, cellSize), 0, rows - 1);
+                const int32_t maxY = std::clamp(sCell((int64_t)bullet.y.raw() + size, originY, cellSize), 0, rows - 1);
+                for (int32_t cy = minY; cy <= maxY; ++cy)
+                {
+                    for (int32_t cx = minX; cx <= maxX; ++cx)
+                    {
+                        for (uint32_t e : scratch.enemyGrid.cellItems(cx, cy))
+                        {
+                            const Vec2 enemy = state.enemyPositions[e];
+                            if (!state.enemyAlive[e] || (bullet.x - enemy.x).abs() >= config.spriteSize
+                                || enemy.y - bullet.y >= config.spriteSize || pathBottom - enemy.y >= config.spriteSize)
+                                continue;
+                            if (target == enemyCount || enemy.y < state.enemyPositions[target].y
+                                || (enemy.y == state.enemyPositions[target].y && e < target))
+                                target = e;
+                        }
+                    }
+                }
+            }
+            if (target == enemyCount)
+            {
+                state.playerBulletPositions[kept] = bullet;
+                state.playerBulletIds[kept] = state.playerBulletIds[b];
+                ++kept;
+                continue;
+            }
+            state.enemyAlive[target] = 0;
+            --state.enemiesAlive;
+            state.playerScore += kPointsPerEnemy;
+            state.rumbleCountdownRemaining = config.rumbleDuration;
+            if (config.maxExplosions)
+            {
+                state.explosionPositions.push_back(state.enemyPositions[target]);
+                state.explosionCooldownsRemaining.push_back(config.explosionDuration);
+                state.explosionIds.push_back(state.nextExplosionId++);
+            }
+        }
+        state.playerBulletPositions.resize(kept);
+        state.playerBulletIds.resize(kept);
+        if (state.explosionPositions.size() > config.maxExplosions)
+        {
+            const size_t evicted = state.explosionPositions.size() - config.maxExplosions;
+            state.explosionPositions.erase(state.explosionPositions.begin(), state.explosionPositions.begin() + evicted);
+            state.explosionCooldownsRemaining.erase(state.explosionCooldownsRemaining.begin(), state.explosionCooldownsRemaining.begin() + evicted);
+            state.explosionIds.erase(state.explosionIds.begin(), state.explosionIds.begin() + evicted);
+        }
+
+        if (state.enemiesAlive == 0)
+            state.gameStatus = GameStatus::PlayerWon;
+        else
+        {
+            for (size_t e = 0; e < state.enemyPositions.size(); ++e)
+            {
+                if (state.enemyAlive[e] && state.enemyPositions[e].y <= state.playerPosition.y + config.spriteSize)
+                    state.gameStatus = GameStatus::PlayerLost;
+            }
+        }
+    }
+
+    uint64_t checksum(const State& state)
+    {
+        Fnv1a h;
+        h.add(state.tick);
+        h.add(state.playerPosition);
+        h.add(state.playerFireCooldownRemaining);
+        h.add((uint64_t)state.playerBulletPositions.size());
+        for (size_t i = 0; i < state.playerBulletPositions.size(); ++i)
+        {
+            h.add(state.playerBulletPositions[i]);
+            h.add((uint64_t)state.playerBulletIds[i]);
+        }
+        h.add((uint64_t)state.nextBulletId);
+        h.add((uint64_t)state.enemyPositions.size());
+        for (size_t i = 0; i < state.enemyPositions.size(); ++i)
+        {
+            h.add(state.enemyPositions[i]);
+            h.add((uint64_t)state.enemyAlive[i]);
+        }
+        h.add((uint64_t)state.enemiesAlive);
+        h.add(state.enemyVelocityX);
+        h.add((uint64_t)state.enemyDirection);
+        h.add(state.enemyMovedownRemaining);
+        h.add((uint64_t)state.explosionPositions.size());
+        for (size_t i = 0; i < state.explosionPositions.size(); ++i)
+        {
+            h.add(state.explosionPositions[i]);
+            h.add(state.explosionCooldownsRemaining[i]);
+            h.add((uint64_t)state.explosionIds[i]);
+        }
+        h.add((uint64_t)state.nextExplosionId);
+        h.add(state.backgroundPosition);
+        h.add(state.rumbleCountdownRemaining);
+        h.add((uint64_t)state.gameStatus);
+        h.add((uint64_t)(uint32_t)state.playerScore);
+        return (h.hash);
+    }
+
+    void ChecksumStream::record(uint64_t tick, uint64_t hash)
+    {
+        if (_hashes.empty())
+            _firstTick = tick;
+        assert(tick == _firstTick + _hashes.size() && "checksums must be recorded for consecutive ticks");
+        _hashes.push_back(hash);
+    }
+
+    int64_t ChecksumStream::firstDivergence(const ChecksumStream& a, const ChecksumStream& b)
+    {
+        const uint64_t begin = std::max(a._firstTick, b._firstTick);
+        const uint64_t end = std::min(a._firstTick + a._hashes.size(), b._firstTick + b._hashes.size());
+        for (uint64_t tick = begin; tick < end; ++tick)
+        {
+            if (a.at(tick) != b.at(tick))
+                return ((int64_t)tick);
+        }
+        return (-1);
+    }
+
+    bool ChecksumStream::write(FILE* pFile) const
+    {
+        const uint64_t header[2] = { _firstTick, (uint64_t)_hashes.size() };
+        return (fwrite(header, sizeof(header), 1, pFile) == 1 &&
+                fwrite(_hashes.data(), sizeof(uint64_t), _hashes.size(), pFile) == _hashes.size());
+    }
+
+    bool ChecksumStream::read(FILE* pFile)
+    {
+        // The count in the header is not trusted: the list grows a chunk at a time as hashes
+        // actually arrive, so a corrupt or truncated file fails on the short read instead of
+        // allocating whatever the header claims.
+        constexpr size_t kChunk = 4096;
+        uint64_t header[2];
+        clear();
+        if (fread(header, sizeof(header), 1, pFile) != 1)
+            return (false);
+        for (uint64_t remaining = header[1]; remaining > 0; )
+        {
+            const size_t count = (size_t)std::min<uint64_t>(remaining, kChunk);
+            const size_t offset = _hashes.size();
+            _hashes.resize(offset + count);
+            if (fread(_hashes.data() + offset, sizeof(uint64_t), count, pFile) != count)
+            {
+                clear();
+                return (false);
+            }
+            remaining -= count;
+        }
+        _firstTick = header[0];
+        return (true);
+    }
+}
@@ -0,0 +1,154 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLDeterministicSim.hpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 14:40:12      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLDETERMINISTICSIM_HPP
+# define RMDLDETERMINISTICSIM_HPP
+
+# include <cstdint>
+# include <cstdio>
+# include <vector>
+
+# include "RMDLBroadphase.hpp"
+# include "RMDLFixed.hpp"
+
+enum class EnemyDirection
+{
+    Right,
+    Left,
+    Down
+};
+
+enum class GameStatus
+{
+    Ongoing,
+    PlayerWon,
+    PlayerLost
+};
+
+constexpr int32_t kPointsPerEnemy = 10;
+
+/// Fixed-point game simulation for lockstep replays and perf captures.
+///
+/// Every quantity is a fixed::Fixed16_16 or an integer, and the only inputs are the per-tick
+/// TickInput values, so the same config and input sequence give bit-identical states on every
+/// machine. Float only appears at the edges: the config is quantized once by makeConfig, and the
+/// renderer reads a float copy of the state.
+namespace sim
+{
+    using Scalar = fixed::Fixed16_16;
+
+    struct Vec2
+    {
+        Scalar x;
+        Scalar y;
+    };
+
+    struct Config
+    {
+        Scalar      tickSeconds;
+        Scalar      canvasHalfWidth;
+        Scalar      canvasHalfHeight;
+        Scalar      spriteSize;
+        Scalar      playerSpeed;
+        Scalar      playerBulletSpeed;
+        Scalar      playerFireCooldown;
+        Scalar      enemySpeed;
+        Scalar      enemyMoveDownStep;
+        Scalar      explosionDuration;
+        Scalar      rumbleDuration;
+        uint8_t     enemyRows;
+        uint8_t     enemyCols;
+        uint8_t     maxPlayerBullets;
+        uint8_t     maxExplosions;
+        uint32_t    tickRate;
+    };
+
+    /// Player input for one tick, already quantized.
+    struct TickInput
+    {
+        Scalar      moveX;      // -1 (left) to 1 (right)
+        bool        fire;
+    };
+
+    struct State
+    {
+        uint64_t            tick;
+        Vec2                playerPosition;
+        Scalar              playerFireCooldownRemaining;
+        std::vector<Vec2>   playerBulletPositions;
+        std::vector<uint32_t> playerBulletIds;  // per bullet, increasing; ids are never reused
+        uint32_t            nextBulletId;
+        std::vector<Vec2>   enemyPositions;
+        std::vector<uint8_t> enemyAlive;
+        uint32_t            enemiesAlive;
+        Scalar              enemyVelocityX;
+        EnemyDirection      enemyDirection;
+        Scalar              enemyMovedownRemaining;
+        std::vector<Vec2>   explosionPositions;
+        std::vector<Scalar> explosionCooldownsRemaining;
+        std::vector<uint32_t> explosionIds;     // per explosion, increasing; ids are never reused
+        uint32_t            nextExplosionId;
+        Vec2                backgroundPosition;
+        Scalar              rumbleCountdownRemaining;
+        GameStatus          gameStatus;
+        int32_t             playerScore;
+    };
+
+    /// Working memory for step(), kept between ticks so the hit pass does not allocate. It is not
+    /// part of the state: any scratch gives the same results.
+    struct StepScratch
+    {
+        physics::UniformGrid    enemyGrid;      // enemies binned by integer cell, two sprites wide
+        std::vector<int32_t>    enemyCellX;
+        std::vector<int32_t>    enemyCellY;
+    };
+
+    /// Quantizes the float settings once; everything after this is integer arithmetic.
+    Config      makeConfig(float canvasWidth, float canvasHeight, float spriteSize,
+                           float playerSpeed, float playerBulletSpeed, float playerFireCooldownSecs,
+                           float enemySpeed, float enemyMoveDownStep, float explosionDurationSecs, float rumbleDurationSecs,
+                           uint8_t enemyRows, uint8_t enemyCols, uint8_t maxPlayerBullets, uint8_t maxExplosions,
+                           uint32_t tickRate);
+
+    void        reset(State& state, const Config& config, int32_t startingScore);
+    void        step(State& state, const Config& config, const TickInput& input, StepScratch& scratch);
+    /// step() with a scratch of its own, allocated on every call.
+    void        step(State& state, const Config& config, const TickInput& input);
+
+    /// FNV-1a over every field of the state, in a fixed order, independent of struct layout.
+    uint64_t    checksum(const State& state);
+
+    /// One checksum per simulated tick. Comparing a run against a recorded reference finds the
+    /// first tick where the simulations diverged.
+    class ChecksumStream
+    {
+    public:
+        void        clear() { _hashes.clear(); _firstTick = 0; }
+        void        record(uint64_t tick, uint64_t hash);
+
+        uint64_t    firstTick() const { return (_firstTick); }
+        size_t      size() const { return (_hashes.size()); }
+        bool        contains(uint64_t tick) const { return (tick >= _firstTick && tick - _firstTick < _hashes.size()); }
+        uint64_t    at(uint64_t tick) const { return (_hashes[tick - _firstTick]); }
+
+        /// First tick both streams cover whose hashes differ, or -1.
+        static int64_t  firstDivergence(const ChecksumStream& a, const ChecksumStream& b);
+
+        bool        write(FILE* pFile) const;
+        /// False, with the stream left empty, on a short read or a count the file cannot hold.
+        bool        read(FILE* pFile);
+
+    private:
+        std::vector<uint64_t>   _hashes;
+        uint64_t                _firstTick = 0;
+    };
+}
+
+#endif /* RMDLDETERMINISTICSIM_HPP */
@@ -0,0 +1,196 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLEntityStore.hpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:31:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLENTITYSTORE_HPP
+# define RMDLENTITYSTORE_HPP
+
+# include <algorithm>
+# include <cassert>
+# include <cstddef>
+# include <cstdint>
+# include <span>
+# include <tuple>
+# include <utility>
+# include <vector>
+
+namespace ecs
+{
+    /// Handle to an entity. The generation changes every time the slot is reused, so a handle
+    /// kept past destroy() is recognized as stale instead of reaching the next occupant.
+    struct Entity
+    {
+        uint32_t    index;
+        uint32_t    generation;
+
+        bool    operator==(const Entity& other) const { return (index == other.index && generation == other.generation); }
+        bool    operator!=(const Entity& other) const { return (!(*this == other)); }
+    };
+
+    constexpr Entity kNullEntity = { UINT32_MAX, 0 };
+
+    /// All entities of one kind, stored as one dense array per component (structure of arrays).
+    ///
+    /// Entity i of the dense order owns element i of every column, so a system gets whole
+    /// contiguous spans to loop over, eight lanes at a time or with memcpy straight into a GPU
+    /// buffer. destroy() moves the last entity into the hole (swap-remove), which keeps the
+    /// arrays dense but does not keep their order. Handles stay valid across those moves through
+    /// a slot table: slot -> dense index, with a generation per slot.
+    template <typename... Components>
+    class Archetype
+    {
+    public:
+        static constexpr size_t kColumnCount = sizeof...(Components);
+
+        template <size_t I>
+        using ComponentType = std::tuple_element_t<I, std::tuple<Components...>>;
+
+        Entity  create(const Components&... values)
+        {
+            Entity entity;
+            if (!_freeSlots.empty())
+            {
+                entity.index = _freeSlots.back();
+                _freeSlots.pop_back();
+            }
+            else
+            {
+                entity.index = (uint32_t)_slotDense.size();
+                _slotDense.push_back(0);
+                _slotGeneration.push_back(1);
+            }
+            entity.generation = _slotGeneration[entity.index];
+            _slotDense[entity.index] = (uint32_t)_entities.size();
+            _entities.push_back(entity);
+            pushValues(std::index_sequence_for<Components...>(), values...);
+            return (entity);
+        }
+
+        /// Returns false for a stale or null handle.
+        bool    destroy(Entity entity)
+        {
+            if (!alive(entity))
+                return (false);
+            removeAt(_slotDense[entity.index]);
+            return (true);
+        }
+
+        /// Removes every entity whose dense index satisfies pred(i), in one pass. pred sees the
+        /// entities as they are before the call; the survivors keep their handles.
+        template <typename Pred>
+        size_t  removeIf(Pred&& pred)
+        {
+            // From the back, so the entity swapped into a hole has already been visited.
+            size_t removed = 0;
+            for (size_t i = _entities.size(); i-- > 0; )
+            {
+                if (pred(i))
+                {
+                    removeAt((uint32_t)i);
+                    ++removed;
+                }
+            }
+            return (removed);
+        }
+
+        bool    alive(Entity entity) const
+        {
+            return (entity.index < _slotGeneration.size() && _slotGeneration[entity.index] == entity.generation
+                    && _slotDense[entity.index] < _entities.size() && _entities[_slotDense[entity.index]] == entity);
+        }
+
+        /// Dense index of a live entity, for random access into the columns.
+        uint32_t    indexOf(Entity entity) const
+        {
+            assert(alive(entity));
+            return (_slotDense[entity.index]);
+        }
+
+        template <size_t I>
+        ComponentType<I>&   get(Entity entity) { return (std::get<I>(_columns)[indexOf(entity)]); }
+
+        template <size_t I>
+        std::span<ComponentType<I>>         column() { return (std::get<I>(_columns)); }
+        template <size_t I>
+        std::span<const ComponentType<I>>   column() const { return (std::get<I>(_columns)); }
+
+        std::span<const Entity>     entities() const { return (_entities); }
+        size_t                      size() const { return (_entities.size()); }
+        bool                        empty() const { return (_entities.empty()); }
+
+        /// fn(span<Components>...) over every entity at once.
+        template <typename Fn>
+        void    each(Fn&& fn)
+        {
+            std::apply([&](auto&... columns) { fn(std::span(columns)...); }, _columns);
+        }
+
+        /// fn(first, span<Components>...) over consecutive blocks of at most chunkSize entities;
+        /// the blocks are independent, so they can be handed to parallel::parallelFor.
+        template <typename Fn>
+        void    eachChunk(size_t chunkSize, Fn&& fn)
+        {
+            for (size_t first = 0; first < _entities.size(); first += chunkSize)
+            {
+                const size_t count = std::min(chunkSize, _entities.size() - first);
+                std::apply([&](auto&... columns) { fn(first, std::span(columns).subspan(first, count)...); }, _columns);
+            }
+        }
+
+        /// Destroys everything; handles from before are all stale afterwards.
+        void    clear()
+        {
+            for (const Entity& entity : _entities)
+            {
+                ++_slotGeneration[entity.index];
+                _freeSlots.push_back(entity.index);
+            }
+            _entities.clear();
+            std::apply([](auto&... columns) { (columns.clear(), ...); }, _columns);
+        }
+
+        void    reserve(size_t count)
+        {
+            _entities.reserve(count);
+            std::apply([&](auto&... columns) { (columns.reserve(count), ...); }, _columns);
+        }
+
+    private:
+        template <size_t... I>
+        void    pushValues(std::index_sequence<I...>, const Components&... values)
+        {
+            (std::get<I>(_columns).push_back(values), ...);
+        }
+
+        void    removeAt(uint32_t dense)
+        {
+            const uint32_t last = (uint32_t)_entities.size() - 1;
+            const Entity removed = _entities[dense];
+            if (dense != last)
+            {
+                const Entity moved = _entities[last];
+                _entities[dense] = moved;
+                _slotDense[moved.index] = dense;
+                std::apply([&](auto&... columns) { ((columns[dense] = std::move(columns[last])), ...); }, _columns);
+            }
+            _entities.pop_back();
+            std::apply([](auto&... columns) { (columns.pop_back(), ...); }, _columns);
+            ++_slotGeneration[removed.index];
+            _freeSlots.push_back(removed.index);
+        }
+
+        std::tuple<std::vector<Components>...>  _columns;
+        std::vector<Entity>                     _entities;          // dense index -> handle
+        std::vector<uint32_t>                   _slotDense;         // slot -> dense index
+        std::vector<uint32_t>                   _slotGeneration;
+        std::vector<uint32_t>                   _freeSlots;
+    };
+}
+
+#endif /* RMDLENTITYSTORE_HPP */
@@ -0,0 +1,214 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFixed.cpp                +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 11:02:37      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLFixed.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /// The Fixed class of RMDLBinarySpacePartitioning before it moved to integer arithmetic:
+    /// 8 fractional bits in an int, every operation converting both sides to float and rounding
+    /// the result back.
+    struct RoundTripFixed
+    {
+        int     raw;
+
+        static RoundTripFixed fromFloat(float f) { return (RoundTripFixed{ (int)std::roundf(f * 256.f) }); }
+        float   toFloat() const { return ((float)raw / 256.f); }
+
+        RoundTripFixed operator+ (RoundTripFixed rhs) const { return (fromFloat(toFloat() + rhs.toFloat())); }
+        RoundTripFixed operator* (RoundTripFixed rhs) const { return (fromFloat(toFloat() * rhs.toFloat())); }
+    };
+
+    /// Fixed::fromFloat as it was, scaling and adding the half in float.
+    int32_t sFromFloatInFloat(float f)
+    {
+        const float scaled = f * 256.f;
+        if (scaled != scaled)
+            return (0);
+        if (scaled >= 2147483648.f)
+            return (INT32_MAX);
+        if (scaled <= -2147483648.f)
+            return (INT32_MIN);
+        return ((int32_t)(scaled + (scaled < 0.f ? -0.5f : 0.5f)));
+    }
+
+    template <typename Fn>
+    double sBestNsPerValue(Fn&& fn, size_t values)
+    {
+        constexpr int kRuns = 5;
+        double best = 1e30;
+        for (int run = 0; run < kRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        return (best / (double)values);
+    }
+}
+
+namespace fixed
+{
+    void benchmarkFixed(FILE* out)
+    {
+        constexpr size_t kCount = 1 << 20;
+        constexpr size_t kBodies = 4096;
+        constexpr int kSteps = 256;
+        using Fx = Fixed24_8;
+
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> value(-100.f, 100.f);
+        std::vector<float> fa(kCount), fb(kCount), fr(kCount);
+        std::vector<RoundTripFixed> ra(kCount), rb(kCount), rr(kCount);
+        std::vector<Fx> xa(kCount), xb(kCount), xr(kCount);
+        for (size_t i = 0; i < kCount; ++i)
+        {
+            xa[i] = Fx::fromFloat(value(rng));
+            xb[i] = Fx::fromFloat(value(rng));
+            fa[i] = xa[i].toFloat();
+            fb[i] = xb[i].toFloat();
+            ra[i] = RoundTripFixed{ xa[i].raw() };
+            rb[i] = RoundTripFixed{ xb[i].raw() };
+        }
+        const float fScale = 0.75f;
+        const RoundTripFixed rScale = RoundTripFixed::fromFloat(fScale);
+        const Fx xScale = Fx::fromFloat(fScale);
+
+        fprintf(out, "%10s %12s %12s %12s %12s   (ns per value, %zu values)\n",
+                "op", "float", "round-trip", "Fixed24_8", "array", kCount);
+
+        auto row = [&](const char* pName, auto&& floatOp, auto&& roundTripOp, auto&& fixedOp, auto&& arrayOp)
+        {
+            const double floatNs = sBestNsPerValue([&]{ for (size_t i = 0; i < kCount; ++i) fr[i] = floatOp(fa[i], fb[i]); }, kCount);
+            const double roundTripNs = sBestNsPerValue([&]{ for (size_t i = 0; i < kCount; ++i) rr[i] = roundTripOp(ra[i], rb[i]); }, kCount);
+            const double fixedNs = sBestNsPerValue([&]{ for (size_t i = 0; i < kCount; ++i) xr[i] = fixedOp(xa[i], xb[i]); }, kCount);
+            const double arrayNs = sBestNsPerValue(arrayOp, kCount);
+            fprintf(out, "%10s %12.3f %12.3f %12.3f %12.3f\n", pName, floatNs, roundTripNs, fixedNs, arrayNs);
+        };
+        row("add",
+            [](float a, float b) { return (a + b); },
+            [](RoundTripFixed a, RoundTripFixed b) { return (a + b); },
+            [](Fx a, Fx b) { return (a + b); },
+            [&]{ addArray(xr.data(), xa.data(), xb.data(), xr.size()); });
+        row("mul",
+            [](float a, float b) { return (a * b); },
+            [](RoundTripFixed a, RoundTripFixed b) { return (a * b); },
+            [](Fx a, Fx b) { return (a * b); },
+            [&]{ mulArray(xr.data(), xa.data(), xb.data(), xr.size()); });
+        row("mul-add",
+            [&](float a, float b) { return (a * fScale + b); },
+            [&](RoundTripFixed a, RoundTripFixed b) { return (a * rScale + b); },
+            [&](Fx a, Fx b) { return (a * xScale + b); },
+            [&]{ mulAddArray(xr.data(), xa.data(), xScale, xb.data(), xr.size()); });
+
+        // Products against the correctly rounded one, in raw units (1/256).
+        int64_t roundTripError = 0;
+        int64_t fixedError = 0;
+        for (size_t i = 0; i < kCount; ++i)
+        {
+            const int64_t exact = Fx::sMul(xa[i].raw(), xb[i].raw());
+            roundTripError = std::max<int64_t>(roundTripError, std::abs((ra[i] * rb[i]).raw - exact));
+            fixedError = std::max<int64_t>(fixedError, std::abs((int64_t)(xa[i] * xb[i]).raw() - exact));
+        }
+        fprintf(out, "mul error against the rounded product: round-trip %lld, Fixed24_8 %lld (1/256 units)\n",
+                (long long)roundTripError, (long long)fixedError);
+
+        // Explicit Euler, x += v * dt and v += a * dt, against the same steps in double. Each
+        // run starts again from the same bodies.
+        std::vector<Fx> x0(kBodies), v0(kBodies), a0(kBodies);
+        for (size_t i = 0; i < kBodies; ++i)
+        {
+            x0[i] = Fx::fromFloat(value(rng));
+            v0[i] = Fx::fromFloat(value(rng) * 0.1f);
+            a0[i] = Fx::fromFloat(value(rng) * 0.01f);
+        }
+        std::vector<float> fx(kBodies), fv(kBodies), facc(kBodies);
+        std::vector<RoundTripFixed> rx(kBodies), rv(kBodies), racc(kBodies);
+        std::vector<Fx> xx(kBodies), xv(kBodies), xacc(kBodies);
+        std::vector<double> dx(kBodies), dv(kBodies), dacc(kBodies);
+        for (size_t i = 0; i < kBodies; ++i)
+        {
+            dx[i] = x0[i].toDouble();
+            dv[i] = v0[i].toDouble();
+            dacc[i] = a0[i].toDouble();
+        }
+        const float dt = 1.f / 64.f;
+        const RoundTripFixed rdt = RoundTripFixed::fromFloat(dt);
+        const Fx xdt = Fx::fromFloat(dt);
+        const size_t updates = kBodies * kSteps;
+        const double floatNs = sBestNsPerValue([&]
+        {
+            for (size_t i = 0; i < kBodies; ++i) { fx[i] = x0[i].toFloat(); fv[i] = v0[i].toFloat(); facc[i] = a0[i].toFloat(); }
+            for (int s = 0; s < kSteps; ++s)
+                for (size_t i = 0; i < kBodies; ++i) { fx[i] += fv[i] * dt; fv[i] += facc[i] * dt; }
+        }, updates);
+        const double roundTripNs = sBestNsPerValue([&]
+        {
+            for (size_t i = 0; i < kBodies; ++i) { rx[i] = { x0[i].raw() }; rv[i] = { v0[i].raw() }; racc[i] = { a0[i].raw() }; }
+            for (int s = 0; s < kSteps; ++s)
+                for (size_t i = 0; i < kBodies; ++i) { rx[i] = rx[i] + rv[i] * rdt; rv[i] = rv[i] + racc[i] * rdt; }
+        }, updates);
+        const double fixedNs = sBestNsPerValue([&]
+        {
+            xx = x0; xv = v0; xacc = a0;
+            for (int s = 0; s < kSteps; ++s)
+                for (size_t i = 0; i < kBodies; ++i) { xx[i] += xv[i] * xdt; xv[i] += xacc[i] * xdt; }
+        }, updates);
+        const double arrayNs = sBestNsPerValue([&]
+        {
+            xx = x0; xv = v0; xacc = a0;
+            for (int s = 0; s < kSteps; ++s)
+            {
+                mulAddArray(xx.data(), xv.data(), xdt, xx.data(), kBodies);
+                mulAddArray(xv.data(), xacc.data(), xdt, xv.data(), kBodies);
+            }
+        }, updates);
+        for (int s = 0; s < kSteps; ++s)
+            for (size_t i = 0; i < kBodies; ++i) { dx[i] += dv[i] * (double)dt; dv[i] += dacc[i] * (double)dt; }
+        double floatDrift = 0.0;
+        double roundTripDrift = 0.0;
+        double fixedDrift = 0.0;
+        for (size_t i = 0; i < kBodies; ++i)
+        {
+            floatDrift = std::max(floatDrift, std::abs(fx[i] - dx[i]));
+            roundTripDrift = std::max(roundTripDrift, std::abs(rx[i].toFloat() - dx[i]));
+            fixedDrift = std::max(fixedDrift, std::abs(xx[i].toDouble() - dx[i]));
+        }
+        fprintf(out, "%10s %12.3f %12.3f %12.3f %12.3f   (%zu bodies, %d steps)\n",
+                "integrate", floatNs, roundTripNs, fixedNs, arrayNs, kBodies, kSteps);
+        fprintf(out, "%10s %12.3g %12.3g %12.3g %12s   (largest position error against double)\n",
+                "drift", floatDrift, roundTripDrift, fixedDrift, "-");
+
+        // Every float whose scaled value fits, against llround in double.
+        size_t checked = 0;
+        size_t fixedMismatches = 0;
+        size_t inFloatMismatches = 0;
+        std::uniform_int_distribution<uint32_t> bits;
+        for (size_t i = 0; i < kCount * 4; ++i)
+        {
+            const uint32_t b = bits(rng);
+            float f;
+            memcpy(&f, &b, sizeof(f));
+            if (!(std::abs(f) < 8388607.f))
+                continue;
+            const int32_t expected = (int32_t)std::llround((double)f * 256.0);
+            ++checked;
+            fixedMismatches += Fx::fromFloat(f).raw() != expected;
+            inFloatMismatches += sFromFloatInFloat(f) != expected;
+        }
+        fprintf(out, "fromFloat on %zu random floats: %zu differ from llround, %zu did when rounding in float%s\n",
+                checked, fixedMismatches, inFloatMismatches, fixedMismatches ? "  MISMATCH" : "");
+    }
+}
@@ -0,0 +1,302 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFixed.hpp                +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 10:12:41      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLFIXED_HPP
+# define RMDLFIXED_HPP
+
+# include "RMDLSimd.hpp"
+# include <cmath>
+# include <cstdint>
+# include <cstddef>
+# include <cstdio>
+# include <cstring>
+# include <compare>
+# include <limits>
+# include <type_traits>
+
+namespace fixed
+{
+    /// Integer type wide enough to hold the product of two IntT without overflow.
+    template <typename IntT>
+    struct Wide
+    {
+        using Type = int64_t;
+    };
+
+    template <>
+    struct Wide<int64_t>
+    {
+        using Type = __int128;
+    };
+
+    /// Signed fixed-point number with FracBits fractional bits stored in an IntT.
+    /// All arithmetic is integer-only: add and sub work on the raw value, mul and div go through a
+    /// 64-bit intermediate (128-bit for int64_t) and round to nearest, ties away from zero.
+    /// The operators wrap on overflow like the underlying two's-complement integer; the *Sat
+    /// members clamp to [min(), max()] instead. Division by zero returns min() or max() by the
+    /// sign of the dividend in both variants.
+    template <typename IntT, int FracBits>
+    class Fixed
+    {
+        static_assert(std::is_integral_v<IntT> && std::is_signed_v<IntT>, "Fixed needs a signed integer");
+        static_assert(FracBits > 0 && FracBits < (int)sizeof(IntT) * 8 - 1, "FracBits out of range");
+
+    public:
+        using RawType = IntT;
+        using WideType = typename Wide<IntT>::Type;
+
+        static constexpr int    kFractionalBits = FracBits;
+        static constexpr IntT   kOne = IntT(1) << FracBits;
+
+        constexpr Fixed() : _raw(0) {}
+        constexpr Fixed(int n) : _raw(sWrap((WideType)n * kOne)) {}
+
+        static constexpr Fixed fromRaw(IntT raw)
+        {
+            Fixed f;
+            f._raw = raw;
+            return (f);
+        }
+
+        /// Rounds to nearest, ties away from zero, and saturates; NaN becomes zero.
+        /// The scaling is done in double, where it is exact, so no rounding happens before the
+        /// final one (f + 0.5f in float would already round 0.49999997f up to 1).
+        static constexpr Fixed fromFloat(float f)
+        {
+            const double scaled = (double)f * (double)kOne;
+            const double limit = -(double)std::numeric_limits<IntT>::min();
+            if (scaled != scaled)
+                return (Fixed());
+            if (scaled >= limit)
+                return (max());
+            if (scaled <= -limit)
+                return (min());
+            if (!std::is_constant_evaluated())
+                return (fromRaw(sSaturate((WideType)std::llround(scaled))));
+            // llround is not constexpr: truncate, then round on the exact remainder.
+            WideType truncated = (WideType)scaled;
+            const double remainder = scaled - (double)truncated;
+            if (remainder >= 0.5)
+                ++truncated;
+            else if (remainder <= -0.5)
+                --truncated;
+            return (fromRaw(sSaturate(truncated)));
+        }
+
+        static constexpr Fixed min() { return (fromRaw(std::numeric_limits<IntT>::min())); }
+        static constexpr Fixed max() { return (fromRaw(std::numeric_limits<IntT>::max())); }
+        static constexpr Fixed epsilon() { return (fromRaw(1)); }
+
+        constexpr IntT  raw() const { return (_raw); }
+        constexpr float toFloat() const { return ((float)_raw / (float)kOne); }
+        constexpr double toDouble() const { return ((double)_raw / (double)kOne); }
+        /// Rounds towards negative infinity.
+        constexpr int   toInt() const { return ((int)(_raw >> FracBits)); }
+
+        constexpr bool operator== (const Fixed &rhs) const = default;
+        constexpr auto operator<=> (const Fixed &rhs) const = default;
+
+        constexpr Fixed operator- () const { return (fromRaw(sWrap(-(WideType)_raw))); }
+        constexpr Fixed operator+ (const Fixed &rhs) const { return (fromRaw(sWrap((WideType)_raw + rhs._raw))); }
+        constexpr Fixed operator- (const Fixed &rhs) const { return (fromRaw(sWrap((WideType)_raw - rhs._raw))); }
+        constexpr Fixed operator* (const Fixed &rhs) const { return (fromRaw(sWrap(sMul(_raw, rhs._raw)))); }
+        constexpr Fixed operator/ (const Fixed &rhs) const
+        {
+            if (rhs._raw == 0)
+                return (_raw < 0 ? min() : max());
+            return (fromRaw(sWrap(sDiv(_raw, rhs._raw))));
+        }
+
+        constexpr Fixed &operator+= (const Fixed &rhs) { return (*this = *this + rhs); }
+        constexpr Fixed &operator-= (const Fixed &rhs) { return (*this = *this - rhs); }
+        constexpr Fixed &operator*= (const Fixed &rhs) { return (*this = *this * rhs); }
+        constexpr Fixed &operator/= (const Fixed &rhs) { return (*this = *this / rhs); }
+
+        constexpr Fixed addSat(const Fixed &rhs) const { return (fromRaw(sSaturate((WideType)_raw + rhs._raw))); }
+        constexpr Fixed subSat(const Fixed &rhs) const { return (fromRaw(sSaturate((WideType)_raw - rhs._raw))); }
+        constexpr Fixed mulSat(const Fixed &rhs) const { return (fromRaw(sSaturate(sMul(_raw, rhs._raw)))); }
+        constexpr Fixed divSat(const Fixed &rhs) const
+        {
+            if (rhs._raw == 0)
+                return (_raw < 0 ? min() : max());
+            return (fromRaw(sSaturate(sDiv(_raw, rhs._raw))));
+        }
+
+        constexpr Fixed abs() const { return (_raw < 0 ? -*this : *this); }
+
+        /// Rounded product of two raw values, still in WideType so the caller picks wrap or clamp.
+        /// One widening multiply and a branch-free round: for a negative product, the arithmetic
+        /// shift of p + half - 1 is the ceiling of (p - half) / 2^FracBits, i.e. half away from zero.
+        static constexpr WideType sMul(IntT a, IntT b)
+        {
+            const WideType product = (WideType)a * (WideType)b;
+            const WideType half = (WideType)1 << (FracBits - 1);
+            return ((product + half - (WideType)(product < 0)) >> FracBits);
+        }
+
+        /// Rounded quotient of two raw values; b must not be zero.
+        static constexpr WideType sDiv(IntT a, IntT b)
+        {
+            const WideType num = (WideType)a * kOne;
+            const WideType den = b;
+            const WideType q = num / den;
+            const WideType r = num % den;
+            if (2 * (r < 0 ? -r : r) >= (den < 0 ? -den : den))
+                return (q + (((num < 0) == (den < 0)) ? 1 : -1));
+            return (q);
+        }
+
+        static constexpr IntT sWrap(WideType x)
+        {
+            return ((IntT)(std::make_unsigned_t<IntT>)x);
+        }
+
+        static constexpr IntT sSaturate(WideType x)
+        {
+            if (x < (WideType)std::numeric_limits<IntT>::min())
+                return (std::numeric_limits<IntT>::min());
+            if (x > (WideType)std::numeric_limits<IntT>::max())
+                return (std::numeric_limits<IntT>::max());
+            return ((IntT)x);
+        }
+
+    private:
+        IntT    _raw;
+    };
+
+    using Fixed16_16 = Fixed<int32_t, 16>;
+    using Fixed24_8 = Fixed<int32_t, 8>;
+    using Fixed8_8 = Fixed<int16_t, 8>;
+    using Fixed32_32 = Fixed<int64_t, 32>;
+
+    static_assert(sizeof(Fixed24_8) == sizeof(int32_t) && std::is_trivially_copyable_v<Fixed24_8>,
+                  "the array operations copy Fixed values as raw integers");
+
+    // Array operations. For Fixed<int32_t, N>, add, sub and addSat run four lanes at a time on
+    // simd_int4 / simd_long4. The products stay on the scalar operators: without AVX2 there is no
+    // 64-bit lane multiply, and the emulated one lost to a single widening imul per value. Other
+    // widths use the scalar operators too, which the compiler is free to vectorize.
+    // pDst may alias pA or pB.
+
+    template <typename IntT, int FracBits>
+    void addArray(Fixed<IntT, FracBits>* pDst, const Fixed<IntT, FracBits>* pA, const Fixed<IntT, FracBits>* pB, size_t count)
+    {
+        size_t i = 0;
+        if constexpr (sizeof(IntT) == 4)
+        {
+            for (; i + 4 <= count; i += 4)
+            {
+                simd_int4 a, b;
+                memcpy(&a, pA + i, sizeof(a));
+                memcpy(&b, pB + i, sizeof(b));
+                const simd_int4 sum = (simd_int4)((simd_uint4)a + (simd_uint4)b);
+                memcpy((void *)(pDst + i), &sum, sizeof(sum));
+            }
+        }
+        for (; i < count; ++i)
+            pDst[i] = pA[i] + pB[i];
+    }
+
+    template <typename IntT, int FracBits>
+    void addSatArray(Fixed<IntT, FracBits>* pDst, const Fixed<IntT, FracBits>* pA, const Fixed<IntT, FracBits>* pB, size_t count)
+    {
+        size_t i = 0;
+        if constexpr (sizeof(IntT) == 4)
+        {
+            const simd_long4 lo = simdSplat<simd_long4>((int64_t)INT32_MIN);
+            const simd_long4 hi = simdSplat<simd_long4>((int64_t)INT32_MAX);
+            for (; i + 4 <= count; i += 4)
+            {
+                simd_int4 a, b;
+                memcpy(&a, pA + i, sizeof(a));
+                memcpy(&b, pB + i, sizeof(b));
+                const simd_long4 sum = __builtin_convertvector(a, simd_long4) + __builtin_convertvector(b, simd_long4);
+                const simd_int4 r = __builtin_convertvector(simd_clamp(sum, lo, hi), simd_int4);
+                memcpy((void *)(pDst + i), &r, sizeof(r));
+            }
+        }
+        for (; i < count; ++i)
+            pDst[i] = pA[i].addSat(pB[i]);
+    }
+
+    template <typename IntT, int FracBits>
+    void subArray(Fixed<IntT, FracBits>* pDst, const Fixed<IntT, FracBits>* pA, const Fixed<IntT, FracBits>* pB, size_t count)
+    {
+        size_t i = 0;
+        if constexpr (sizeof(IntT) == 4)
+        {
+            for (; i + 4 <= count; i += 4)
+            {
+                simd_int4 a, b;
+                memcpy(&a, pA + i, sizeof(a));
+                memcpy(&b, pB + i, sizeof(b));
+                const simd_int4 diff = (simd_int4)((simd_uint4)a - (simd_uint4)b);
+                memcpy((void *)(pDst + i), &diff, sizeof(diff));
+            }
+        }
+        for (; i < count; ++i)
+            pDst[i] = pA[i] - pB[i];
+    }
+
+    template <typename IntT, int FracBits>
+    void mulArray(Fixed<IntT, FracBits>* pDst, const Fixed<IntT, FracBits>* pA, const Fixed<IntT, FracBits>* pB, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            pDst[i] = pA[i] * pB[i];
+    }
+
+    template <typename IntT, int FracBits>
+    void mulSatArray(Fixed<IntT, FracBits>* pDst, const Fixed<IntT, FracBits>* pA, const Fixed<IntT, FracBits>* pB, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            pDst[i] = pA[i].mulSat(pB[i]);
+    }
+
+    /// pDst[i] = pA[i] * scale + pB[i], wrapping.
+    template <typename IntT, int FracBits>
+    void mulAddArray(Fixed<IntT, FracBits>* pDst, const Fixed<IntT, FracBits>* pA, Fixed<IntT, FracBits> scale, const Fixed<IntT, FracBits>* pB, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            pDst[i] = pA[i] * scale + pB[i];
+    }
+
+    template <typename IntT, int FracBits>
+    void fromFloatArray(Fixed<IntT, FracBits>* pDst, const float* pSrc, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            pDst[i] = Fixed<IntT, FracBits>::fromFloat(pSrc[i]);
+    }
+
+    template <typename IntT, int FracBits>
+    void toFloatArray(float* pDst, const Fixed<IntT, FracBits>* pSrc, size_t count)
+    {
+        size_t i = 0;
+        if constexpr (sizeof(IntT) == 4)
+        {
+            const float scale = 1.f / (float)Fixed<IntT, FracBits>::kOne;
+            for (; i + 4 <= count; i += 4)
+            {
+                simd_int4 raw;
+                memcpy(&raw, pSrc + i, sizeof(raw));
+                const simd_float4 f = simd_float(raw) * scale;
+                memcpy((void *)(pDst + i), &f, sizeof(f));
+            }
+        }
+        for (; i < count; ++i)
+            pDst[i] = pSrc[i].toFloat();
+    }
+
+    /// Add, mul, mul-add and an Euler integration over Fixed24_8 (scalar and the array
+    /// operations), the float round-trip Fixed the BSP used before, and plain float. Prints the
+    /// time per value, the product and drift errors, and a fromFloat check against llround.
+    void    benchmarkFixed(FILE* out);
+}
+
+#endif /* RMDLFIXED_HPP */
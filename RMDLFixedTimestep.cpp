@@ -0,0 +1,79 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFixedTimestep.cpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:05:39      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLFixedTimestep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace timing
+{
+    FixedTimestep::FixedTimestep(uint32_t tickRate, uint32_t maxTicksPerFrame)
+    : _tickRate(0)
+    , _tickSeconds(0.0)
+    , _maxTicksPerFrame(maxTicksPerFrame ? maxTicksPerFrame : 1)
+    , _timeScale(1.0)
+    , _accumulator(0.0)
+    , _prevTimestamp(0.0)
+    , _started(false)
+    , _stats()
+    {
+        setTickRate(tickRate);
+    }
+
+    void FixedTimestep::setTickRate(uint32_t tickRate)
+    {
+        _tickRate = std::max(tickRate, 1u);
+        _tickSeconds = 1.0 / _tickRate;
+        _accumulator = std::min(_accumulator, _tickSeconds);
+    }
+
+    void FixedTimestep::reset()
+    {
+        _accumulator = 0.0;
+        _started = false;
+    }
+
+    uint32_t FixedTimestep::beginFrame(double timestamp)
+    {
+        if (!_started)
+        {
+            _prevTimestamp = timestamp;
+            _started = true;
+        }
+        // A timestamp going backwards (clock change, bad input) counts as no time passing.
+        _accumulator += std::max(timestamp - _prevTimestamp, 0.0) * _timeScale;
+        _prevTimestamp = timestamp;
+
+        // The small tolerance keeps a display at a multiple of the tick rate from alternating
+        // between n - 1 and n + 1 ticks on rounding error.
+        const double due = std::floor(_accumulator / _tickSeconds + 1e-6);
+        uint32_t ticks = (uint32_t)std::min(due, (double)_maxTicksPerFrame);
+        _accumulator = std::max(_accumulator - ticks * _tickSeconds, 0.0);
+        if (due > ticks)
+        {
+            // Keep the fraction of a tick so interpolation stays smooth, drop whole ticks.
+            _stats.droppedTicks += (uint64_t)(due - ticks);
+            _accumulator = std::fmod(_accumulator, _tickSeconds);
+        }
+        return (ticks);
+    }
+
+    void FixedTimestep::endFrame(uint32_t ticks, double ms)
+    {
+        _stats.frames += 1;
+        _stats.ticks += ticks;
+        _stats.ticksLastFrame = ticks;
+        _stats.maxTicksPerFrame = std::max(_stats.maxTicksPerFrame, ticks);
+        _stats.simSeconds += ticks * _tickSeconds;
+        _stats.simMsLastFrame = ms;
+        _stats.simMsTotal += ms;
+    }
+}
@@ -0,0 +1,113 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFixedTimestep.hpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:05:32      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLFIXEDTIMESTEP_HPP
+# define RMDLFIXEDTIMESTEP_HPP
+
+# include <chrono>
+# include <cstdint>
+
+namespace timing
+{
+    struct TimestepStats
+    {
+        uint64_t    frames;
+        uint64_t    ticks;
+        uint32_t    ticksLastFrame;
+        uint32_t    maxTicksPerFrame;   // most ticks any frame ran
+        uint64_t    droppedTicks;       // backlog thrown away by the catch-up cap
+        double      simSeconds;         // simulated time, ticks * tickSeconds
+        double      simMsLastFrame;     // wall-clock time spent in the tick function
+        double      simMsTotal;
+    };
+
+    /// Fixed-tick scheduler driven by the display link's targetTimestamp.
+    ///
+    /// Each frame adds the elapsed time (times timeScale) to an accumulator and runs as many whole
+    /// ticks of 1 / tickRate seconds as it holds, at most maxTicksPerFrame; past that the backlog
+    /// is dropped, so a stall slows the simulation down instead of making the next frames ever
+    /// longer. What is left in the accumulator is alpha(), the fraction of a tick the display is
+    /// ahead of the last simulated state: render lerp(previous, current, alpha()).
+    ///
+    /// The simulation runs at the same rate on a 30 Hz and a 120 Hz display, costs at most
+    /// maxTicksPerFrame ticks per frame, and can run faster than real time with timeScale or with
+    /// runTicks() when there is no display at all.
+    class FixedTimestep
+    {
+    public:
+        explicit FixedTimestep(uint32_t tickRate = 60, uint32_t maxTicksPerFrame = 8);
+
+        /// Runs tick(tickSeconds) for every whole tick due at timestamp (seconds, any origin). The
+        /// first call only starts the clock. Returns how many ticks ran.
+        template <typename TickFn>
+        uint32_t    update(double timestamp, TickFn&& tick);
+
+        /// Runs count ticks right away, whatever the clock says; for headless runs and tests.
+        template <typename TickFn>
+        void        runTicks(uint64_t count, TickFn&& tick);
+
+        /// Restarts the clock at the next update() and clears the accumulator, e.g. after a pause.
+        void        reset();
+
+        void        setTickRate(uint32_t tickRate);
+        void        setMaxTicksPerFrame(uint32_t maxTicks) { _maxTicksPerFrame = maxTicks ? maxTicks : 1; }
+        void        setTimeScale(double scale) { _timeScale = scale > 0.0 ? scale : 0.0; }
+
+        double      tickSeconds() const { return (_tickSeconds); }
+        uint32_t    tickRate() const { return (_tickRate); }
+        uint64_t    tick() const { return (_stats.ticks); }
+        float       alpha() const { return ((float)(_accumulator / _tickSeconds)); }
+        const TimestepStats&    stats() const { return (_stats); }
+
+    private:
+        uint32_t    beginFrame(double timestamp);
+        void        endFrame(uint32_t ticks, double ms);
+
+        uint32_t        _tickRate;
+        double          _tickSeconds;
+        uint32_t        _maxTicksPerFrame;
+        double          _timeScale;
+        double          _accumulator;
+        double          _prevTimestamp;
+        bool            _started;
+        TimestepStats   _stats;
+    };
+
+    /// The value to show alpha of the way from the previous tick's state to the current one.
+    template <typename T>
+    inline T interpolate(const T& previous, const T& current, float alpha)
+    {
+        return (previous + (current - previous) * alpha);
+    }
+
+    template <typename TickFn>
+    uint32_t FixedTimestep::update(double timestamp, TickFn&& tick)
+    {
+        const uint32_t ticks = beginFrame(timestamp);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < ticks; ++i)
+            tick(_tickSeconds);
+        endFrame(ticks, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        return (ticks);
+    }
+
+    template <typename TickFn>
+    void FixedTimestep::runTicks(uint64_t count, TickFn&& tick)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < count; ++i)
+            tick(_tickSeconds);
+        _stats.ticks += count;
+        _stats.simSeconds += count * _tickSeconds;
+        _stats.simMsTotal += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+#endif /* RMDLFIXEDTIMESTEP_HPP */
@@ -0,0 +1,207 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFrustumCulling.cpp       +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 16:05:58      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLFrustumCulling.hpp"
+
+#include "RMDLCamera.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    simd_float8 sLoad(const float* p, size_t lanes)
+    {
+        simd_float8 v = {};
+        memcpy(&v, p, lanes * sizeof(float));
+        return (v);
+    }
+
+    // How far a volume reaches along a plane normal, beyond its center.
+    struct SphereLanes
+    {
+        simd_float8 radius;
+
+        SphereLanes(const culling::SphereSoA& s, size_t base, size_t lanes)
+        : radius(sLoad(s.pRadius + base, lanes))
+        {
+        }
+
+        simd_float8 reach(simd_float4) const
+        {
+            return (radius);
+        }
+    };
+
+    struct AabbLanes
+    {
+        simd_float8 extentX;
+        simd_float8 extentY;
+        simd_float8 extentZ;
+
+        AabbLanes(const culling::AabbSoA& b, size_t base, size_t lanes)
+        : extentX(sLoad(b.pExtentX + base, lanes))
+        , extentY(sLoad(b.pExtentY + base, lanes))
+        , extentZ(sLoad(b.pExtentZ + base, lanes))
+        {
+        }
+
+        simd_float8 reach(simd_float4 plane) const
+        {
+            return (fabsf(plane.x) * extentX + fabsf(plane.y) * extentY + fabsf(plane.z) * extentZ);
+        }
+    };
+
+    template <typename Volumes> struct LanesOf;
+    template <> struct LanesOf<culling::SphereSoA> { using Type = SphereLanes; };
+    template <> struct LanesOf<culling::AabbSoA> { using Type = AabbLanes; };
+
+    // Which of the volumes at [base, base + lanes) are visible; lanes past the end are clear.
+    template <typename Volumes>
+    simd_int8 sVisibleMask(const culling::Frustum& frustum, const Volumes& volumes, size_t base, size_t lanes)
+    {
+        using Lanes = typename LanesOf<Volumes>::Type;
+        const simd_int8 laneIndex = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        const simd_float8 x = sLoad(volumes.pCenterX + base, lanes);
+        const simd_float8 y = sLoad(volumes.pCenterY + base, lanes);
+        const simd_float8 z = sLoad(volumes.pCenterZ + base, lanes);
+        const Lanes shape(volumes, base, lanes);
+        simd_int8 visible = laneIndex < (int)lanes;
+
+        if (frustum.parallel)
+        {
+            // Slab k: -d0 - r <= n.c <= d1 + r, i.e. |n.c - (d1 - d0) / 2| <= (d0 + d1) / 2 + r.
+            for (int k = 0; k < 6 && simd_any(visible); k += 2)
+            {
+                const simd_float4 plane = frustum.planes[k];
+                const float middle = (frustum.planes[k + 1].w - plane.w) * 0.5f;
+                const float halfWidth = (frustum.planes[k + 1].w + plane.w) * 0.5f;
+                const simd_float8 distance = plane.x * x + plane.y * y + plane.z * z - middle;
+                visible &= simd_abs(distance) <= halfWidth + shape.reach(plane);
+            }
+        }
+        else
+        {
+            for (int k = 0; k < 6 && simd_any(visible); ++k)
+            {
+                const simd_float4 plane = frustum.planes[k];
+                const simd_float8 distance = plane.x * x + plane.y * y + plane.z * z + plane.w;
+                visible &= distance >= -shape.reach(plane);
+            }
+        }
+        return (visible);
+    }
+
+    // Culls [begin, end) and writes the visible indices to pOut; returns how many.
+    template <typename Volumes>
+    size_t sCullRange(const culling::Frustum& frustum, const Volumes& volumes, size_t begin, size_t end, uint32_t* pOut)
+    {
+        size_t written = 0;
+
+        for (size_t base = begin; base < end; base += 8)
+        {
+            const size_t lanes = std::min<size_t>(8, end - base);
+            const simd_int8 visible = sVisibleMask(frustum, volumes, base, lanes);
+
+            // Branch-free compaction: every lane is written, only visible ones advance.
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                pOut[written] = (uint32_t)(base + lane);
+                written += visible[lane] & 1;
+            }
+        }
+        return (written);
+    }
+}
+
+namespace culling
+{
+    Frustum Frustum::fromPlanes(const simd_float4 (&planes)[6], bool parallel)
+    {
+        Frustum frustum;
+        for (int i = 0; i < 6; ++i)
+            frustum.planes[i] = planes[i];
+        // Only use slabs if every pair really is opposite; a skewed projection falls back.
+        frustum.parallel = parallel;
+        for (int k = 0; k < 6 && parallel; k += 2)
+        {
+            const simd_float3 n0 = simd_make_float3(planes[k].x, planes[k].y, planes[k].z);
+            const simd_float3 n1 = simd_make_float3(planes[k + 1].x, planes[k + 1].y, planes[k + 1].z);
+            frustum.parallel &= simd_dot(n0, n1) < -0.99999f;
+        }
+        return (frustum);
+    }
+
+    Frustum Frustum::fromCamera(RMDLCamera& camera)
+    {
+        const RMDLCameraUniforms uniforms = camera.uniforms();
+        return (fromPlanes(uniforms.frustumPlanes, camera.isParallel()));
+    }
+
+    simd_int8 visibleMask(const Frustum& frustum, const SphereSoA& spheres, size_t base, size_t lanes)
+    {
+        return (sVisibleMask(frustum, spheres, base, lanes));
+    }
+
+    simd_int8 visibleMask(const Frustum& frustum, const AabbSoA& boxes, size_t base, size_t lanes)
+    {
+        return (sVisibleMask(frustum, boxes, base, lanes));
+    }
+
+    FrustumCuller::FrustumCuller(size_t chunkSize, unsigned threadCount)
+    : _chunkSize(std::max<size_t>(8, (chunkSize + 7) / 8 * 8))
+    , _threadCount(threadCount)
+    , _stats()
+    {
+    }
+
+    template <typename Volumes>
+    size_t FrustumCuller::cullChunks(const Frustum& frustum, const Volumes& volumes, std::vector<uint32_t>& visibleIndices)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t chunkCount = (volumes.count + _chunkSize - 1) / _chunkSize;
+
+        visibleIndices.resize(volumes.count);
+        _chunkVisible.resize(chunkCount);
+        parallel::parallelFor(chunkCount, [&](size_t chunk)
+        {
+            const size_t begin = chunk * _chunkSize;
+            const size_t end = std::min(begin + _chunkSize, volumes.count);
+            _chunkVisible[chunk] = (uint32_t)sCullRange(frustum, volumes, begin, end, visibleIndices.data() + begin);
+        }, _threadCount);
+
+        size_t visible = 0;
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            if (visible != chunk * _chunkSize)
+                memmove(visibleIndices.data() + visible, visibleIndices.data() + chunk * _chunkSize, _chunkVisible[chunk] * sizeof(uint32_t));
+            visible += _chunkVisible[chunk];
+        }
+        visibleIndices.resize(visible);
+
+        _stats.total = volumes.count;
+        _stats.visible = visible;
+        _stats.chunks = (uint32_t)chunkCount;
+        _stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return (visible);
+    }
+
+    size_t FrustumCuller::cull(const Frustum& frustum, const SphereSoA& spheres, std::vector<uint32_t>& visibleIndices)
+    {
+        return (cullChunks(frustum, spheres, visibleIndices));
+    }
+
+    size_t FrustumCuller::cull(const Frustum& frustum, const AabbSoA& boxes, std::vector<uint32_t>& visibleIndices)
+    {
+        return (cullChunks(frustum, boxes, visibleIndices));
+    }
+}
@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFrustumCulling.hpp       +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 16:05:51      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLFRUSTUMCULLING_HPP
+# define RMDLFRUSTUMCULLING_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+class RMDLCamera;
+
+/// Batch frustum culling of bounding volumes on the CPU.
+///
+/// Bounds are passed as structure-of-arrays and tested eight at a time against the six planes
+/// RMDLCamera::updateUniforms stores in RMDLCameraUniforms::frustumPlanes (normalized, pointing
+/// inward). The test is conservative: a volume is culled only when it lies entirely outside one
+/// plane. For parallel cameras the opposite planes are parallel, so each pair is tested as a
+/// single slab, three tests instead of six.
+namespace culling
+{
+    struct Frustum
+    {
+        simd_float4 planes[6];
+        bool        parallel;   // planes 2k and 2k + 1 face each other; tested as slabs
+
+        static Frustum  fromPlanes(const simd_float4 (&planes)[6], bool parallel);
+        static Frustum  fromCamera(RMDLCamera& camera);
+    };
+
+    struct SphereSoA
+    {
+        const float*    pCenterX;
+        const float*    pCenterY;
+        const float*    pCenterZ;
+        const float*    pRadius;
+        size_t          count;
+    };
+
+    struct AabbSoA
+    {
+        const float*    pCenterX;
+        const float*    pCenterY;
+        const float*    pCenterZ;
+        const float*    pExtentX;   // half sizes
+        const float*    pExtentY;
+        const float*    pExtentZ;
+        size_t          count;
+    };
+
+    struct CullStats
+    {
+        uint64_t    total;
+        uint64_t    visible;
+        uint32_t    chunks;
+        double      milliseconds;
+    };
+
+    /// The test itself, for passes that do more than cull: lane i is set (-1) when volume base + i
+    /// is visible. lanes (1 to 8) volumes are read; the remaining lanes are clear.
+    simd_int8   visibleMask(const Frustum& frustum, const SphereSoA& spheres, size_t base, size_t lanes);
+    simd_int8   visibleMask(const Frustum& frustum, const AabbSoA& boxes, size_t base, size_t lanes);
+
+    /// Writes the indices of the visible volumes, in increasing order, to visibleIndices (resized
+    /// to the visible count). Work is split into chunks of chunkSize volumes run in parallel; each
+    /// chunk compacts into its own range of the output, which is then closed up in order.
+    class FrustumCuller
+    {
+    public:
+        explicit FrustumCuller(size_t chunkSize = 4096, unsigned threadCount = 0);
+
+        size_t      cull(const Frustum& frustum, const SphereSoA& spheres, std::vector<uint32_t>& visibleIndices);
+        size_t      cull(const Frustum& frustum, const AabbSoA& boxes, std::vector<uint32_t>& visibleIndices);
+
+        /// Counts of the last cull() call.
+        const CullStats&    stats() const { return (_stats); }
+
+    private:
+        template <typename Volumes>
+        size_t      cullChunks(const Frustum& frustum, const Volumes& volumes, std::vector<uint32_t>& visibleIndices);
+
+        size_t                  _chunkSize;
+        unsigned                _threadCount;
+        std::vector<uint32_t>   _chunkVisible;
+        CullStats               _stats;
+    };
+}
+
+#endif /* RMDLFRUSTUMCULLING_HPP */
@@ -12,6 +12,9 @@
 
 #include "RMDLMathUtils.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #define IR_RUNTIME_METALCPP
 #define IR_PRIVATE_IMPLEMENTATION
 #include <metal_irconverter_runtime/metal_irconverter_runtime.h>
@@ -41,9 +44,6 @@ bool deviceSupportsResidencySets( MTL::Device* pDevice )
 
 RMDLGame::RMDLGame()
 : _gameConfig()
-, _level(0)
-, _prevTargetTimestamp(0.0f)
-, _firstFrame(true)
 {
 }
 
@@ -51,21 +51,18 @@ RMDLGame::~RMDLGame()
 {
 }
 
-void RMDLGame::initializeGameState(const GameConfig& config)
+void RMDLGame::writeProjection()
 {
-    auto sw = config.screenWidth;
-    auto sh = config.screenHeight;
-    const float canvasW = 10;
-    const float canvasH = canvasW * sh / (float)sw;
-    const float spriteSize = kSpriteSize;
+    const float canvasW = _logic.canvasWidth();
+    const float canvasH = _logic.canvasHeight();
+    const math::cx::Matrix4 projection = math::cx::makeOrtho(-canvasW / 2, canvasW / 2, canvasH / 2, -canvasH / 2, -1, 1);
 
     for (uint8_t i = 0; i < kMaxFramesInFlight; ++i)
     {
         assert(_renderData.frameDataBuf[i]);
         auto pFrameData = (RMDLCameraUniforms *)_renderData.frameDataBuf[i]->contents();
-        pFrameData->projectionMatrix = math::makeOrtho(-canvasW / 2, canvasW / 2, canvasH / 2, -canvasH / 2, -1, 1);
+        pFrameData->projectionMatrix = projection;
     }
-    _gameState.playerPosition = simd_make_float4(0, -canvasH / 2 + spriteSize * 2, 0, 1);
 }
 
 void RMDLGame::createBuffers( const GameConfig& config, MTL::Device* pDevice )
@@ -76,6 +73,8 @@ void RMDLGame::createBuffers( const GameConfig& config, MTL::Device* pDevice )
     const size_t frameDataBufSize            = sizeof(RMDLCameraUniforms);
     const size_t playerBulletPositionBufSize = sizeof(simd::float4) * config.maxPlayerBullets;
     const size_t backgroundPositionBufSize   = sizeof(simd::float4);
+    const size_t enemyPositionBufSize        = sizeof(simd::float4) * std::max(config.enemyRows * config.enemyCols, 1);
+    const size_t explosionPositionBufSize    = sizeof(simd::float4) * std::max<size_t>(config.maxExplosions, 1);
     
     auto pHeapDesc = NS::TransferPtr( MTL::HeapDescriptor::alloc()->init() );
     pHeapDesc->setSize(playerPositionBufSize +
@@ -101,6 +100,12 @@ void RMDLGame::createBuffers( const GameConfig& config, MTL::Device* pDevice )
         
         _renderData.backgroundPositionBuf[i] = NS::TransferPtr(pHeap->newBuffer(backgroundPositionBufSize, MTL::ResourceStorageModeShared));
         _renderData.backgroundPositionBuf[i]->setLabel(MTLSTR("backgroundPositionBuf"));
+
+        _renderData.enemyPositionBuf[i] = NS::TransferPtr(pDevice->newBuffer(enemyPositionBufSize, MTL::ResourceStorageModeShared));
+        _renderData.enemyPositionBuf[i]->setLabel(MTLSTR("enemyPositionBuf"));
+
+        _renderData.explosionPositionBuf[i] = NS::TransferPtr(pDevice->newBuffer(explosionPositionBufSize, MTL::ResourceStorageModeShared));
+        _renderData.explosionPositionBuf[i]->setLabel(MTLSTR("explosionPositionBuf"));
         
         constexpr uint64_t bumpAllocatorCapacity = 1024;
         _renderData.bufferAllocator[i] = std::make_unique<BumpAllocator>(pDevice, bumpAllocatorCapacity, MTL::ResourceStorageModeShared);
@@ -189,38 +194,50 @@ void RMDLGame::initialize( const GameConfig& config, MTL::Device* pDevice, MTL::
     initializeResidencySet(config, pDevice, pCommandQueue);
 }
 
-void GameState::reset()
-{
-    playerBulletsAlive          = 0;
-    playerFireCooldownRemaining = 0;
-    playerPosition              = simd_make_float4(0, 0, 0, 1);
-    //nextEnemyDirection          = EnemyDirection::Right;
-    backgroundPosition          = simd_make_float4(0, 0, 0, 1);
-    gameStatus                  = GameStatus::Ongoing;
-    rumbleCountdownRemaining    = 0;
-    enemyMovedownRemaining      = 0;
-}
-
 void RMDLGame::restartGame(const GameConfig &config, float startingScore)
 {
     assert(_renderData.spriteMesh.pIndices || !"Attempt to restart game without calling initialize() first");
     
     _gameConfig = config;
-    _gameConfig.enemySpeed *= (1 + _level * 0.25f);
-    
-    const uint32_t cols = _gameConfig.enemyCols;
-    const uint32_t rows = _gameConfig.enemyRows;
-    
-    _gameState.reset();
-    _gameState.gameStatus = GameStatus::Ongoing;
-    _gameState.playerScore = startingScore;
-    
-    initializeGameState(config);
+    _logic.restart(config, startingScore);
+    writeProjection();
+}
+
+PadState RMDLGame::pollPad() const
+{
+    PadState pad;
+    pad.moveX = _gameController.leftThumbstickX();
+    if (_gameController.isLeftArrowDown())
+        pad.moveX -= 1.0f;
+    if (_gameController.isRightArrowDown())
+        pad.moveX += 1.0f;
+    pad.fire = _gameController.isSpacebarDown() || _gameController.isButtonADown();
+    return (pad);
 }
 
 const GameState* RMDLGame::update(double targetTimestamp, uint8_t frameID)
 {
     assert(frameID < kMaxFramesInFlight);
 
-    return (&_gameState);
+    const GameState& state = _logic.update(targetTimestamp, pollPad());
+    writeRenderBuffers(frameID);
+    return (&state);
+}
+
+void RMDLGame::writeRenderBuffers(uint8_t frameID)
+{
+    // Render extraction is a copy of each position column into this frame's buffer.
+    auto copyColumn = [](std::span<const simd::float4> positions, MTL::Buffer* pBuffer)
+    {
+        const size_t bytes = std::min(positions.size_bytes(), (size_t)pBuffer->length());
+        if (bytes)
+            memcpy(pBuffer->contents(), positions.data(), bytes);
+    };
+
+    const GameState& state = _logic.state();
+    copyColumn(state.enemies.column<0>(), _renderData.enemyPositionBuf[frameID].get());
+    copyColumn(state.playerBullets.column<0>(), _renderData.playerBulletPositionBuf[frameID].get());
+    copyColumn(state.explosions.column<0>(), _renderData.explosionPositionBuf[frameID].get());
+    copyColumn(std::span(&state.playerPosition, 1), _renderData.playerPositionBuf[frameID].get());
+    copyColumn(std::span(&state.backgroundPosition, 1), _renderData.backgroundPositionBuf[frameID].get());
 }
@@ -21,6 +21,7 @@
 #include "RMDLMeshUtils.hpp"
 #include "RMDLPhaseAudio.hpp"
 #include "RMDLBumpAllocator.hpp"
+#include "RMDLGameLogic.hpp"
 
 #include "RMDLConfig_Shared.h"
 #include "RMDLMainRenderer_shared.h"
@@ -32,20 +33,10 @@ constexpr uint64_t kBackgroundTextureIndex   = 3;
 constexpr uint64_t kExplosionTextureIndex    = 4;
 constexpr uint64_t kNumTextures              = 5;
 
-constexpr float kSpriteSize                  = 0.5f;
-constexpr float kRumbleDurationSecs          = 0.1f;
-constexpr float kRumbleIntensity             = 1.0f;
-
-struct GameConfig
+struct GameConfig : GameRules
 {
-    uint32_t                                screenWidth;
-    uint32_t                                screenHeight;
-    
     PhaseAudio*                             pAudioEngine;
 
-
-    uint8_t                                 enemyRows;
-    uint8_t                                 enemyCols;
     NS::SharedPtr<MTL::Texture>             enemyTexture;
     NS::SharedPtr<MTL::Texture>             playerTexture;
     NS::SharedPtr<MTL::Texture>             playerBulletTexture;
@@ -53,13 +44,6 @@ struct GameConfig
     NS::SharedPtr<MTL::Texture>             explosionTexture;
     NS::SharedPtr<MTL::Texture>             fontAtlasTexture;
     NS::SharedPtr<MTL::RenderPipelineState> spritePso;
-    float                                   enemySpeed;
-    float                                   enemyMoveDownStep;
-    float                                   playerSpeed;
-    float                                   playerFireCooldownSecs;
-    uint8_t                                 maxPlayerBullets;
-    uint8_t                                 maxExplosions;
-    float                                   explosionDurationSecs;
 };
 
 /**
@@ -90,39 +74,8 @@ struct RenderData
     NS::SharedPtr<MTL::ResidencySet> residencySet;
 };
 
-enum class EnemyDirection
-{
-    Right,
-    Left,
-    Down
-};
-
-enum class GameStatus
-{
-    Ongoing,
-    PlayerWon,
-    PlayerLost
-};
-
-struct GameState
-{
-    uint32_t                    enemiesAlive;
-    uint8_t                     playerBulletsAlive;
-    std::vector<simd::float4>   playerBulletPositions;
-    float                       playerFireCooldownRemaining;
-    std::vector<simd::float4>   explosionPositions;
-    std::vector<float>          explosionCooldownsRemaining;
-    simd::float4                playerPosition;
-    // EnemyDirection              currentEnemyDirection;
-    simd::float4                backgroundPosition;
-
-    GameStatus                  gameStatus;
-    float                       rumbleCountdownRemaining;
-    float                       enemyMovedownRemaining;
-    void                        reset();
-    int                         playerScore;
-};
-
+/// The game as drawn: GameLogic runs it, RMDLGame polls the controller for it and copies its
+/// state into the per-frame Metal buffers.
 class RMDLGame : public NonCopyable
 {
 public:
@@ -135,21 +88,24 @@ public:
     void             draw( MTL::RenderCommandEncoder* pRenderCmd, uint8_t frameID );
     void             drawUI( MTL::RenderCommandEncoder* pRenderCmd, uint8_t frameID, const FontAtlas&, const IndexedMesh& );
 
-    
+    /// The simulation itself: modes, timestep, checksums and input stream are set there.
+    GameLogic&       logic() { return (_logic); }
+    const GameLogic& logic() const { return (_logic); }
+
+    void             setSimulationMode(SimulationMode mode, uint32_t tickRate = 60) { _logic.setSimulationMode(mode, tickRate); }
+    void             setInputStream(input::InputStream* pInput) { _logic.setInputStream(pInput); }
+
 private:
-    void initializeGameState(const GameConfig& config);
+    void writeProjection();
     void createBuffers( const GameConfig& config, MTL::Device* pDevice );
     void initializeResidencySet( const GameConfig& config, MTL::Device* pDevice, MTL::CommandQueue* pCommandQueue );
-    void updateCollisions();
+    void writeRenderBuffers(uint8_t frameID);
+    PadState pollPad() const;
 
     GameController _gameController;
     GameConfig     _gameConfig;
     RenderData     _renderData;
-    GameState      _gameState;
-    
-    uint32_t       _level;
-    double         _prevTargetTimestamp;
-    bool           _firstFrame;
+    GameLogic      _logic;
 };
 
 #endif // GAME_HPP
@@ -138,6 +138,14 @@
         NSLog(@"Automatically terminating in 8 seconds...");
         [[NSApplication sharedApplication] performSelector:@selector(terminate:) withObject:self afterDelay:8];
     }
+
+    // --record-input <file> saves the session's input, --replay-input <file> plays it back.
+    NSUInteger recordIndex = [args indexOfObject:@"--record-input"];
+    if (recordIndex != NSNotFound && recordIndex + 1 < args.count)
+        [_gameCoordinator startInputRecordingToPath:args[recordIndex + 1]];
+    NSUInteger replayIndex = [args indexOfObject:@"--replay-input"];
+    if (replayIndex != NSNotFound && replayIndex + 1 < args.count)
+        [_gameCoordinator startInputPlaybackFromPath:args[replayIndex + 1]];
 }
 
 - (void)applicationDidFinishLaunching:(NSNotification *)aNotification
@@ -153,6 +161,7 @@
 
 - (void)applicationWillTerminate:(NSNotification *)notification
 {
+    [_gameCoordinator stopInputRecording];
     self->_gameCoordinator = nil;
 }
 
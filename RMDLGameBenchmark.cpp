@@ -0,0 +1,264 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGameBenchmark.cpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 01:12:44      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLGameBenchmark.hpp"
+
+#include "RMDLGameLogic.hpp"
+#include "RMDLInput.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double sMsSince(Clock::time_point start)
+    {
+        return (std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    struct Phase
+    {
+        const char*         pName;
+        std::vector<double> ms;
+    };
+
+    double sPercentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+            return (0.0);
+        return (sorted[std::min(sorted.size() - 1, (size_t)(p * (double)sorted.size()))]);
+    }
+
+    void sPrintPhase(FILE* out, Phase& phase)
+    {
+        std::vector<double>& ms = phase.ms;
+        std::sort(ms.begin(), ms.end());
+        double total = 0.0;
+        for (double value : ms)
+            total += value;
+        fprintf(out, "%-12s %10.4f %10.4f %10.4f %10.4f\n", phase.pName, ms.empty() ? 0.0 : total / (double)ms.size(),
+                sPercentile(ms, 0.50), sPercentile(ms, 0.99), ms.empty() ? 0.0 : ms.back());
+    }
+}
+
+void benchmarkGame(FILE* out, const GameBenchmarkSettings& settings)
+{
+    GameRules rules = {};
+    rules.screenWidth = 1920;
+    rules.screenHeight = 1080;
+    rules.enemyRows = std::max<uint8_t>(settings.enemyRows, 1);
+    rules.enemyCols = std::max<uint8_t>(settings.enemyCols, 1);
+    rules.enemySpeed = 0.5f;
+    rules.enemyMoveDownStep = 0.1f;
+    rules.playerSpeed = 5.0f;
+    rules.playerFireCooldownSecs = settings.fireCooldownSecs;
+    rules.maxPlayerBullets = std::max<uint8_t>(settings.maxPlayerBullets, 1);
+    rules.maxExplosions = std::max<uint8_t>(settings.maxExplosions, 1);
+    rules.explosionDurationSecs = 0.3f;
+
+    input::InputStream inputStream;
+    input::InputPlayer player;
+    GameLogic logic;
+    logic.setSimulationMode(SimulationMode::Deterministic, settings.tickRate);
+    logic.setInputStream(&inputStream);
+    if (settings.pReplayPath)
+    {
+        if (!player.open(settings.pReplayPath))
+        {
+            fprintf(out, "cannot read input recording %s\n", settings.pReplayPath);
+            return;
+        }
+        inputStream.setPlayer(&player);
+    }
+    logic.restart(rules, 0);
+
+    ScoreLayout layout;
+    layout.canvasWidth = 30.f;
+    layout.canvasHeight = 30.f * rules.screenHeight / (float)rules.screenWidth;
+    int highScore = 0;
+    int shownScore = -1;
+    char scoreText[32];
+
+    // frame is the sum of everything the session does in a frame: the ticks (fixed-point
+    // collisions included), publishing, the UI and the restart after a wave. The float pass is
+    // timed on the side and left out of it.
+    Phase phases[] = { { "ticks", {} }, { "publish", {} }, { "ui", {} }, { "restart", {} }, { "frame", {} } };
+    Phase floatPass = { "float pass", {} };
+    for (Phase& phase : phases)
+        phase.ms.reserve(settings.frames);
+    floatPass.ms.reserve(settings.frames);
+    uint64_t ticks = 0;
+    uint64_t hits = 0;
+    uint32_t waves = 0;
+    uint32_t won = 0;
+    GameState probe;
+
+    const double frameSeconds = 1.0 / (double)std::max(settings.displayRate, 1u);
+    for (uint32_t frame = 0; frame < settings.frames; ++frame)
+    {
+        // Sweeps from side to side every two seconds while firing, unless replaying.
+        PadState pad;
+        pad.moveX = (frame / (settings.displayRate * 2)) % 2 ? 1.f : -1.f;
+        pad.fire = true;
+
+        auto start = Clock::now();
+        const GameState& state = logic.update(frame * frameSeconds, pad);
+        const double updateMs = sMsSince(start);
+
+        start = Clock::now();
+        if (state.playerScore != shownScore)
+        {
+            shownScore = state.playerScore;
+            layout.showCurrentScore((size_t)snprintf(scoreText, sizeof(scoreText), "SCORE:%d", shownScore));
+            if (shownScore > highScore)
+            {
+                highScore = shownScore;
+                snprintf(scoreText, sizeof(scoreText), "HIGH SCORE:%d", highScore);
+                layout.showHighScore();
+            }
+        }
+        layout.update(frame * frameSeconds);
+        const double uiMs = sMsSince(start);
+
+        // Side measurement: the Realtime-mode collision pass over the same positions, on a copy
+        // so that the fixed-point simulation stays the only one driving the session.
+        probe = state;
+        const size_t enemiesBefore = probe.enemies.size();
+        start = Clock::now();
+        logic.updateCollisions(probe);
+        floatPass.ms.push_back(sMsSince(start));
+        hits += enemiesBefore - probe.enemies.size();
+
+        const LogicTimings& timings = logic.lastTimings();
+        ticks += timings.ticks;
+
+        double restartMs = 0.0;
+        if (state.gameStatus != GameStatus::Ongoing)
+        {
+            ++waves;
+            won += state.gameStatus == GameStatus::PlayerWon;
+            start = Clock::now();
+            logic.restart(rules, state.gameStatus == GameStatus::PlayerWon ? (float)state.playerScore : 0.f);
+            restartMs = sMsSince(start);
+        }
+
+        phases[0].ms.push_back(timings.ticksMs);
+        phases[1].ms.push_back(timings.publishMs);
+        phases[2].ms.push_back(uiMs);
+        phases[3].ms.push_back(restartMs);
+        phases[4].ms.push_back(updateMs + uiMs + restartMs);
+    }
+
+    const sim::ChecksumStream& checksums = logic.checksums();
+    const uint64_t lastChecksum = checksums.size() ? checksums.at(checksums.firstTick() + checksums.size() - 1) : 0;
+    fprintf(out, "%u frames at %u Hz, %llu ticks at %u Hz, wave %u x %u, %u bullets, %u explosions%s%s\n",
+            settings.frames, settings.displayRate, (unsigned long long)ticks, settings.tickRate,
+            rules.enemyRows, rules.enemyCols, rules.maxPlayerBullets, rules.maxExplosions,
+            settings.pReplayPath ? ", input from " : "", settings.pReplayPath ? settings.pReplayPath : "");
+    fprintf(out, "%u waves ended (%u won), high score %d, %llu float-pass hits, last checksum %016llx\n",
+            waves, won, highScore, (unsigned long long)hits, (unsigned long long)lastChecksum);
+    fprintf(out, "%-12s %10s %10s %10s %10s\n", "phase (ms)", "mean", "p50", "p99", "max");
+    for (Phase& phase : phases)
+        sPrintPhase(out, phase);
+    fprintf(out, "side measurement, not in frame: Realtime-mode collisions on a copy of each published state\n");
+    sPrintPhase(out, floatPass);
+}
+
+#ifdef RMDL_BENCHMARK_MAIN
+
+# include "RMDLBroadphase.hpp"
+# include "RMDLClusteredLights.hpp"
+# include "RMDLFixed.hpp"
+# include "RMDLJobSystem.hpp"
+# include "RMDLMathUtils.hpp"
+# include "RMDLOcclusionCulling.hpp"
+# include "RMDLPhysics.hpp"
+# include "RMDLPotentiallyVisibleSet.hpp"
+# include "RMDLSceneBvh.hpp"
+# include "RMDLSoftwareRasterizer.hpp"
+
+# include <cstdlib>
+# include <cstring>
+
+// The `bench` target of the Makefile builds this file alone with the game logic, without the
+// app's main or any framework:
+//   ./Padentvo-bench --bullets 255 --explosions 255 --cooldown 0.01 --frames 100000
+// --replay <file> feeds a recording from --record-input instead of the scripted sweep, and
+// --all also runs the broadphase, rigid body, job system, software rasterizer, occlusion,
+// clustered light, matrix inverse, scene BVH, fixed-point and potentially visible set benchmarks.
+int main(int argc, char** argv)
+{
+    GameBenchmarkSettings settings;
+    bool all = false;
+    auto byte = [](const char* pValue)
+    {
+        return ((uint8_t)std::clamp(atoi(pValue), 1, 255));
+    };
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* pArg = argv[i];
+        const char* pValue = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!strcmp(pArg, "--all"))
+        {
+            all = true;
+            continue;
+        }
+        if (!pValue)
+        {
+            fprintf(stderr, "%s needs a value\n", pArg);
+            return (1);
+        }
+        ++i;
+        if (!strcmp(pArg, "--rows"))
+            settings.enemyRows = byte(pValue);
+        else if (!strcmp(pArg, "--cols"))
+            settings.enemyCols = byte(pValue);
+        else if (!strcmp(pArg, "--bullets"))
+            settings.maxPlayerBullets = byte(pValue);
+        else if (!strcmp(pArg, "--explosions"))
+            settings.maxExplosions = byte(pValue);
+        else if (!strcmp(pArg, "--cooldown"))
+            settings.fireCooldownSecs = (float)atof(pValue);
+        else if (!strcmp(pArg, "--frames"))
+            settings.frames = (uint32_t)strtoul(pValue, nullptr, 10);
+        else if (!strcmp(pArg, "--display-rate"))
+            settings.displayRate = std::max(1u, (uint32_t)strtoul(pValue, nullptr, 10));
+        else if (!strcmp(pArg, "--tick-rate"))
+            settings.tickRate = std::max(1u, (uint32_t)strtoul(pValue, nullptr, 10));
+        else if (!strcmp(pArg, "--replay"))
+            settings.pReplayPath = pValue;
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", pArg);
+            return (1);
+        }
+    }
+
+    benchmarkGame(stdout, settings);
+    if (all)
+    {
+        physics::benchmarkBroadphase(stdout);
+        physics::benchmarkRigidBodies(stdout);
+        jobs::benchmarkJobSystem(stdout);
+        raster::benchmarkRasterizer(stdout);
+        culling::benchmarkOcclusion(stdout);
+        lighting::benchmarkClusteredLights(stdout);
+        math::benchmarkInverses(stdout);
+        spatial::benchmarkSceneBvh(stdout);
+        fixed::benchmarkFixed(stdout);
+        spatial::benchmarkPvs(stdout);
+    }
+    return (0);
+}
+
+#endif
@@ -0,0 +1,38 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGameBenchmark.hpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 01:12:37      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLGAMEBENCHMARK_HPP
+# define RMDLGAMEBENCHMARK_HPP
+
+# include <cstdint>
+# include <cstdio>
+
+struct GameBenchmarkSettings
+{
+    uint8_t     enemyRows = 5;          // the 10 unit wide canvas fits about 5 rows of 12
+    uint8_t     enemyCols = 11;
+    uint8_t     maxPlayerBullets = 32;
+    uint8_t     maxExplosions = 32;
+    float       fireCooldownSecs = 0.05f;
+    uint32_t    frames = 10000;
+    uint32_t    displayRate = 60;       // frames per simulated second
+    uint32_t    tickRate = 60;
+    const char* pReplayPath = nullptr;  // input recorded with --record-input, else a scripted sweep
+};
+
+/// Runs the game headless for settings.frames frames of simulated time, in Deterministic mode,
+/// and prints p50 / p99 / max per phase: the ticks, publishing the fixed-point state, the score
+/// UI layout, the restart when a wave ends, and their sum per frame. The float collision pass of
+/// Realtime mode is timed separately over a copy of each published state and is not part of the
+/// frame. The last tick's checksum is printed too, so two builds can be checked to have run the
+/// same session before their timings are compared. Needs no GPU.
+void    benchmarkGame(FILE* out, const GameBenchmarkSettings& settings);
+
+#endif /* RMDLGAMEBENCHMARK_HPP */
@@ -34,6 +34,7 @@
 #include <stdlib.h>
 
 #include "RMDLGameCoordinator.hpp"
+#include "RMDLJobSystem.hpp"
 #include "RMDLMathUtils.hpp"
 #include "RMDLUtilities.h"
 
@@ -121,16 +122,21 @@ GameCoordinator::GameCoordinator(MTL::Device* pDevice,
     , _highScore(0)
     , _prevScore(0)
     , _angle(0.f)
+    , _prevAngle(0.f)
+    , _animationClock(60, kMaxTicksPerUpdate)
     , _animationIndex(0)
     //, _pCubeVertexBuffer(nullptr)
+    , _inputTick(0)
+    , _frameGraph(kMaxFramesInFlight)
 {
     printf("GameCoordinator constructor called\n");
-    unsigned int numThreads = std::thread::hardware_concurrency();
-    std::cout << "number of Threads = std::thread::hardware_concurrency : " << numThreads << std::endl;
+    // Starts the workers now rather than inside the first frame.
+    std::cout << "job system threads : " << jobs::JobSystem::shared().threadCount() << std::endl;
     ft_memset(&_screenMesh, 0x0, sizeof(IndexedMesh));
     ft_memset(&_quadMesh, 0x0, sizeof(IndexedMesh));
     _pCommandQueue = _pDevice->newCommandQueue();
     setupCamera();
+    _game.setInputStream(&_input);
     std::cout << sizeof(uint64_t) << std::endl;
     for (size_t i = 0; i < kMaxFramesInFlight; ++i)
     {
@@ -153,11 +159,15 @@ GameCoordinator::GameCoordinator(MTL::Device* pDevice,
     buildBuffersMap();
     //setupPipelineCamera();
     _semaphore = dispatch_semaphore_create( GameCoordinator::kMaxFramesInFlight );
+    buildFrameGraph();
     printf("GameCoordinator constructor completed\n");
 }
 
 GameCoordinator::~GameCoordinator()
 {
+    // Frames still in flight use the resources released below.
+    _frameGraph.waitIdle();
+    stopInputRecording();
     _pSampler->release();
 
     _pPresentPipeline->release();
@@ -229,14 +239,72 @@ void GameCoordinator::buildRenderTextures(NS::UInteger nativeWidth, NS::UInteger
 
 void GameCoordinator::moveCamera( simd::float3 translation )
 {
-    simd::float3 newPosition = _camera.position() + translation;
-    _camera.setPosition(newPosition);
+    _input.push(input::EventType::CameraMove, translation.x, translation.y, translation.z);
 }
 
 void GameCoordinator::rotateCamera(float deltaYaw, float deltaPitch)
 {
-    _camera.rotateOnAxis({0.0f, 1.0f, 0.0f}, deltaYaw);
-    _camera.rotateOnAxis(_camera.right(), deltaPitch);
+    _input.push(input::EventType::CameraRotate, deltaYaw, deltaPitch);
+}
+
+// Every generator the session draws from: randi/randf, random_float and the font colors.
+static void seedSessionRandom(uint32_t seed)
+{
+    seedRand(seed);
+    srandom(seed);
+    srand(seed);
+}
+
+void GameCoordinator::applyInput(const input::Event& event)
+{
+    if (event.type == input::EventType::CameraMove)
+    {
+        simd::float3 newPosition = _camera.position() + simd::float3{ event.values[0], event.values[1], event.values[2] };
+        _camera.setPosition(newPosition);
+    }
+    else if (event.type == input::EventType::CameraRotate)
+    {
+        _camera.rotateOnAxis({0.0f, 1.0f, 0.0f}, event.values[0]);
+        _camera.rotateOnAxis(_camera.right(), event.values[1]);
+    }
+}
+
+bool GameCoordinator::startInputRecording(const char* pPath, uint32_t seed)
+{
+    if (!_inputRecorder.open(pPath, seed))
+    {
+        printf("Cannot record input to %s\n", pPath);
+        return (false);
+    }
+    seedSessionRandom(seed);
+    _input.setRecorder(&_inputRecorder);
+    printf("Recording input to %s, seed %u\n", pPath, seed);
+    return (true);
+}
+
+bool GameCoordinator::stopInputRecording()
+{
+    if (!_inputRecorder.isOpen())
+        return (true);
+    _input.setRecorder(nullptr);
+    const uint64_t events = _inputRecorder.eventCount();
+    const bool ok = _inputRecorder.close();
+    printf("Recorded %llu input events%s\n", (unsigned long long)events, ok ? "" : ", but writing failed");
+    return (ok);
+}
+
+bool GameCoordinator::startInputPlayback(const char* pPath)
+{
+    _input.setPlayer(nullptr);
+    if (!_inputPlayer.open(pPath))
+    {
+        printf("Cannot replay input from %s\n", pPath);
+        return (false);
+    }
+    seedSessionRandom(_inputPlayer.seed());
+    _input.setPlayer(&_inputPlayer);
+    printf("Replaying %zu input events from %s, seed %u\n", _inputPlayer.eventCount(), pPath, _inputPlayer.seed());
+    return (true);
 }
 
 void GameCoordinator::setCameraAspectRatio(float aspectRatio)
@@ -653,30 +721,65 @@ void GameCoordinator::buildBuffersMap()
 //    pComputeEncoder->endEncoding();
 //}
 
-void GameCoordinator::draw( CA::MetalDrawable* pDrawable, double targetTimestamp )
+void GameCoordinator::buildFrameGraph()
 {
-    NS::AutoreleasePool *pPool = NS::AutoreleasePool::alloc()->init();
-    
-    _frame = (_frame + 1) % GameCoordinator::kMaxFramesInFlight;
-    MTL::Buffer* pInstanceDataBufferMap = _pInstanceDataBufferMap[ _frame ];
+    // simulate -> extract -> encode. The animation clock and the command queue must advance in
+    // frame order, so simulate and encode also wait for themselves in the previous frame; the
+    // next frame's simulate and extract overlap this frame's encode.
+    _frameStages = { FrameStage{ this, &GameCoordinator::simulateFrame },
+                     FrameStage{ this, &GameCoordinator::extractInstances },
+                     FrameStage{ this, &GameCoordinator::encodeFrame } };
+    const jobs::TaskId simulate = _frameGraph.addTask("simulate", _frameStages[0]);
+    const jobs::TaskId extract = _frameGraph.addTask("extract", _frameStages[1]);
+    const jobs::TaskId encode = _frameGraph.addTask("encode", _frameStages[2]);
+    _frameGraph.addDependency(simulate, extract);
+    _frameGraph.addDependency(extract, encode);
+    _frameGraph.addFrameDependency(simulate, simulate);
+    _frameGraph.addFrameDependency(encode, encode);
+}
 
-    MTL::CommandBuffer* pCmd = _pCommandQueue->commandBuffer();
+void GameCoordinator::draw( CA::MetalDrawable* pDrawable, double targetTimestamp )
+{
+    // The slot is free once the frame that used it last is done; the wait runs frame tasks.
+    if (_frame >= ::kMaxFramesInFlight)
+        _frameGraph.waitFrame(_frame - ::kMaxFramesInFlight);
     dispatch_semaphore_wait( _semaphore, DISPATCH_TIME_FOREVER );
-    GameCoordinator* pGameCoordinator = this;
-    pCmd->addCompletedHandler( ^void( MTL::CommandBuffer* pCmd ){
-        dispatch_semaphore_signal( pGameCoordinator->_semaphore );
+
+    FrameSlot& slot = _frameSlots[_frame % ::kMaxFramesInFlight];
+    slot.pDrawable = pDrawable->retain();
+    slot.targetTimestamp = targetTimestamp;
+    _frame = _frameGraph.runFrame() + 1;
+}
+
+void GameCoordinator::simulateFrame(const jobs::FrameInfo& frame)
+{
+    FrameSlot& slot = _frameSlots[frame.slot];
+    // 0.1 radian per 60 Hz tick, whatever the display rate; drawn between the last two ticks.
+    _animationClock.update(slot.targetTimestamp, [this](double)
+    {
+        _input.drain(_inputTick++, input::kCameraEvents, [this](const input::Event& event)
+        {
+            applyInput(event);
+        });
+        _prevAngle = _angle;
+        _angle += 0.1f;
     });
+    slot.angle = timing::interpolate(_prevAngle, _angle, _animationClock.alpha());
+}
 
-    _angle += 0.1f;
+void GameCoordinator::extractInstances(const jobs::FrameInfo& frame)
+{
+    const float angle = _frameSlots[frame.slot].angle;
     const float scl = 0.1f;
+    MTL::Buffer* pInstanceDataBufferMap = _pInstanceDataBufferMap[ frame.slot ];
     shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( pInstanceDataBufferMap->contents() );
     for ( size_t i = 0; i < kNumInstances; ++i )
     {
         float iDivNumInstances = i / (float)kNumInstances;
         float xoff = (iDivNumInstances * 2.0f - 1.0f) + (1.f/kNumInstances);
-        float yoff = sin( ( iDivNumInstances + _angle ) * 2.0f * M_PI);
-        pInstanceData[ i ].instanceTransform = ( simd::float4x4){ (simd::float4){ scl * sinf(_angle), scl * cosf(_angle), 0.f, 0.f },
-                                                (simd::float4){ scl * cosf(_angle), scl * -sinf(_angle), 0.f, 0.f },
+        float yoff = sin( ( iDivNumInstances + angle ) * 2.0f * M_PI);
+        pInstanceData[ i ].instanceTransform = ( simd::float4x4){ (simd::float4){ scl * sinf(angle), scl * cosf(angle), 0.f, 0.f },
+                                                (simd::float4){ scl * cosf(angle), scl * -sinf(angle), 0.f, 0.f },
                                                 (simd::float4){ 0.f, 0.f, scl, 0.f },
                                                 (simd::float4){ xoff, yoff, 0.f, 1.f } };
 
@@ -686,10 +789,24 @@ void GameCoordinator::draw( CA::MetalDrawable* pDrawable, double targetTimestamp
         pInstanceData[ i ].instanceColor = (simd::float4){ r, g, b, 1.0f };
     }
     pInstanceDataBufferMap->didModifyRange( NS::Range::Make( 0, pInstanceDataBufferMap->length() ) );
-    
+}
+
+void GameCoordinator::encodeFrame(const jobs::FrameInfo& frame)
+{
+    // Runs on a job system thread, which has no autorelease pool of its own.
+    NS::AutoreleasePool *pPool = NS::AutoreleasePool::alloc()->init();
+    FrameSlot& slot = _frameSlots[frame.slot];
+    MTL::Buffer* pInstanceDataBufferMap = _pInstanceDataBufferMap[ frame.slot ];
+
+    MTL::CommandBuffer* pCmd = _pCommandQueue->commandBuffer();
+    GameCoordinator* pGameCoordinator = this;
+    pCmd->addCompletedHandler( ^void( MTL::CommandBuffer* pCmd ){
+        dispatch_semaphore_signal( pGameCoordinator->_semaphore );
+    });
+
     MTL::RenderPassDescriptor* pRpd = MTL::RenderPassDescriptor::renderPassDescriptor();
     auto colorAttachment = pRpd->colorAttachments()->object(0);
-    colorAttachment->setTexture(pDrawable->texture());
+    colorAttachment->setTexture(slot.pDrawable->texture());
     colorAttachment->setLoadAction(MTL::LoadActionClear);
     colorAttachment->setStoreAction(MTL::StoreActionStore);
     colorAttachment->setClearColor(MTL::ClearColor(0., 0., 0., 1.0));
@@ -701,9 +818,11 @@ void GameCoordinator::draw( CA::MetalDrawable* pDrawable, double targetTimestamp
     pEnc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle, 6, MTL::IndexType::IndexTypeUInt16, _pIndexBufferMap, 0, kNumInstances );
     
     pEnc->endEncoding();
-    pCmd->presentDrawable(pDrawable);
+    pCmd->presentDrawable(slot.pDrawable);
     //pCmd->encodeSignalEvent(_pPacingEvent.get(), _pacingTimeStampIndex);
     pCmd->commit();
+    slot.pDrawable->release();
+    slot.pDrawable = nullptr;
     pPool->release();
 //    _frame = (_frame + 1) % kMaxFramesInFlight;
 //    //_bufferAllocator[_frame]->reset();
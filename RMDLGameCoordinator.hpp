@@ -25,6 +25,9 @@
 #include "RMDLUI.hpp"
 #include "RMDLFontLoader.h"
 #include "RMDLGame.hpp"
+#include "RMDLFixedTimestep.hpp"
+#include "RMDLTaskGraph.hpp"
+#include "RMDLInput.hpp"
 
 constexpr uint8_t MaxFramesInFlight = 3;
 static const uint32_t NumLights = 256;
@@ -66,8 +69,16 @@ public:
     int highScore() const                { return _highScore; }
 
     void setupCamera();
+    /// Both go through _input and take effect at the next animation tick.
     void moveCamera( simd::float3 translation );
     void rotateCamera(float deltaYaw, float deltaPitch);
+
+    /// Records every input event to pPath until stopInputRecording(), with a fixed random seed
+    /// saved alongside. Playback seeds the same way and replaces live input until the recording
+    /// runs out. Ticks count from the start of either, so the session replays the same.
+    bool startInputRecording(const char* pPath, uint32_t seed = 0x524D444C);
+    bool stopInputRecording();
+    bool startInputPlayback(const char* pPath);
     void setCameraAspectRatio(float aspectRatio);
     
     float _rotationAngle;
@@ -88,6 +99,27 @@ public:
     
     
 private:
+    // What a frame's tasks hand each other; one per frame in flight.
+    struct FrameSlot
+    {
+        CA::MetalDrawable*  pDrawable;          // retained until encoded
+        double              targetTimestamp;
+        float               angle;
+    };
+
+    struct FrameStage
+    {
+        GameCoordinator*    pOwner;
+        void                (GameCoordinator::*pRun)(const jobs::FrameInfo& frame);
+        void                operator()(const jobs::FrameInfo& frame) const { (pOwner->*pRun)(frame); }
+    };
+
+    void applyInput(const input::Event& event);
+    void buildFrameGraph();
+    void simulateFrame(const jobs::FrameInfo& frame);
+    void extractInstances(const jobs::FrameInfo& frame);
+    void encodeFrame(const jobs::FrameInfo& frame);
+
     RMDLCamera                          _camera;
     RMDLGame                            _game;
     RMDLUI                              _ui;
@@ -126,7 +158,7 @@ private:
 
     std::array<std::unique_ptr<BumpAllocator>, kMaxFramesInFlight> _bufferAllocator;
 
-    int _frame;
+    uint64_t _frame;                    // frames handed to _frameGraph
 
     std::unique_ptr<PhaseAudio> _pAudioEngine;
     
@@ -146,6 +178,8 @@ private:
     MTL::Buffer*                _pIndexBuffer;
     MTL::Buffer*                _pTextureAnimationBuffer;
     float                       _angle;
+    float                       _prevAngle;
+    timing::FixedTimestep       _animationClock;
     int                         _frameP;
     dispatch_semaphore_t        _semaphore;
     uint                        _animationIndex;
@@ -154,6 +188,15 @@ private:
     MTL::Buffer* _pInstanceDataBufferMap[kMaxFramesInFlight];
     MTL::Buffer* _pIndexBufferMap;
     static const int            kMaxFramesInFlight;
+
+    input::InputStream                          _input;
+    input::InputRecorder                        _inputRecorder;
+    input::InputPlayer                          _inputPlayer;
+    uint64_t                                    _inputTick;         // animation ticks drained so far
+
+    std::array<FrameSlot, ::kMaxFramesInFlight>  _frameSlots;
+    std::array<FrameStage, 3>                   _frameStages;
+    jobs::TaskGraph                             _frameGraph;
 };
 
 #endif /* RMDLGAMECOORDINATOR_HPP */
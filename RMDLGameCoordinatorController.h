@@ -36,4 +36,10 @@
 
 - (void)updateCameraAspectRatio:(float)aspectRatio;
 
+- (BOOL)startInputRecordingToPath:(nonnull NSString *)path;
+
+- (BOOL)stopInputRecording;
+
+- (BOOL)startInputPlaybackFromPath:(nonnull NSString *)path;
+
 @end
@@ -126,4 +126,19 @@ static void* renderWorker( void* _Nullable obj )
     _pGameCoordinator->setCameraAspectRatio(aspectRatio);
 }
 
+- (BOOL)startInputRecordingToPath:(nonnull NSString *)path
+{
+    return (_pGameCoordinator->startInputRecording(path.fileSystemRepresentation));
+}
+
+- (BOOL)stopInputRecording
+{
+    return (_pGameCoordinator->stopInputRecording());
+}
+
+- (BOOL)startInputPlaybackFromPath:(nonnull NSString *)path
+{
+    return (_pGameCoordinator->startInputPlayback(path.fileSystemRepresentation));
+}
+
 @end
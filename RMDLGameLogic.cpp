@@ -0,0 +1,396 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGameLogic.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 00:41:16      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLGameLogic.hpp"
+
+#include "RMDLNarrowphase.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    double sMsSince(std::chrono::steady_clock::time_point start)
+    {
+        return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    /// Carries the entities published for the sim's ids last time over to its current ids:
+    /// entities whose id is gone are destroyed, spawn(slot) creates one for each new id, and
+    /// update(entity, slot) runs on every current slot. Ids only ever grow, so new ones come after
+    /// every surviving one and both lists stay in the same order.
+    template <typename Store, typename Spawn, typename Update>
+    void sSyncEntities(Store& store, std::vector<ecs::Entity>& entities, std::vector<uint32_t>& entityIds,
+                       const std::vector<uint32_t>& ids, Spawn&& spawn, Update&& update)
+    {
+        const size_t published = entities.size();
+        size_t old = 0;
+        for (size_t slot = 0; slot < ids.size(); ++slot)
+        {
+            while (old < published && entityIds[old] < ids[slot])
+                store.destroy(entities[old++]);
+            const bool kept = old < published && entityIds[old] == ids[slot];
+            const ecs::Entity entity = kept ? entities[old++] : spawn(slot);
+            if (slot < published)
+            {
+                entities[slot] = entity;
+                entityIds[slot] = ids[slot];
+            }
+            else
+            {
+                entities.push_back(entity);
+                entityIds.push_back(ids[slot]);
+            }
+            if (kept)
+                update(entity, slot);
+        }
+        while (old < published)
+            store.destroy(entities[old++]);
+        entities.resize(ids.size());
+        entityIds.resize(ids.size());
+    }
+}
+
+void GameState::reset()
+{
+    enemies.clear();
+    playerBullets.clear();
+    explosions.clear();
+    playerFireCooldownRemaining = 0;
+    playerPosition              = simd_make_float4(0, 0, 0, 1);
+    //nextEnemyDirection          = EnemyDirection::Right;
+    backgroundPosition          = simd_make_float4(0, 0, 0, 1);
+    gameStatus                  = GameStatus::Ongoing;
+    rumbleCountdownRemaining    = 0;
+    enemyMovedownRemaining      = 0;
+}
+
+void ScoreLayout::showHighScore()
+{
+    bannerCountdownSecs = 5.0f;
+    highScorePosition = simd_make_float4(0.0, canvasHeight * 0.5 * 0.9, 0, 1);
+}
+
+void ScoreLayout::showCurrentScore(size_t textLength)
+{
+    const float strWidth = (float)textLength * 1.0f;
+    const float leftSide = canvasWidth * -0.5f;
+    const float leftMargin = canvasWidth * 0.025f;
+    const float bottomSide = canvasHeight * -0.5f;
+    const float bottomMargin = leftMargin;
+    currentScorePosition = simd_make_float4(leftSide + leftMargin + strWidth*0.5f, bottomSide + bottomMargin, 0, 1);
+}
+
+void ScoreLayout::update(double targetTimestamp)
+{
+    if (lastTimestamp != 0.0)
+    {
+        double deltat = targetTimestamp - lastTimestamp;
+        bannerCountdownSecs = std::max(bannerCountdownSecs - deltat, 0.0);
+        if (bannerCountdownSecs <= 0.0 && highScorePosition.y < canvasHeight * 0.5 * 1.2)
+        {
+            highScorePosition.y += 1.f * deltat;
+        }
+    }
+    lastTimestamp = targetTimestamp;
+}
+
+GameLogic::GameLogic()
+: _rules()
+, _level(0)
+, _canvasWidth(10)
+, _canvasHeight(10)
+, _simulationMode(SimulationMode::Realtime)
+, _tickRate(60)
+, _timestep(60, kMaxTicksPerUpdate)
+, _pReferenceChecksums(nullptr)
+, _divergenceTick(-1)
+, _pInput(nullptr)
+{
+}
+
+void GameLogic::restart(const GameRules& rules, float startingScore)
+{
+    _rules = rules;
+    _rules.enemySpeed *= (1 + _level * 0.25f);
+
+    const uint32_t cols = _rules.enemyCols;
+    const uint32_t rows = _rules.enemyRows;
+
+    _gameState.reset();
+    _gameState.gameStatus = GameStatus::Ongoing;
+    _gameState.playerScore = startingScore;
+
+    const float canvasW = 10;
+    const float canvasH = canvasW * rules.screenHeight / (float)rules.screenWidth;
+    _canvasWidth = canvasW;
+    _canvasHeight = canvasH;
+    _gameState.playerPosition = simd_make_float4(0, -canvasH / 2 + kSpriteSize * 2, 0, 1);
+    spawnEnemies(canvasH);
+
+    // One sprite per cell over the canvas, with a sprite of margin for bullets leaving the top.
+    _broadphase.configureBounded(-canvasW / 2 - kSpriteSize, -canvasH / 2 - kSpriteSize,
+                                 canvasW / 2 + kSpriteSize, canvasH / 2 + kSpriteSize, kSpriteSize);
+    _collisionPairs.reserve(std::max<size_t>(_collisionPairs.capacity(), (size_t)_rules.maxPlayerBullets * 16));
+
+    if (_simulationMode == SimulationMode::Deterministic)
+    {
+        _simConfig = sim::makeConfig(canvasW, canvasH, kSpriteSize,
+                                     _rules.playerSpeed, kPlayerBulletSpeed, _rules.playerFireCooldownSecs,
+                                     _rules.enemySpeed, _rules.enemyMoveDownStep, _rules.explosionDurationSecs, kRumbleDurationSecs,
+                                     (uint8_t)rows, (uint8_t)cols, _rules.maxPlayerBullets, _rules.maxExplosions,
+                                     _tickRate);
+        sim::reset(_simState, _simConfig, (int32_t)startingScore);
+        _prevSimState = _simState;
+        _checksums.clear();
+        _timestep.setTickRate(_tickRate);
+        _timestep.reset();
+        _divergenceTick = -1;
+        _bulletEntities.clear();
+        _bulletIds.clear();
+        _explosionEntities.clear();
+        _explosionIds.clear();
+        publishDeterministicState(1.f);
+    }
+}
+
+void GameLogic::spawnEnemies(float canvasHeight)
+{
+    // Same grid as sim::reset, so enemy slot i of the fixed-point state is _enemyEntities[i].
+    const float spacing = kSpriteSize * 1.5f;
+    const uint8_t rows = _rules.enemyRows;
+    const uint8_t cols = _rules.enemyCols;
+
+    _enemyEntities.clear();
+    _gameState.enemies.reserve(rows * cols);
+    for (uint8_t row = 0; row < rows; ++row)
+    {
+        for (uint8_t col = 0; col < cols; ++col)
+        {
+            const float x = (col - (cols - 1) * 0.5f) * spacing;
+            const float y = canvasHeight * 0.5f - kSpriteSize * 2 - row * spacing;
+            _enemyEntities.push_back(_gameState.enemies.create(simd_make_float4(x, y, 0, 1)));
+        }
+    }
+}
+
+void GameLogic::setSimulationMode(SimulationMode mode, uint32_t tickRate)
+{
+    _simulationMode = mode;
+    _tickRate = std::max(tickRate, 1u);
+}
+
+void GameLogic::stepDeterministic(const PadState& pad)
+{
+    // Input is quantized before it enters the simulation; a replay feeds the same values back.
+    float moveX = pad.moveX;
+    bool fire = pad.fire;
+    if (_pInput)
+    {
+        _pInput->push(input::EventType::Pad, moveX, fire ? 1.f : 0.f);
+        _pInput->drain(_simState.tick, input::kPadEvents, [&](const input::Event& event)
+        {
+            moveX = event.values[0];
+            fire = event.values[1] != 0.f;
+        });
+    }
+    sim::TickInput tickInput;
+    tickInput.moveX = sim::Scalar::fromFloat(moveX);
+    tickInput.fire = fire;
+
+    _prevSimState = _simState;
+    sim::step(_simState, _simConfig, tickInput, _simScratch);
+    _checksums.record(_simState.tick, sim::checksum(_simState));
+
+    if (_pReferenceChecksums && _divergenceTick < 0 && _pReferenceChecksums->contains(_simState.tick)
+        && _pReferenceChecksums->at(_simState.tick) != _checksums.at(_simState.tick))
+    {
+        _divergenceTick = (int64_t)_simState.tick;
+        printf("Deterministic simulation diverged from reference at tick %lld\n", (long long)_divergenceTick);
+    }
+}
+
+void GameLogic::publishDeterministicState(float alpha)
+{
+    auto toFloat4 = [](const sim::Vec2& v)
+    {
+        return (simd_make_float4(v.x.toFloat(), v.y.toFloat(), 0, 1));
+    };
+    // Positions are shown alpha of the way from the previous tick to the current one. A bullet
+    // is only blended with the previous position of the same id; one fired this tick has none.
+    auto blend = [&](const sim::Vec2& previous, const sim::Vec2& current)
+    {
+        return (timing::interpolate(toFloat4(previous), toFloat4(current), alpha));
+    };
+
+    _gameState.playerPosition = blend(_prevSimState.playerPosition, _simState.playerPosition);
+    _gameState.playerFireCooldownRemaining = _simState.playerFireCooldownRemaining.toFloat();
+
+    // Enemies keep their entity for the whole game, bullets and explosions from spawn to death.
+    for (size_t i = 0; i < _enemyEntities.size() && i < _simState.enemyPositions.size(); ++i)
+    {
+        if (!_simState.enemyAlive[i])
+            _gameState.enemies.destroy(_enemyEntities[i]);
+        else if (_gameState.enemies.alive(_enemyEntities[i]))
+            _gameState.enemies.get<0>(_enemyEntities[i]) = blend(_prevSimState.enemyPositions[i], _simState.enemyPositions[i]);
+    }
+    // Bullet ids increase along both lists, so one forward walk pairs them up.
+    size_t previous = 0;
+    auto bulletPosition = [&](size_t slot)
+    {
+        const uint32_t id = _simState.playerBulletIds[slot];
+        while (previous < _prevSimState.playerBulletIds.size() && _prevSimState.playerBulletIds[previous] < id)
+            ++previous;
+        const sim::Vec2& bullet = _simState.playerBulletPositions[slot];
+        const bool matched = previous < _prevSimState.playerBulletIds.size() && _prevSimState.playerBulletIds[previous] == id;
+        return (matched ? blend(_prevSimState.playerBulletPositions[previous], bullet) : toFloat4(bullet));
+    };
+    sSyncEntities(_gameState.playerBullets, _bulletEntities, _bulletIds, _simState.playerBulletIds,
+                  [&](size_t slot) { return (_gameState.playerBullets.create(bulletPosition(slot))); },
+                  [&](ecs::Entity entity, size_t slot) { _gameState.playerBullets.get<0>(entity) = bulletPosition(slot); });
+    auto explosionPosition = [&](size_t slot) { return (toFloat4(_simState.explosionPositions[slot])); };
+    auto explosionRemaining = [&](size_t slot) { return (_simState.explosionCooldownsRemaining[slot].toFloat()); };
+    sSyncEntities(_gameState.explosions, _explosionEntities, _explosionIds, _simState.explosionIds,
+                  [&](size_t slot) { return (_gameState.explosions.create(explosionPosition(slot), explosionRemaining(slot))); },
+                  [&](ecs::Entity entity, size_t slot)
+                  {
+                      _gameState.explosions.get<0>(entity) = explosionPosition(slot);
+                      _gameState.explosions.get<1>(entity) = explosionRemaining(slot);
+                  });
+    _gameState.backgroundPosition = blend(_prevSimState.backgroundPosition, _simState.backgroundPosition);
+    _gameState.enemyMovedownRemaining = _simState.enemyMovedownRemaining.toFloat();
+    _gameState.rumbleCountdownRemaining = _simState.rumbleCountdownRemaining.toFloat();
+    _gameState.gameStatus = _simState.gameStatus;
+    _gameState.playerScore = _simState.playerScore;
+}
+
+const GameState& GameLogic::update(double targetTimestamp, const PadState& pad)
+{
+    _timings = LogicTimings();
+    if (_simulationMode == SimulationMode::Deterministic)
+    {
+        // Past kMaxTicksPerUpdate the backlog is dropped rather than spiralling; the simulation
+        // slows down but stays deterministic since it only ever sees whole ticks.
+        _timings.ticks = _timestep.update(targetTimestamp, [this, &pad](double)
+        {
+            stepDeterministic(pad);
+        });
+        _timings.ticksMs = _timestep.stats().simMsLastFrame;
+        const auto start = std::chrono::steady_clock::now();
+        publishDeterministicState(_timestep.alpha());
+        _timings.publishMs = sMsSince(start);
+    }
+    else
+    {
+        const auto start = std::chrono::steady_clock::now();
+        updateCollisions(_gameState);
+        _timings.collisionsMs = sMsSince(start);
+    }
+    return (_gameState);
+}
+
+void GameLogic::updateCollisions(GameState& state)
+{
+    if (state.playerBullets.empty() || state.enemies.empty())
+        return ;
+
+    // Positions are float4 columns: x at [0], y at [1], a stride of 4 floats.
+    const float* pEnemies = reinterpret_cast<const float*>(state.enemies.column<0>().data());
+    const float* pBullets = reinterpret_cast<const float*>(state.playerBullets.column<0>().data());
+    const size_t enemyCount = state.enemies.size();
+    const size_t bulletCount = state.playerBullets.size();
+
+    // Bullets cover a whole step per tick, more than a sprite at low tick rates, so both phases
+    // sweep them over the step instead of testing where they stand.
+    const float bulletStep = kPlayerBulletSpeed / (float)_tickRate;
+    _broadphase.build(pEnemies, pEnemies + 1, enemyCount, 4);
+    size_t pairCount = _broadphase.findSweptPairs(pBullets, pBullets + 1, bulletCount, 4, 0.f, bulletStep, _collisionPairs);
+    if (pairCount > _collisionPairs.capacity())
+    {
+        _collisionPairs.reserve(pairCount * 2);
+        pairCount = _broadphase.findSweptPairs(pBullets, pBullets + 1, bulletCount, 4, 0.f, bulletStep, _collisionPairs);
+    }
+
+    // Narrowphase in place: the candidates are compacted down to the hits, each with its time of
+    // impact.
+    const physics::Bodies2D bullets = { pBullets, pBullets + 1, 4, nullptr, nullptr, kSpriteSize * 0.5f, kSpriteSize * 0.5f,
+                                        nullptr, nullptr, 0.f, bulletStep };
+    const physics::Bodies2D enemies = { pEnemies, pEnemies + 1, 4, nullptr, nullptr, kSpriteSize * 0.5f, kSpriteSize * 0.5f,
+                                        nullptr, nullptr, 0.f, 0.f };
+    _collisionToi.resize(pairCount);
+    const size_t hitCount = physics::sweepAabbAabb(bullets, enemies, _collisionPairs.data(), pairCount,
+                                                   _collisionPairs.data(), _collisionToi.data());
+    if (!hitCount)
+        return ;
+
+    // A bullet takes out at most one enemy and an enemy dies at most once; hits are taken in
+    // time of impact order, so a bullet stops at the first enemy on its path.
+    _hitOrder.resize(hitCount);
+    for (uint32_t h = 0; h < hitCount; ++h)
+        _hitOrder[h] = h;
+    std::stable_sort(_hitOrder.begin(), _hitOrder.end(), [&](uint32_t a, uint32_t b) { return (_collisionToi[a] < _collisionToi[b]); });
+    _bulletHit.assign(bulletCount, 0);
+    _enemyHit.assign(enemyCount, 0);
+    uint32_t kills = 0;
+    for (uint32_t h : _hitOrder)
+    {
+        const physics::CandidatePair& hit = _collisionPairs[h];
+        const uint8_t fresh = !_bulletHit[hit.query] & !_enemyHit[hit.item];
+        _bulletHit[hit.query] |= fresh;
+        _enemyHit[hit.item] |= fresh;
+        kills += fresh;
+    }
+
+    // Hit response, one batch per effect. Explosions: make room for all the new ones at once by
+    // dropping those closest to finishing, then spawn one per killed enemy.
+    const size_t maxExplosions = _rules.maxExplosions;
+    const size_t spawned = std::min<size_t>(kills, maxExplosions);
+    if (state.explosions.size() + spawned > maxExplosions)
+    {
+        const size_t drop = state.explosions.size() + spawned - maxExplosions;
+        const auto remaining = state.explosions.column<1>();
+        _explosionOrder.resize(remaining.size());
+        for (uint32_t i = 0; i < _explosionOrder.size(); ++i)
+            _explosionOrder[i] = i;
+        std::nth_element(_explosionOrder.begin(), _explosionOrder.begin() + (drop - 1), _explosionOrder.end(),
+                         [&](uint32_t a, uint32_t b) { return (remaining[a] < remaining[b]); });
+        // Everything below the cutoff goes, and as many at the cutoff as are still needed.
+        const float cutoff = remaining[_explosionOrder[drop - 1]];
+        size_t ties = drop - (size_t)std::count_if(remaining.begin(), remaining.end(), [&](float r) { return (r < cutoff); });
+        state.explosions.removeIf([&](size_t i)
+        {
+            if (remaining[i] < cutoff)
+                return (true);
+            if (remaining[i] > cutoff || ties == 0)
+                return (false);
+            --ties;
+            return (true);
+        });
+    }
+    const auto enemyPositions = state.enemies.column<0>();
+    size_t spawnedSoFar = 0;
+    for (size_t e = 0; e < enemyCount && spawnedSoFar < spawned; ++e)
+    {
+        if (_enemyHit[e])
+        {
+            state.explosions.create(enemyPositions[e], _rules.explosionDurationSecs);
+            ++spawnedSoFar;
+        }
+    }
+    state.playerBullets.removeIf([&](size_t i) { return (_bulletHit[i] != 0); });
+    state.enemies.removeIf([&](size_t i) { return (_enemyHit[i] != 0); });
+
+    state.playerScore += kills * kPointsPerEnemy;
+    state.rumbleCountdownRemaining = kRumbleDurationSecs;
+    if (state.enemies.empty())
+        state.gameStatus = GameStatus::PlayerWon;
+}
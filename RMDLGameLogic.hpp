@@ -0,0 +1,188 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGameLogic.hpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 00:41:09      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLGAMELOGIC_HPP
+# define RMDLGAMELOGIC_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+# include "RMDLSimd.hpp"
+
+# include "NonCopyable.h"
+# include "RMDLBroadphase.hpp"
+# include "RMDLDeterministicSim.hpp"
+# include "RMDLEntityStore.hpp"
+# include "RMDLFixedTimestep.hpp"
+# include "RMDLInput.hpp"
+
+// The game without the renderer: nothing here touches Metal, metal-cpp or Objective-C, so the
+// simulation builds and runs on a machine without a GPU (see RMDLGameBenchmark.hpp).
+
+constexpr float kSpriteSize                  = 0.5f;
+constexpr float kRumbleDurationSecs          = 0.1f;
+constexpr float kRumbleIntensity             = 1.0f;
+constexpr float kPlayerBulletSpeed           = 8.0f;
+constexpr uint32_t kMaxTicksPerUpdate        = 8;
+
+/// The settings the simulation reads; GameConfig adds the render resources to them.
+struct GameRules
+{
+    uint32_t                                screenWidth;
+    uint32_t                                screenHeight;
+    uint8_t                                 enemyRows;
+    uint8_t                                 enemyCols;
+    float                                   enemySpeed;
+    float                                   enemyMoveDownStep;
+    float                                   playerSpeed;
+    float                                   playerFireCooldownSecs;
+    uint8_t                                 maxPlayerBullets;
+    uint8_t                                 maxExplosions;
+    float                                   explosionDurationSecs;
+};
+
+enum class SimulationMode
+{
+    Realtime,
+    Deterministic   // fixed-point sim::State advanced in fixed ticks, checksummed every tick
+};
+
+/// One archetype per entity kind. Positions are float4 so that a position column can be copied
+/// as is into the matching RenderData buffer.
+using EnemyStore     = ecs::Archetype<simd::float4>;            // position
+using BulletStore    = ecs::Archetype<simd::float4>;            // position
+using ExplosionStore = ecs::Archetype<simd::float4, float>;     // position, seconds remaining
+
+struct GameState
+{
+    EnemyStore                  enemies;
+    BulletStore                 playerBullets;
+    ExplosionStore              explosions;
+    float                       playerFireCooldownRemaining;
+    simd::float4                playerPosition;
+    // EnemyDirection              currentEnemyDirection;
+    simd::float4                backgroundPosition;
+
+    GameStatus                  gameStatus;
+    float                       rumbleCountdownRemaining;
+    float                       enemyMovedownRemaining;
+    void                        reset();
+    int                         playerScore;
+};
+
+/// Controller state for a frame, as polled; quantized when it enters a deterministic tick.
+struct PadState
+{
+    float       moveX = 0.f;    // -1 (left) to 1 (right)
+    bool        fire = false;
+};
+
+/// Where the time of the last update() went.
+struct LogicTimings
+{
+    uint32_t    ticks = 0;
+    double      ticksMs = 0.0;          // deterministic ticks, fixed-point collisions included
+    double      publishMs = 0.0;        // fixed-point state to GameState
+    double      collisionsMs = 0.0;     // Realtime mode only
+};
+
+/// Where the score texts sit on the UI canvas. The high score shows for a few seconds after
+/// showHighScore(), then scrolls off the top.
+struct ScoreLayout
+{
+    simd::float4    highScorePosition = simd_make_float4(0, 0, 0, 1);
+    simd::float4    currentScorePosition = simd_make_float4(0, 0, 0, 1);
+    float           canvasWidth = 0.f;
+    float           canvasHeight = 0.f;
+    double          lastTimestamp = 0.0;
+    double          bannerCountdownSecs = 0.0;
+
+    void    showHighScore();
+    void    showCurrentScore(size_t textLength);
+    void    update(double targetTimestamp);
+};
+
+class GameLogic : public NonCopyable
+{
+public:
+    GameLogic();
+
+    void             restart(const GameRules& rules, float startingScore);
+    const GameState& update(double targetTimestamp, const PadState& pad);
+    const GameState& state() const { return (_gameState); }
+
+    /// The float collision pass of Realtime mode over any state: bullets against enemies, hits
+    /// scored and turned into explosions.
+    void             updateCollisions(GameState& state);
+
+    float            canvasWidth() const { return (_canvasWidth); }
+    float            canvasHeight() const { return (_canvasHeight); }
+    const LogicTimings& lastTimings() const { return (_timings); }
+
+    /// Takes effect at the next restart(). In Deterministic mode update() runs whole ticks of
+    /// 1 / tickRate seconds; wall-clock time only decides how many ticks to run, and the returned
+    /// positions are interpolated between the last two ticks.
+    void             setSimulationMode(SimulationMode mode, uint32_t tickRate = 60);
+    SimulationMode   simulationMode() const { return (_simulationMode); }
+
+    /// Ticks per frame and time spent simulating; setTimeScale(> 1) runs faster than real time.
+    const timing::TimestepStats& timestepStats() const { return (_timestep.stats()); }
+    void             setTimeScale(double scale) { _timestep.setTimeScale(scale); }
+
+    /// Checksums of every tick since the last restart, and an optional reference run to compare
+    /// against as ticks are simulated. divergenceTick() is -1 until a tick mismatches.
+    const sim::ChecksumStream& checksums() const { return (_checksums); }
+    void             setReferenceChecksums(const sim::ChecksumStream* pReference) { _pReferenceChecksums = pReference; }
+    int64_t          divergenceTick() const { return (_divergenceTick); }
+
+    /// When set, each deterministic tick pushes the polled pad state into the stream and
+    /// simulates the pad sample drained back for that tick, which is the recorded one on replay.
+    void             setInputStream(input::InputStream* pInput) { _pInput = pInput; }
+
+private:
+    void spawnEnemies(float canvasHeight);
+    void stepDeterministic(const PadState& pad);
+    void publishDeterministicState(float alpha);
+
+    GameRules      _rules;
+    GameState      _gameState;
+    uint32_t       _level;
+    float          _canvasWidth;
+    float          _canvasHeight;
+    LogicTimings   _timings;
+
+    SimulationMode              _simulationMode;
+    uint32_t                    _tickRate;
+    timing::FixedTimestep       _timestep;
+    sim::Config                 _simConfig;
+    sim::State                  _simState;
+    sim::State                  _prevSimState;  // one tick behind _simState, for interpolation
+    sim::StepScratch            _simScratch;
+    std::vector<ecs::Entity>    _enemyEntities; // per sim::State enemy slot
+    std::vector<ecs::Entity>    _bulletEntities;    // per sim::State bullet slot, as last published
+    std::vector<uint32_t>       _bulletIds;         // sim id each of _bulletEntities stands for
+    std::vector<ecs::Entity>    _explosionEntities; // per sim::State explosion slot, as last published
+    std::vector<uint32_t>       _explosionIds;
+
+    physics::UniformGrid                _broadphase;        // enemies, rebuilt every collision pass
+    std::vector<physics::CandidatePair> _collisionPairs;    // bullet / enemy, preallocated
+    std::vector<float>                  _collisionToi;      // per hit, fraction of the tick
+    std::vector<uint32_t>               _hitOrder;
+    std::vector<uint8_t>                _bulletHit;
+    std::vector<uint8_t>                _enemyHit;
+    std::vector<uint32_t>               _explosionOrder;
+    sim::ChecksumStream         _checksums;
+    const sim::ChecksumStream*  _pReferenceChecksums;
+    int64_t                     _divergenceTick;
+    input::InputStream*         _pInput;
+};
+
+#endif /* RMDLGAMELOGIC_HPP */
@@ -0,0 +1,314 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLInput.cpp                +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:58:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLInput.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    constexpr char      kMagic[4] = { 'R', 'M', 'D', 'I' };
+    constexpr uint16_t  kVersion = 1;
+    constexpr uint8_t   kValueCounts[(size_t)input::EventType::Count] = { 3, 2, 2 };
+
+    uint64_t sNowNs()
+    {
+        return ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Deltas may be negative: two consumers drain on clocks of their own.
+    uint64_t sZigzag(int64_t value)
+    {
+        return (((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    int64_t sUnzigzag(uint64_t value)
+    {
+        return ((int64_t)(value >> 1) ^ -(int64_t)(value & 1));
+    }
+
+    size_t sPutVarint(uint8_t* pOut, uint64_t value)
+    {
+        size_t size = 0;
+        while (value >= 0x80)
+        {
+            pOut[size++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        pOut[size++] = (uint8_t)value;
+        return (size);
+    }
+
+    bool sGetVarint(FILE* pFile, uint64_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            const int byte = fgetc(pFile);
+            if (byte == EOF)
+                return (false);
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return (true);
+        }
+        return (false);
+    }
+}
+
+namespace input
+{
+    InputRecorder::~InputRecorder()
+    {
+        close();
+    }
+
+    bool InputRecorder::open(const char* pPath, uint32_t seed)
+    {
+        close();
+        _pFile = fopen(pPath, "wb");
+        if (!_pFile)
+            return (false);
+        _prevTick = 0;
+        _prevTimeUs = 0;
+        _events = 0;
+        _failed = false;
+
+        uint8_t header[12];
+        memcpy(header, kMagic, 4);
+        memcpy(header + 4, &kVersion, 2);
+        memset(header + 6, 0, 2);
+        memcpy(header + 8, &seed, 4);
+        _failed = fwrite(header, sizeof(header), 1, _pFile) != 1;
+        return (!_failed);
+    }
+
+    bool InputRecorder::close()
+    {
+        if (!_pFile)
+            return (true);
+        const bool ok = fclose(_pFile) == 0 && !_failed;
+        _pFile = nullptr;
+        return (ok);
+    }
+
+    void InputRecorder::write(const Event& event)
+    {
+        if (!_pFile)
+            return;
+        // Microseconds are plenty to compare sessions and keep most time deltas to 2 or 3 bytes.
+        const uint64_t timeUs = event.timeNs / 1000;
+        uint8_t record[1 + 10 + 10 + sizeof(event.values)];
+        size_t size = 0;
+        record[size++] = (uint8_t)event.type;
+        size += sPutVarint(record + size, sZigzag((int64_t)(event.tick - _prevTick)));
+        size += sPutVarint(record + size, sZigzag((int64_t)(timeUs - _prevTimeUs)));
+        const size_t valueBytes = kValueCounts[(size_t)event.type] * sizeof(float);
+        memcpy(record + size, event.values, valueBytes);
+        size += valueBytes;
+
+        _failed |= fwrite(record, size, 1, _pFile) != 1;
+        _prevTick = event.tick;
+        _prevTimeUs = timeUs;
+        ++_events;
+    }
+
+    bool InputPlayer::open(const char* pPath)
+    {
+        _events.clear();
+        _cursors.fill(0);
+
+        FILE* pFile = fopen(pPath, "rb");
+        if (!pFile)
+            return (false);
+        uint8_t header[12];
+        uint16_t version = 0;
+        if (fread(header, sizeof(header), 1, pFile) != 1 || memcmp(header, kMagic, 4) != 0)
+        {
+            fclose(pFile);
+            return (false);
+        }
+        memcpy(&version, header + 4, 2);
+        memcpy(&_seed, header + 8, 4);
+        if (version != kVersion)
+        {
+            fclose(pFile);
+            return (false);
+        }
+
+        uint64_t tick = 0;
+        uint64_t timeUs = 0;
+        bool ok = true;
+        int type;
+        while ((type = fgetc(pFile)) != EOF)
+        {
+            uint64_t tickDelta;
+            uint64_t timeDelta;
+            Event event;
+            if (type >= (int)EventType::Count || !sGetVarint(pFile, tickDelta) || !sGetVarint(pFile, timeDelta))
+            {
+                ok = false;
+                break;
+            }
+            tick += (uint64_t)sUnzigzag(tickDelta);
+            timeUs += (uint64_t)sUnzigzag(timeDelta);
+            event.type = (EventType)type;
+            event.tick = tick;
+            event.timeNs = timeUs * 1000;
+            const size_t valueCount = kValueCounts[type];
+            if (fread(event.values, sizeof(float), valueCount, pFile) != valueCount)
+            {
+                ok = false;
+                break;
+            }
+            _events.push_back(event);
+        }
+        fclose(pFile);
+        for (size_t t = 0; t < _cursors.size(); ++t)
+        {
+            _cursors[t] = (size_t)-1;
+            advance(t);
+        }
+        return (ok);
+    }
+
+    size_t InputPlayer::eventCount() const
+    {
+        return (_events.size());
+    }
+
+    bool InputPlayer::finished() const
+    {
+        for (size_t cursor : _cursors)
+        {
+            if (cursor < _events.size())
+                return (false);
+        }
+        return (true);
+    }
+
+    void InputPlayer::advance(size_t type)
+    {
+        size_t& cursor = _cursors[type];
+        do
+            ++cursor;
+        while (cursor < _events.size() && (size_t)_events[cursor].type != type);
+    }
+
+    void InputPlayer::take(uint64_t tick, uint32_t types, std::vector<Event>& out)
+    {
+        // Merges the types back into recorded order: the earliest due event first, each time.
+        for (;;)
+        {
+            size_t next = _events.size();
+            size_t nextType = 0;
+            for (size_t type = 0; type < _cursors.size(); ++type)
+            {
+                const size_t cursor = _cursors[type];
+                if ((types & (1u << type)) && cursor < next && _events[cursor].tick <= tick)
+                {
+                    next = cursor;
+                    nextType = type;
+                }
+            }
+            if (next == _events.size())
+                return;
+            out.push_back(_events[next]);
+            advance(nextType);
+        }
+    }
+
+    InputStream::InputStream()
+        : _startNs(sNowNs())
+    {
+        _tickBases.fill(UINT64_MAX);
+    }
+
+    void InputStream::push(EventType type, float x, float y, float z)
+    {
+        assert(type < EventType::Count);
+        Event event;
+        event.timeNs = sNowNs() - _startNs;
+        event.type = type;
+        event.values[0] = x;
+        event.values[1] = y;
+        event.values[2] = z;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_pPlayer && !_pPlayer->finished())
+            return;
+        _pending.push_back(event);
+    }
+
+    void InputStream::collect(uint64_t tick, uint32_t types, std::vector<Event>& out)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Ticks count from the first drain of the types since a recorder or player was attached,
+        // so a session replays the same whenever it was started.
+        uint64_t base = UINT64_MAX;
+        for (size_t type = 0; type < _tickBases.size(); ++type)
+        {
+            if (!(types & (1u << type)))
+                continue;
+            if (_tickBases[type] == UINT64_MAX)
+                _tickBases[type] = tick;
+            base = std::min(base, _tickBases[type]);
+        }
+        assert(base <= tick);
+        tick -= base;
+
+        if (_pPlayer && !_pPlayer->finished())
+            _pPlayer->take(tick, types, out);
+        else
+        {
+            // Other types stay queued, in order, for their own consumer.
+            auto kept = std::stable_partition(_pending.begin(), _pending.end(), [types](const Event& event)
+            {
+                return (!(types & typeMask(event.type)));
+            });
+            for (auto it = kept; it != _pending.end(); ++it)
+            {
+                it->tick = tick;
+                out.push_back(*it);
+            }
+            _pending.erase(kept, _pending.end());
+        }
+
+        if (_pRecorder)
+        {
+            for (const Event& event : out)
+                _pRecorder->write(event);
+        }
+    }
+
+    void InputStream::setRecorder(InputRecorder* pRecorder)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pRecorder = pRecorder;
+        _tickBases.fill(UINT64_MAX);
+    }
+
+    void InputStream::setPlayer(InputPlayer* pPlayer)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pPlayer = pPlayer;
+        _pending.clear();
+        _tickBases.fill(UINT64_MAX);
+    }
+
+    bool InputStream::replaying() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return (_pPlayer && !_pPlayer->finished());
+    }
+}
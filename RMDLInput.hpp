@@ -0,0 +1,138 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLInput.hpp                +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:58:41      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLINPUT_HPP
+# define RMDLINPUT_HPP
+
+# include <array>
+# include <cstddef>
+# include <cstdint>
+# include <cstdio>
+# include <mutex>
+# include <vector>
+
+# include "NonCopyable.h"
+
+/// Every input the game reacts to goes through an InputStream: window events and controller polls
+/// are pushed as timestamped events, and the simulation drains them at fixed ticks. Replaying a
+/// recorded stream thus feeds the same events to the same ticks, whatever the frame rate, so two
+/// builds run the same session and their frame times can be compared.
+namespace input
+{
+    enum class EventType : uint8_t
+    {
+        CameraMove,     // x, y, z translation
+        CameraRotate,   // yaw, pitch
+        Pad,            // moveX in [-1, 1], fire 0 or 1; one per simulation tick
+        Count
+    };
+
+    constexpr uint32_t typeMask(EventType type)
+    {
+        return (1u << (uint32_t)type);
+    }
+
+    constexpr uint32_t kCameraEvents = typeMask(EventType::CameraMove) | typeMask(EventType::CameraRotate);
+    constexpr uint32_t kPadEvents = typeMask(EventType::Pad);
+
+    struct Event
+    {
+        uint64_t    tick = 0;       // set when drained, from the first drain of its type
+        uint64_t    timeNs = 0;     // since the stream was created, set when pushed
+        EventType   type = EventType::CameraMove;
+        float       values[3] = {};
+    };
+
+    /// Writes drained events to a file: a header with the session seed, then one record per
+    /// event, ticks and times as variable-length deltas from the previous record. A camera move
+    /// takes about 16 bytes, a pad sample about 12.
+    class InputRecorder : public NonCopyable
+    {
+    public:
+        ~InputRecorder();
+
+        bool        open(const char* pPath, uint32_t seed);
+        bool        close();
+        bool        isOpen() const { return (_pFile != nullptr); }
+        void        write(const Event& event);
+        uint64_t    eventCount() const { return (_events); }
+
+    private:
+        FILE*       _pFile = nullptr;
+        uint64_t    _prevTick = 0;
+        uint64_t    _prevTimeUs = 0;
+        uint64_t    _events = 0;
+        bool        _failed = false;
+    };
+
+    /// A recording read back whole, handed out tick by tick.
+    class InputPlayer : public NonCopyable
+    {
+    public:
+        bool        open(const char* pPath);
+        uint32_t    seed() const { return (_seed); }
+        size_t      eventCount() const;
+        bool        finished() const;
+
+        /// Appends the recorded events of the given types up to tick, each once, in the order
+        /// they were recorded.
+        void        take(uint64_t tick, uint32_t types, std::vector<Event>& out);
+
+    private:
+        void        advance(size_t type);
+
+        std::vector<Event>                              _events;        // in recorded order
+        std::array<size_t, (size_t)EventType::Count>    _cursors{};     // next event of each type
+        uint32_t                                        _seed = 0;
+    };
+
+    class InputStream : public NonCopyable
+    {
+    public:
+        InputStream();
+
+        /// From any thread. Ignored while a recording plays, so a replay cannot be disturbed.
+        void        push(EventType type, float x, float y = 0.f, float z = 0.f);
+
+        /// Calls fn(const Event&) for the events of the given types pushed since the last drain
+        /// of those types, or recorded for tick when replaying, and records them. Each consumer
+        /// drains its own types once per tick of its own clock.
+        template <typename Fn>
+        size_t      drain(uint64_t tick, uint32_t types, Fn&& fn);
+
+        /// Both stay attached until detached, and must outlive the stream or the detach. Live
+        /// input is accepted again once the player is finished.
+        void        setRecorder(InputRecorder* pRecorder);
+        void        setPlayer(InputPlayer* pPlayer);
+        bool        replaying() const;
+
+    private:
+        void        collect(uint64_t tick, uint32_t types, std::vector<Event>& out);
+
+        mutable std::mutex  _mutex;
+        uint64_t            _startNs;
+        std::vector<Event>  _pending;
+        std::array<uint64_t, (size_t)EventType::Count>  _tickBases;     // consumer tick of tick 0
+        InputRecorder*      _pRecorder = nullptr;
+        InputPlayer*        _pPlayer = nullptr;
+    };
+
+    template <typename Fn>
+    size_t InputStream::drain(uint64_t tick, uint32_t types, Fn&& fn)
+    {
+        std::vector<Event> events;
+        collect(tick, types, events);
+        for (const Event& event : events)
+            fn(event);
+        return (events.size());
+    }
+}
+
+#endif /* RMDLINPUT_HPP */
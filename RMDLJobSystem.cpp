@@ -0,0 +1,601 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLJobSystem.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 22:41:24      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLJobSystem.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    constexpr uint32_t kSpinRounds = 64;        // empty searches before a worker sleeps
+    constexpr size_t kChunksPerThread = 8;      // default parallelFor grain: count / (8 threads)
+    constexpr size_t kHistogramBuckets = 128;
+
+    struct CurrentWorker
+    {
+        const jobs::JobSystem*  pSystem;
+        unsigned                index;
+    };
+    thread_local CurrentWorker tCurrentWorker = { nullptr, 0 };
+
+    uint64_t sNowNs()
+    {
+        return ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Two buckets per power of two: the top bit's position and the bit below it.
+    size_t sLatencyBucket(uint64_t ns)
+    {
+        if (ns < 2)
+            return ((size_t)ns);
+        const unsigned top = (unsigned)std::bit_width(ns) - 1;
+        return (std::min<size_t>(2 * top + ((ns >> (top - 1)) & 1), kHistogramBuckets - 1));
+    }
+
+    double sBucketUpperNs(size_t bucket)
+    {
+        if (bucket < 2)
+            return ((double)bucket + 1.0);
+        const double power = std::ldexp(1.0, (int)(bucket / 2));
+        return (bucket & 1 ? 2.0 * power : 1.5 * power);
+    }
+
+    void sAtomicMax(std::atomic<uint64_t>& target, uint64_t value)
+    {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            ;
+    }
+}
+
+namespace jobs
+{
+    WorkStealingDeque::WorkStealingDeque(size_t capacity)
+    {
+        const size_t size = std::bit_ceil(std::max<size_t>(capacity, 2));
+        _buffer = std::make_unique<std::atomic<Job*>[]>(size);
+        _mask = (int64_t)size - 1;
+    }
+
+    bool WorkStealingDeque::push(Job* pJob)
+    {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        const int64_t top = _top.load(std::memory_order_acquire);
+        if (bottom - top > _mask)
+            return (false);
+        _buffer[bottom & _mask].store(pJob, std::memory_order_relaxed);
+        // Publishes the job and everything written to it to the thread that steals it.
+        _bottom.store(bottom + 1, std::memory_order_release);
+        return (true);
+    }
+
+    Job* WorkStealingDeque::pop()
+    {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return (nullptr);
+        }
+        Job* pJob = _buffer[bottom & _mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last job: race the thieves for it.
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                pJob = nullptr;
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return (pJob);
+    }
+
+    Job* WorkStealingDeque::steal()
+    {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return (nullptr);
+        Job* pJob = _buffer[top & _mask].load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return (nullptr);
+        return (pJob);
+    }
+
+    bool WorkStealingDeque::empty() const
+    {
+        return (_bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed));
+    }
+
+    JobSystem::JobSystem(unsigned threadCount)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        const unsigned workers = threadCount - 1;
+        _slots = std::make_unique<Slot[]>(workers + 1);
+        for (unsigned i = 0; i < workers; ++i)
+            _deques.push_back(std::make_unique<WorkStealingDeque>());
+        // Every deque exists before any worker can try to steal from it.
+        for (unsigned i = 0; i < workers; ++i)
+            _threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _stop.store(true);
+        }
+        _wake.notify_all();
+        for (std::thread& thread : _threads)
+            thread.join();
+    }
+
+    JobSystem& JobSystem::shared()
+    {
+        static JobSystem system;
+        return (system);
+    }
+
+    unsigned JobSystem::currentWorker() const
+    {
+        return (tCurrentWorker.pSystem == this ? tCurrentWorker.index : (unsigned)_deques.size());
+    }
+
+    void JobSystem::submit(Job* pJobs, size_t count, Counter& counter)
+    {
+        if (count == 0)
+            return;
+        counter._pending.fetch_add((uint32_t)count, std::memory_order_acq_rel);
+        for (size_t i = 0; i < count; ++i)
+            pJobs[i].pCounter = &counter;
+        enqueue(pJobs, count);
+    }
+
+    void JobSystem::submitAfter(Counter& dependency, Job* pJobs, size_t count, Counter& counter)
+    {
+        if (count == 0)
+            return;
+        counter._pending.fetch_add((uint32_t)count, std::memory_order_acq_rel);
+        for (size_t i = 0; i < count; ++i)
+            pJobs[i].pCounter = &counter;
+        {
+            // The last job of dependency decrements under this lock, so it either sees these
+            // jobs in the list or they see it done.
+            std::lock_guard<std::mutex> lock(dependency._mutex);
+            if (dependency._pending.load(std::memory_order_acquire) != 0)
+            {
+                dependency._continuations.push_back(Counter::Continuation{ pJobs, count });
+                return;
+            }
+        }
+        enqueue(pJobs, count);
+    }
+
+    bool JobSystem::helpOnce()
+    {
+        const unsigned worker = currentWorker();
+        Job* pJob = findJob(worker);
+        if (!pJob)
+            return (false);
+        execute(pJob, worker);
+        return (true);
+    }
+
+    void JobSystem::wait(Counter& counter)
+    {
+        uint32_t idle = 0;
+        while (counter._pending.load(std::memory_order_acquire) != 0)
+        {
+            if (helpOnce())
+                idle = 0;
+            else if (++idle > kSpinRounds)
+                std::this_thread::yield();
+        }
+        // The thread that finished the last job may still be unlocking; the caller is free to
+        // destroy the counter once this returns.
+        std::lock_guard<std::mutex> lock(counter._mutex);
+    }
+
+    void JobSystem::enqueue(Job* pJobs, size_t count)
+    {
+        const uint64_t now = sNowNs();
+        const unsigned worker = currentWorker();
+        // Counted before they are visible, so a worker deciding to sleep cannot miss them.
+        _queued.fetch_add((int64_t)count, std::memory_order_seq_cst);
+
+        size_t injected = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            pJobs[i].queuedNs = now;
+            if (worker < _deques.size() && _deques[worker]->push(&pJobs[i]))
+                continue;
+            // From outside the system, or a full deque.
+            std::lock_guard<std::mutex> lock(_injectionMutex);
+            _injection.push_back(&pJobs[i]);
+            _injectionPending.fetch_add(1, std::memory_order_release);
+            ++injected;
+        }
+        if (injected)
+            _slots[worker].injected.fetch_add(injected, std::memory_order_relaxed);
+
+        if (_sleepers.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            if (count == 1)
+                _wake.notify_one();
+            else
+                _wake.notify_all();
+        }
+    }
+
+    Job* JobSystem::findJob(unsigned worker)
+    {
+        const unsigned deques = (unsigned)_deques.size();
+        Job* pJob = nullptr;
+        if (worker < deques)
+            pJob = _deques[worker]->pop();
+
+        if (!pJob && _injectionPending.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> lock(_injectionMutex);
+            if (_injectionHead < _injection.size())
+            {
+                pJob = _injection[_injectionHead++];
+                _injectionPending.fetch_sub(1, std::memory_order_relaxed);
+                if (_injectionHead == _injection.size())
+                {
+                    _injection.clear();
+                    _injectionHead = 0;
+                }
+            }
+        }
+
+        // Steal, starting from the next worker so thieves spread out.
+        for (unsigned k = 1; !pJob && k <= deques; ++k)
+        {
+            const unsigned victim = (worker + k) % deques;
+            if (victim == worker)
+                continue;
+            pJob = _deques[victim]->steal();
+            if (pJob)
+                _slots[worker].steals.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (pJob)
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+        return (pJob);
+    }
+
+    void JobSystem::execute(Job* pJob, unsigned worker)
+    {
+        Slot& slot = _slots[worker];
+        const uint64_t latency = sNowNs() - pJob->queuedNs;
+        slot.jobs.fetch_add(1, std::memory_order_relaxed);
+        slot.latencyNs.fetch_add(latency, std::memory_order_relaxed);
+        slot.histogram[sLatencyBucket(latency)].fetch_add(1, std::memory_order_relaxed);
+        sAtomicMax(slot.latencyMaxNs, latency);
+
+        Counter& counter = *pJob->pCounter;
+        pJob->pFunction(*pJob);
+        finish(counter);
+    }
+
+    void JobSystem::finish(Counter& counter)
+    {
+        uint32_t pending = counter._pending.load(std::memory_order_relaxed);
+        while (pending > 1)
+        {
+            if (counter._pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return;
+        }
+
+        // Possibly the last job: decrement under the lock, so submitAfter() and wait() see the
+        // continuations and the counter consistently, then leave the counter alone.
+        std::vector<Counter::Continuation> ready;
+        {
+            std::lock_guard<std::mutex> lock(counter._mutex);
+            if (counter._pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ready.swap(counter._continuations);
+        }
+        for (const Counter::Continuation& continuation : ready)
+            enqueue(continuation.pJobs, continuation.count);
+    }
+
+    bool JobSystem::localQueueEmpty() const
+    {
+        const unsigned worker = currentWorker();
+        if (worker < _deques.size())
+            return (_deques[worker]->empty());
+        return (_injectionPending.load(std::memory_order_relaxed) == 0);
+    }
+
+    void JobSystem::workerLoop(unsigned index)
+    {
+        tCurrentWorker = CurrentWorker{ this, index };
+        uint32_t idle = 0;
+        while (!_stop.load(std::memory_order_relaxed))
+        {
+            if (Job* pJob = findJob(index))
+            {
+                execute(pJob, index);
+                idle = 0;
+                continue;
+            }
+            if (++idle < kSpinRounds)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleepers.fetch_add(1, std::memory_order_seq_cst);
+            _slots[index].sleeps.fetch_add(1, std::memory_order_relaxed);
+            _wake.wait(lock, [this]() { return (_stop.load() || _queued.load(std::memory_order_seq_cst) > 0); });
+            _sleepers.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    void JobSystem::parallelForRanges(size_t count, size_t grain, unsigned maxThreads,
+                                      void (*pBody)(void* pFn, size_t begin, size_t end), void* pFn)
+    {
+        if (count == 0)
+            return;
+        const unsigned threads = maxThreads == 0 ? threadCount() : std::min(maxThreads, threadCount());
+        if (grain == 0)
+            grain = std::max<size_t>(1, count / (threads * kChunksPerThread));
+        if (threads == 1 || count <= grain)
+        {
+            pBody(pFn, 0, count);
+            return;
+        }
+
+        if (threads < threadCount())
+        {
+            // A fixed crew instead of splitting: halves pushed for thieves would reach every worker.
+            struct Crew
+            {
+                void                (*pBody)(void* pFn, size_t begin, size_t end);
+                void*               pFn;
+                size_t              count;
+                size_t              grain;
+                std::atomic<size_t> next;
+
+                static void run(Crew& crew)
+                {
+                    for (;;)
+                    {
+                        const size_t begin = crew.next.fetch_add(crew.grain, std::memory_order_relaxed);
+                        if (begin >= crew.count)
+                            return;
+                        crew.pBody(crew.pFn, begin, std::min(begin + crew.grain, crew.count));
+                    }
+                }
+            };
+
+            Crew crew;
+            crew.pBody = pBody;
+            crew.pFn = pFn;
+            crew.count = count;
+            crew.grain = grain;
+            crew.next.store(0, std::memory_order_relaxed);
+            std::vector<Job> crewJobs(threads - 1);
+            for (Job& job : crewJobs)
+            {
+                job.pFunction = [](const Job& self) { Crew::run(*(Crew*)self.pContext); };
+                job.pContext = &crew;
+            }
+            Counter counter;
+            submit(crewJobs.data(), crewJobs.size(), counter);
+            Crew::run(crew);
+            wait(counter);
+            return;
+        }
+
+        struct Ranges
+        {
+            JobSystem*          pSystem;
+            void                (*pBody)(void* pFn, size_t begin, size_t end);
+            void*               pFn;
+            size_t              grain;
+            std::vector<Job>    jobs;       // every split is a job; halves > grain / 2 bound them
+            std::atomic<size_t> nextJob;
+            Counter             counter;
+
+            static void run(Ranges& ranges, size_t begin, size_t end)
+            {
+                while (end - begin > ranges.grain)
+                {
+                    if (!ranges.pSystem->localQueueEmpty())
+                    {
+                        // Work is already waiting for thieves: keep going without splitting.
+                        ranges.pBody(ranges.pFn, begin, begin + ranges.grain);
+                        begin += ranges.grain;
+                        continue;
+                    }
+                    const size_t slot = ranges.nextJob.fetch_add(1, std::memory_order_relaxed);
+                    if (slot >= ranges.jobs.size())
+                        break;
+                    const size_t middle = begin + (end - begin) / 2;
+                    Job& job = ranges.jobs[slot];
+                    job.pFunction = [](const Job& self) { run(*(Ranges*)self.pContext, self.begin, self.end); };
+                    job.pContext = &ranges;
+                    job.begin = middle;
+                    job.end = end;
+                    ranges.pSystem->submit(&job, 1, ranges.counter);
+                    end = middle;
+                }
+                ranges.pBody(ranges.pFn, begin, end);
+            }
+        };
+
+        Ranges ranges;
+        ranges.pSystem = this;
+        ranges.pBody = pBody;
+        ranges.pFn = pFn;
+        ranges.grain = grain;
+        ranges.jobs.resize(2 * ((count + grain - 1) / grain) + 2);
+        ranges.nextJob.store(0, std::memory_order_relaxed);
+        Ranges::run(ranges, 0, count);
+        wait(ranges.counter);
+    }
+
+    SchedulerStats JobSystem::stats() const
+    {
+        SchedulerStats stats;
+        uint64_t histogram[kHistogramBuckets] = {};
+        uint64_t latencyNs = 0;
+        uint64_t latencyMaxNs = 0;
+        for (size_t s = 0; s <= _deques.size(); ++s)
+        {
+            const Slot& slot = _slots[s];
+            stats.jobs += slot.jobs.load(std::memory_order_relaxed);
+            stats.steals += slot.steals.load(std::memory_order_relaxed);
+            stats.injected += slot.injected.load(std::memory_order_relaxed);
+            stats.sleeps += slot.sleeps.load(std::memory_order_relaxed);
+            latencyNs += slot.latencyNs.load(std::memory_order_relaxed);
+            latencyMaxNs = std::max(latencyMaxNs, slot.latencyMaxNs.load(std::memory_order_relaxed));
+            for (size_t b = 0; b < kHistogramBuckets; ++b)
+                histogram[b] += slot.histogram[b].load(std::memory_order_relaxed);
+        }
+        if (stats.jobs == 0)
+            return (stats);
+
+        auto percentile = [&](double fraction)
+        {
+            const uint64_t rank = (uint64_t)std::ceil(fraction * (double)stats.jobs);
+            uint64_t seen = 0;
+            for (size_t b = 0; b < kHistogramBuckets; ++b)
+            {
+                seen += histogram[b];
+                if (seen >= rank)
+                    return (sBucketUpperNs(b) * 1e-3);
+            }
+            return (sBucketUpperNs(kHistogramBuckets - 1) * 1e-3);
+        };
+        stats.latencyMeanUs = (double)latencyNs / (double)stats.jobs * 1e-3;
+        stats.latencyP50Us = percentile(0.5);
+        stats.latencyP99Us = percentile(0.99);
+        stats.latencyMaxUs = (double)latencyMaxNs * 1e-3;
+        return (stats);
+    }
+
+    void JobSystem::resetStats()
+    {
+        for (size_t s = 0; s <= _deques.size(); ++s)
+        {
+            Slot& slot = _slots[s];
+            slot.jobs.store(0, std::memory_order_relaxed);
+            slot.steals.store(0, std::memory_order_relaxed);
+            slot.injected.store(0, std::memory_order_relaxed);
+            slot.sleeps.store(0, std::memory_order_relaxed);
+            slot.latencyNs.store(0, std::memory_order_relaxed);
+            slot.latencyMaxNs.store(0, std::memory_order_relaxed);
+            for (size_t b = 0; b < kHistogramBuckets; ++b)
+                slot.histogram[b].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void benchmarkJobSystem(FILE* out, size_t items, uint32_t passes)
+    {
+        using Clock = std::chrono::steady_clock;
+        std::vector<float> data(items);
+        // Uneven work: 1 to 64 rounds per item, scattered so that no chunk is typical.
+        auto work = [&](size_t i)
+        {
+            const uint32_t rounds = 1 + (((uint32_t)i * 2654435761u) >> 26);
+            float x = (float)i;
+            for (uint32_t r = 0; r < rounds; ++r)
+                x = x * 0.999f + 0.5f;
+            data[i] = x;
+        };
+
+        const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        fprintf(out, "parallelFor over %zu uneven items, %u passes\n", items, passes);
+        double singleMs = 0.0;
+        for (unsigned threads = 1; ; threads = std::min(threads * 2, maxThreads))
+        {
+            JobSystem system(threads);
+            system.parallelFor(items, work);
+            system.resetStats();
+            const auto start = Clock::now();
+            for (uint32_t p = 0; p < passes; ++p)
+                system.parallelFor(items, work);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / passes;
+            if (threads == 1)
+                singleMs = ms;
+            const SchedulerStats stats = system.stats();
+            fprintf(out, "  %2u threads: %8.3f ms, speedup %5.2fx, %6.1f jobs and %6.1f steals per pass,"
+                    " latency p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                    threads, ms, singleMs / ms, (double)stats.jobs / passes, (double)stats.steals / passes,
+                    stats.latencyP50Us, stats.latencyP99Us, stats.latencyMaxUs);
+            if (threads == maxThreads)
+                break;
+        }
+
+        // Fan-out of small jobs, then one job that depends on all of them.
+        constexpr size_t kFanOut = 4096;
+        const size_t span = std::max<size_t>(1, items / kFanOut);
+        struct FanOut
+        {
+            float*              pData;
+            std::atomic<size_t> finished;
+        };
+        FanOut fanOut;
+        fanOut.pData = data.data();
+        size_t seenByLast = 0;
+        auto last = [&]() { seenByLast = fanOut.finished.load(std::memory_order_relaxed); };
+        JobSystem system(maxThreads);
+        std::vector<Job> fan(kFanOut);
+
+        bool ordered = true;
+        system.resetStats();
+        const auto start = Clock::now();
+        for (uint32_t p = 0; p < passes; ++p)
+        {
+            fanOut.finished.store(0, std::memory_order_relaxed);
+            for (size_t j = 0; j < kFanOut; ++j)
+            {
+                fan[j].pFunction = [](const Job& job)
+                {
+                    FanOut& fanOut = *(FanOut*)job.pContext;
+                    float sum = 0.f;
+                    for (size_t i = job.begin; i < job.end; ++i)
+                        sum += fanOut.pData[i];
+                    if (job.begin < job.end)
+                        fanOut.pData[job.begin] = sum;
+                    fanOut.finished.fetch_add(1, std::memory_order_relaxed);
+                };
+                fan[j].pContext = &fanOut;
+                fan[j].begin = std::min(items, j * span);
+                fan[j].end = std::min(items, (j + 1) * span);
+            }
+            Job after = makeJob(last);
+            Counter fanned;
+            Counter done;
+            system.submit(fan.data(), kFanOut, fanned);
+            system.submitAfter(fanned, &after, 1, done);
+            system.wait(done);
+            ordered = ordered && seenByLast == kFanOut;
+        }
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / passes;
+        const SchedulerStats stats = system.stats();
+        fprintf(out, "%zu jobs then 1 dependent, %u threads: %.1f us per batch (%.3f us per job),"
+                " latency p50 %.1f us, p99 %.1f us; dependency %s\n",
+                kFanOut, maxThreads, us, us / (kFanOut + 1), stats.latencyP50Us, stats.latencyP99Us,
+                ordered ? "held" : "BROKEN");
+    }
+}
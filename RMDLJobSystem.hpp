@@ -0,0 +1,210 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLJobSystem.hpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 22:41:17      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLJOBSYSTEM_HPP
+# define RMDLJOBSYSTEM_HPP
+
+# include <atomic>
+# include <condition_variable>
+# include <cstddef>
+# include <cstdint>
+# include <cstdio>
+# include <memory>
+# include <mutex>
+# include <thread>
+# include <type_traits>
+# include <vector>
+
+# include "NonCopyable.h"
+
+namespace jobs
+{
+    class Counter;
+
+    /// A unit of work: pFunction(job), with pContext, begin and end for it to read. The job system
+    /// only holds a pointer, so the Job must stay alive until its counter is done.
+    struct Job
+    {
+        void        (*pFunction)(const Job& job) = nullptr;
+        void*       pContext = nullptr;
+        size_t      begin = 0;
+        size_t      end = 0;
+        Counter*    pCounter = nullptr;     // set by submit
+        uint64_t    queuedNs = 0;           // set by submit, for the latency stats
+    };
+
+    /// A job calling fn(), which must outlive it.
+    template <typename Fn>
+    Job makeJob(Fn& fn)
+    {
+        Job job;
+        job.pFunction = [](const Job& self) { (*(Fn*)self.pContext)(); };
+        job.pContext = (void*)&fn;
+        return (job);
+    }
+
+    /// Jobs left to finish from every submit made with it. Jobs submitted after a counter run
+    /// once it reaches zero, which is how dependencies are expressed. A counter can be reused
+    /// once done, and must outlive the jobs counted on it and the wait on it.
+    class Counter : public NonCopyable
+    {
+    public:
+        uint32_t    pending() const { return (_pending.load(std::memory_order_acquire)); }
+
+    private:
+        friend class JobSystem;
+
+        struct Continuation
+        {
+            Job*    pJobs;
+            size_t  count;
+        };
+
+        std::atomic<uint32_t>       _pending{0};
+        std::mutex                  _mutex;         // taken for the last decrement only
+        std::vector<Continuation>   _continuations;
+    };
+
+    /// Scheduling latency is the time from submit to a thread starting the job. Percentiles come
+    /// from a histogram with buckets a factor of sqrt(2) apart.
+    struct SchedulerStats
+    {
+        uint64_t    jobs = 0;
+        uint64_t    steals = 0;         // jobs taken from another worker's deque
+        uint64_t    injected = 0;       // jobs submitted from threads outside the system
+        uint64_t    sleeps = 0;         // times a worker ran out of work and blocked
+        double      latencyMeanUs = 0.0;
+        double      latencyP50Us = 0.0;
+        double      latencyP99Us = 0.0;
+        double      latencyMaxUs = 0.0;
+    };
+
+    /// Chase-Lev work-stealing deque of job pointers, fixed capacity. The owning thread pushes
+    /// and pops at the bottom, so it runs its newest, cache-warm work first; other threads steal
+    /// the oldest, usually largest, work from the top.
+    class WorkStealingDeque : public NonCopyable
+    {
+    public:
+        explicit WorkStealingDeque(size_t capacity = 4096);     // rounded up to a power of two
+
+        bool    push(Job* pJob);        // owner only; false when full
+        Job*    pop();                  // owner only
+        Job*    steal();                // any thread; nullptr when empty or lost a race
+        bool    empty() const;
+
+    private:
+        alignas(64) std::atomic<int64_t>        _top{0};
+        alignas(64) std::atomic<int64_t>        _bottom{0};
+        std::unique_ptr<std::atomic<Job*>[]>    _buffer;
+        int64_t                                 _mask;
+    };
+
+    /// Worker threads, one work-stealing deque each.
+    ///
+    /// Jobs submitted from a worker go to its own deque; jobs submitted from any other thread go
+    /// to a shared injection queue. An idle worker pops its own deque, then the injection queue,
+    /// then steals from the others in turn, and after a short spin sleeps until work is
+    /// submitted. wait() never blocks while work is queued: the waiting thread, worker or not,
+    /// runs queued jobs until the counter is done, so jobs may submit and wait on other jobs.
+    class JobSystem : public NonCopyable
+    {
+    public:
+        /// threadCount counts the thread that waits, so threadCount - 1 workers are started;
+        /// 0 means one thread per hardware thread.
+        explicit JobSystem(unsigned threadCount = 0);
+        ~JobSystem();
+
+        /// Created on first use with one thread per hardware thread.
+        static JobSystem&   shared();
+
+        unsigned    threadCount() const { return ((unsigned)_deques.size() + 1); }
+
+        void        submit(Job* pJobs, size_t count, Counter& counter);
+        /// Counts the jobs on counter now, queues them once dependency is done.
+        void        submitAfter(Counter& dependency, Job* pJobs, size_t count, Counter& counter);
+        void        wait(Counter& counter);
+        /// Runs one queued job on the calling thread, for waits on something other than a
+        /// counter. Returns false when there was none.
+        bool        helpOnce();
+
+        /// Calls fn(i) for every i in [0, count) and returns when all are done.
+        ///
+        /// The range is split in halves, a half pushed for thieves and the other half kept, down
+        /// to grain indices, but only while the thread's own queue is empty: once a pushed half
+        /// is waiting to be stolen, the thread works through its range grain by grain instead.
+        /// Busy machines thus get few large jobs and idle ones many small ones. grain 0 picks
+        /// count / (8 threads).
+        ///
+        /// maxThreads, when not 0, caps the threads working on the range, the caller included:
+        /// 1 runs it all on the caller, in order, and below threadCount() maxThreads - 1 jobs and
+        /// the caller take grains from a shared cursor, whichever threads run the jobs.
+        template <typename Fn>
+        void        parallelFor(size_t count, Fn&& fn, size_t grain = 0, unsigned maxThreads = 0);
+
+        SchedulerStats  stats() const;
+        void            resetStats();
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t>   jobs{0};
+            std::atomic<uint64_t>   steals{0};
+            std::atomic<uint64_t>   injected{0};
+            std::atomic<uint64_t>   sleeps{0};
+            std::atomic<uint64_t>   latencyNs{0};
+            std::atomic<uint64_t>   latencyMaxNs{0};
+            std::atomic<uint64_t>   histogram[128];
+        };
+
+        unsigned    currentWorker() const;     // workers count, for other threads
+        void        workerLoop(unsigned index);
+        void        enqueue(Job* pJobs, size_t count);
+        Job*        findJob(unsigned worker);
+        void        execute(Job* pJob, unsigned worker);
+        void        finish(Counter& counter);
+        bool        localQueueEmpty() const;
+        void        parallelForRanges(size_t count, size_t grain, unsigned maxThreads,
+                                      void (*pBody)(void* pFn, size_t begin, size_t end), void* pFn);
+
+        std::vector<std::unique_ptr<WorkStealingDeque>> _deques;
+        std::vector<std::thread>                        _threads;
+        std::unique_ptr<Slot[]>                         _slots;     // per worker, then one shared by other threads
+
+        std::mutex                  _injectionMutex;
+        std::vector<Job*>           _injection;
+        size_t                      _injectionHead = 0;
+        std::atomic<size_t>         _injectionPending{0};   // read without the lock
+
+        std::atomic<int64_t>        _queued{0};     // submitted and not yet taken
+        std::atomic<uint32_t>       _sleepers{0};
+        std::mutex                  _sleepMutex;
+        std::condition_variable     _wake;
+        std::atomic<bool>           _stop{false};
+    };
+
+    template <typename Fn>
+    void JobSystem::parallelFor(size_t count, Fn&& fn, size_t grain, unsigned maxThreads)
+    {
+        using Body = std::remove_reference_t<Fn>;
+        parallelForRanges(count, grain, maxThreads, [](void* pFn, size_t begin, size_t end)
+        {
+            Body& body = *(Body*)pFn;
+            for (size_t i = begin; i < end; ++i)
+                body(i);
+        }, (void*)&fn);
+    }
+
+    /// Runs parallelFor over uneven work on 1, 2, 4, ... threads and prints the time per pass,
+    /// the speedup over one thread and the scheduler stats, then the same for fan-out of small
+    /// jobs with a dependent job after them. Needs no GPU; runs on any platform.
+    void    benchmarkJobSystem(FILE* out, size_t items = 1 << 20, uint32_t passes = 40);
+}
+
+#endif /* RMDLJOBSYSTEM_HPP */
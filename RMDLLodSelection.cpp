@@ -0,0 +1,164 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLLodSelection.cpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 18:41:10      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLLodSelection.hpp"
+
+#include "RMDLCamera.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr uint8_t kNoLevel = 0xFF;
+
+    simd_float8 sLoad(const float* p, size_t lanes)
+    {
+        simd_float8 v = {};
+        memcpy(&v, p, lanes * sizeof(float));
+        return (v);
+    }
+
+    // scale turns a world-space error into pixels at this instance's distance.
+    uint8_t sSelectLevel(const culling::LodMesh& mesh, float scale, float threshold, float hysteresis, uint8_t previous)
+    {
+        const uint32_t count = std::clamp(mesh.levelCount, 1u, culling::kMaxLodLevels);
+        uint32_t target = 0;
+        while (target + 1 < count && mesh.geometricError[target + 1] * scale <= threshold)
+            ++target;
+        if (previous == kNoLevel || previous >= count || target == previous)
+            return ((uint8_t)target);
+
+        uint32_t level = previous;
+        if (target > previous)
+        {
+            while (level + 1 < count && mesh.geometricError[level + 1] * scale <= threshold * (1.f - hysteresis))
+                ++level;
+        }
+        else if (mesh.geometricError[previous] * scale > threshold * (1.f + hysteresis))
+            level = target;
+        return ((uint8_t)level);
+    }
+}
+
+namespace culling
+{
+    LodSelector::LodSelector(const LodSettings& settings)
+    : _settings(settings)
+    , _bias(1.f)
+    , _stats()
+    {
+        _settings.chunkSize = std::max<size_t>(8, (_settings.chunkSize + 7) / 8 * 8);
+    }
+
+    void LodSelector::reset()
+    {
+        std::fill(_levels.begin(), _levels.end(), kNoLevel);
+        _bias = 1.f;
+    }
+
+    void LodSelector::select(RMDLCamera& camera, float viewportHeight, const SphereSoA& spheres,
+                             const uint32_t* pMeshIndices, const LodMesh* pMeshes)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const Frustum frustum = Frustum::fromCamera(camera);
+        const bool perspective = camera.isPerspective();
+        const simd::float3 eye = camera.position();
+        const float nearZ = std::max(camera.nearPlane(), 1e-4f);
+        const float pixelScale = perspective ? viewportHeight / (2.f * tanf(camera.viewAngle() * 0.5f))
+                                             : viewportHeight / camera.width();
+        const float threshold = _settings.pixelError * _bias;
+        const float hysteresis = _settings.hysteresis;
+        const size_t chunkSize = _settings.chunkSize;
+        const size_t chunkCount = (spheres.count + chunkSize - 1) / chunkSize;
+
+        if (_levels.size() != spheres.count)
+            _levels.assign(spheres.count, kNoLevel);
+        for (uint32_t level = 0; level < kMaxLodLevels; ++level)
+            _chunkLists[level].resize(spheres.count);
+        _chunkCounts.assign(chunkCount * kMaxLodLevels, 0);
+        _chunkTriangles.assign(chunkCount, 0);
+
+        parallel::parallelFor(chunkCount, [&](size_t chunk)
+        {
+            const size_t begin = chunk * chunkSize;
+            const size_t end = std::min(begin + chunkSize, spheres.count);
+            uint32_t* pCounts = _chunkCounts.data() + chunk * kMaxLodLevels;
+            uint64_t triangles = 0;
+
+            for (size_t base = begin; base < end; base += 8)
+            {
+                const size_t lanes = std::min<size_t>(8, end - base);
+                const simd_int8 visible = visibleMask(frustum, spheres, base, lanes);
+                if (!simd_any(visible))
+                {
+                    memset(_levels.data() + base, kNoLevel, lanes);
+                    continue;
+                }
+                const simd_float8 dx = sLoad(spheres.pCenterX + base, lanes) - eye.x;
+                const simd_float8 dy = sLoad(spheres.pCenterY + base, lanes) - eye.y;
+                const simd_float8 dz = sLoad(spheres.pCenterZ + base, lanes) - eye.z;
+                const simd_float8 distanceSq = dx * dx + dy * dy + dz * dz;
+
+                for (size_t lane = 0; lane < lanes; ++lane)
+                {
+                    const size_t i = base + lane;
+                    if (!visible[lane])
+                    {
+                        _levels[i] = kNoLevel;
+                        continue;
+                    }
+                    const LodMesh& mesh = pMeshes[pMeshIndices[i]];
+                    float scale = pixelScale;
+                    if (perspective)
+                        scale /= std::max(sqrtf(distanceSq[lane]) - spheres.pRadius[i], nearZ);
+                    const uint8_t level = sSelectLevel(mesh, scale, threshold, hysteresis, _levels[i]);
+                    _levels[i] = level;
+                    _chunkLists[level][begin + pCounts[level]++] = (uint32_t)i;
+                    triangles += mesh.triangleCount[level];
+                }
+            }
+            _chunkTriangles[chunk] = triangles;
+        }, _settings.threadCount);
+
+        // Close up each level's per-chunk ranges, in chunk order so the lists stay sorted.
+        uint64_t triangles = 0;
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            triangles += _chunkTriangles[chunk];
+        _stats.visible = 0;
+        for (uint32_t level = 0; level < kMaxLodLevels; ++level)
+        {
+            std::vector<uint32_t>& list = _drawLists[level];
+            list.clear();
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                const uint32_t* pFirst = _chunkLists[level].data() + chunk * chunkSize;
+                list.insert(list.end(), pFirst, pFirst + _chunkCounts[chunk * kMaxLodLevels + level]);
+            }
+            _stats.perLevel[level] = list.size();
+            _stats.visible += list.size();
+        }
+
+        _stats.total = spheres.count;
+        _stats.triangles = triangles;
+        _stats.bias = _bias;
+        if (_settings.triangleBudget != 0)
+        {
+            if (triangles > _settings.triangleBudget)
+                _bias = std::min(_bias * _settings.biasStep, _settings.maxBias);
+            else if (triangles < _settings.triangleBudget * 9 / 10)
+                _bias = std::max(_bias / _settings.biasStep, 1.f);
+        }
+        _stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
@@ -0,0 +1,101 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLLodSelection.hpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 18:41:03      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLLODSELECTION_HPP
+# define RMDLLODSELECTION_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+# include "RMDLFrustumCulling.hpp"
+
+class RMDLCamera;
+
+namespace culling
+{
+    constexpr uint32_t kMaxLodLevels = 8;
+
+    /// Levels of detail of one mesh, finest first. geometricError is how far, in world units, a
+    /// level may deviate from the full mesh (0 for level 0) and must not decrease with the level.
+    struct LodMesh
+    {
+        uint32_t    levelCount;
+        float       geometricError[kMaxLodLevels];
+        uint32_t    triangleCount[kMaxLodLevels];
+    };
+
+    struct LodSettings
+    {
+        float       pixelError = 1.f;       // largest acceptable projected error, in pixels
+        float       hysteresis = 0.25f;     // a level changes only once the error is this far past the threshold
+        uint64_t    triangleBudget = 0;     // 0: no budget
+        float       biasStep = 1.25f;       // threshold scale applied per frame while over or well under budget
+        float       maxBias = 16.f;
+        size_t      chunkSize = 4096;
+        unsigned    threadCount = 0;
+    };
+
+    struct LodStats
+    {
+        uint64_t    total;
+        uint64_t    visible;
+        uint64_t    triangles;
+        uint64_t    perLevel[kMaxLodLevels];
+        float       bias;           // the threshold scale used this frame
+        double      milliseconds;
+    };
+
+    /// Frustum culling and level-of-detail selection in one data-parallel pass.
+    ///
+    /// Instances are bounding spheres, as for FrustumCuller, each with the index of its LodMesh.
+    /// Visible instances get the coarsest level whose error, projected at the sphere's nearest
+    /// distance, stays under pixelError: error * viewportHeight / (2 * tan(viewAngle / 2) * distance)
+    /// for perspective cameras, error * viewportHeight / width for parallel ones.
+    ///
+    /// Hysteresis: the level chosen last frame (kept per instance index) is left for a coarser one
+    /// only when that one's error is under (1 - hysteresis) of the threshold, and for a finer one
+    /// only when its own error exceeds (1 + hysteresis) of it, so instances hovering around a
+    /// switching distance do not flip every frame.
+    ///
+    /// Triangle budget: when a frame's selection exceeds triangleBudget, the threshold is scaled up
+    /// by biasStep for the next frame (up to maxBias), and back down while the selection stays under
+    /// 90% of the budget, so a crowded view degrades evenly rather than dropping frames.
+    class LodSelector
+    {
+    public:
+        explicit LodSelector(const LodSettings& settings = LodSettings());
+
+        /// pMeshIndices[i] is the LodMesh of sphere i. Fills one draw list per level.
+        void    select(RMDLCamera& camera, float viewportHeight, const SphereSoA& spheres,
+                       const uint32_t* pMeshIndices, const LodMesh* pMeshes);
+
+        /// Instance indices drawn at level, in increasing order.
+        const std::vector<uint32_t>&    drawList(uint32_t level) const { return (_drawLists[level]); }
+        const LodStats&                 stats() const { return (_stats); }
+        float                           bias() const { return (_bias); }
+
+        /// Forgets the levels of last frame, e.g. after a camera cut.
+        void    reset();
+
+    private:
+        LodSettings             _settings;
+        float                   _bias;
+        std::vector<uint8_t>    _levels;    // per instance, last selection
+        std::vector<uint32_t>   _chunkLists[kMaxLodLevels];
+        std::vector<uint32_t>   _chunkCounts;   // per chunk and level
+        std::vector<uint64_t>   _chunkTriangles;
+        std::vector<uint32_t>   _drawLists[kMaxLodLevels];
+        LodStats                _stats;
+    };
+}
+
+#endif /* RMDLLODSELECTION_HPP */
@@ -11,7 +11,11 @@
 #ifndef RMDLMAIN_RENDERER_SHARED_H
 # define RMDLMAIN_RENDERER_SHARED_H
 
-# import <simd/simd.h>
+# ifdef __METAL_VERSION__
+#  include <simd/simd.h>
+# else
+#  include "RMDLSimd.hpp"
+# endif
 
 # define GAME_TIME 1.1f
 
@@ -9,6 +9,20 @@
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "RMDLMathUtils.hpp"
+#include "RMDLCamera.hpp"
+
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#if defined(__F16C__)
+# include <immintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
 
 namespace math
 {
@@ -19,36 +33,17 @@ namespace math
 
     simd::float4x4 makeIdentity()
     {
-        using simd::float4;
-        return (simd_float4x4) {
-            (float4) { 1.f, 0.f, 0.f, 0.f },
-            (float4) { 0.f, 1.f, 0.f, 0.f },
-            (float4) { 0.f, 0.f, 1.f, 0.f },
-            (float4) { 0.f, 0.f, 0.f, 1.f } };
+        return cx::makeIdentity();
     }
 
     simd::float4x4 makeOrtho(float left, float right, float top, float bottom, float near, float far)
     {
-        using simd::float4;
-        simd_float4x4 m = (simd_float4x4) {
-            (float4) { 2.f/(right - left), 0.f, 0.f, 0.f }, // col 0
-            (float4) { 0.f, 2.f/(top - bottom), 0.f, 0.f }, // col 1
-            (float4) { 0.f, 0.f, -2.f/(far - near), 0.f },  // col 2
-            (float4) { -(right+left)/(right-left), -(top+bottom)/(top-bottom), -(far+near)/(far-near), 1.f } // col 3
-        };
-        return m;
+        return cx::makeOrtho(left, right, top, bottom, near, far);
     }
 
     simd::float4x4 makePerspective(float fovRadians, float aspect, float znear, float zfar)
     {
-        using simd::float4;
-        float ys = 1.f / tanf(fovRadians * 0.5f);
-        float xs = ys / aspect;
-        float zs = zfar / (znear - zfar);
-        return simd_matrix_from_rows((float4) { xs, 0.0f, 0.0f, 0.0f },
-                                    (float4) { 0.0f, ys, 0.0f, 0.0f },
-                                    (float4) { 0.0f, 0.0f, zs, znear * zs },
-                                    (float4) { 0, 0, -1, 0 });
+        return cx::makePerspective(fovRadians, aspect, znear, zfar);
     }
 
     simd::float4x4 makeXRotate(float angleRadians)
@@ -73,31 +68,17 @@ namespace math
 
     simd::float4x4 makeZRotate(float angleRadians)
     {
-        using simd::float4;
-        const float a = angleRadians;
-        return simd_matrix_from_rows((float4) { cosf(a), sinf(a), 0.0f, 0.0f },
-                                    (float4) { -sinf(a), cosf(a), 0.0f, 0.0f },
-                                    (float4) { 0.0f, 0.0f, 1.0f, 0.0f },
-                                    (float4) { 0.0f, 0.0f, 0.0f, 1.0f });
+        return cx::makeZRotate(angleRadians);
     }
 
     simd::float4x4 makeTranslate(const simd::float3& v)
     {
-        using simd::float4;
-        const float4 col0 = { 1.0f, 0.0f, 0.0f, 0.0f };
-        const float4 col1 = { 0.0f, 1.0f, 0.0f, 0.0f };
-        const float4 col2 = { 0.0f, 0.0f, 1.0f, 0.0f };
-        const float4 col3 = { v.x, v.y, v.z, 1.0f };
-        return simd_matrix(col0, col1, col2, col3);
+        return cx::makeTranslate(v.x, v.y, v.z);
     }
 
     simd::float4x4 makeScale(const simd::float3& v)
     {
-        using simd::float4;
-        return simd_matrix((float4) { v.x, 0, 0, 0 },
-                        (float4) { 0, v.y, 0, 0 },
-                        (float4) { 0, 0, v.z, 0 },
-                        (float4) { 0, 0, 0, 1.0 });
+        return cx::makeScale(v.x, v.y, v.z);
     }
 
     simd::float3x3 discardTranslationP( const simd::float4x4& m )
@@ -111,8 +92,63 @@ namespace math
     }
 }
 
+// The runtime constructors above forward to math::cx, so checking the constexpr
+// results here checks the values the runtime versions produce as well.
+namespace
+{
+    namespace cx = math::cx;
+
+    constexpr bool sNearlyEqual(float a, float b, float eps = 1e-6f)
+    {
+        return (cx::abs((double)a - (double)b) <= eps);
+    }
+
+    static_assert(cx::sqrt(4.f) == 2.f && cx::sqrt(0.25f) == 0.5f && cx::sqrt(0.f) == 0.f, "cx::sqrt");
+    static_assert(sNearlyEqual(cx::sqrt(2.f), 1.41421356f), "cx::sqrt");
+    static_assert(sNearlyEqual(cx::sin(cx::kPi / 6), 0.5f) && sNearlyEqual(cx::sin(-cx::kPi / 2), -1.f), "cx::sin");
+    static_assert(cx::cos(0.f) == 1.f && sNearlyEqual(cx::cos(cx::kPi / 3), 0.5f) && sNearlyEqual(cx::cos(7 * cx::kPi), -1.f), "cx::cos");
+    static_assert(sNearlyEqual(cx::tan(cx::kPi / 4), 1.f), "cx::tan");
+
+    constexpr cx::Matrix4 kIdentity = cx::makeIdentity();
+    static_assert(kIdentity.columns[0][0] == 1.f && kIdentity.columns[1][1] == 1.f &&
+                  kIdentity.columns[2][2] == 1.f && kIdentity.columns[3][3] == 1.f &&
+                  kIdentity.columns[3][0] == 0.f && kIdentity.columns[0][3] == 0.f, "cx::makeIdentity");
+
+    constexpr cx::Matrix4 kTranslate = cx::makeTranslate(1.f, 2.f, 3.f);
+    static_assert(kTranslate.columns[3][0] == 1.f && kTranslate.columns[3][1] == 2.f &&
+                  kTranslate.columns[3][2] == 3.f && kTranslate.columns[3][3] == 1.f, "cx::makeTranslate");
+
+    constexpr cx::Matrix4 kScale = cx::makeScale(2.f, 3.f, 4.f);
+    static_assert(kScale.columns[0][0] == 2.f && kScale.columns[1][1] == 3.f &&
+                  kScale.columns[2][2] == 4.f && kScale.columns[3][3] == 1.f, "cx::makeScale");
+
+    // The game canvas projection: 10 units wide, y up, z in [-1, 1].
+    constexpr cx::Matrix4 kOrtho = cx::makeOrtho(-5.f, 5.f, 3.f, -3.f, -1.f, 1.f);
+    static_assert(kOrtho.columns[0][0] == 2.f / 10.f && kOrtho.columns[1][1] == 2.f / 6.f &&
+                  kOrtho.columns[2][2] == -1.f && kOrtho.columns[3][0] == 0.f &&
+                  kOrtho.columns[3][1] == 0.f && kOrtho.columns[3][2] == 0.f, "cx::makeOrtho");
+
+    // matrix_make_rows takes rows and stores columns.
+    constexpr cx::Matrix4 kRows = cx::matrix_make_rows(1, 2, 3, 4,
+                                                   5, 6, 7, 8,
+                                                   9, 10, 11, 12,
+                                                   13, 14, 15, 16);
+    static_assert(kRows.columns[0][1] == 5 && kRows.columns[1][0] == 2 && kRows.columns[3][2] == 12, "cx::matrix_make_rows");
+
+    constexpr cx::Matrix4 kPerspective = cx::makePerspective((float)(cx::kPi / 2), 2.f, 1.f, 3.f);
+    static_assert(sNearlyEqual(kPerspective.columns[1][1], 1.f) && sNearlyEqual(kPerspective.columns[0][0], 0.5f) &&
+                  kPerspective.columns[2][3] == -1.f && kPerspective.columns[3][2] == -1.5f, "cx::makePerspective");
+
+    constexpr cx::Matrix4 kRotate = cx::makeZRotate((float)(cx::kPi / 2));
+    static_assert(sNearlyEqual(kRotate.columns[0][0], 0.f) && sNearlyEqual(kRotate.columns[1][0], 1.f), "cx::makeZRotate");
+
+    constexpr cx::Quaternion kQuat = cx::quaternion_from_axis_angle(0.f, 0.f, 1.f, (float)cx::kPi);
+    static_assert(cx::quaternion_identity().w == 1.f && sNearlyEqual(kQuat.z, 1.f) && sNearlyEqual(kQuat.w, 0.f), "cx::quaternion");
+}
+
 uint32_t seed_lo, seed_hi;
 
+#if defined(__clang__) || defined(__ARM_FP16_FORMAT_IEEE)
 static float inline F16ToF32(const __fp16 *address) {
     return *address;
 }
@@ -130,6 +166,130 @@ uint16_t AAPL_SIMD_OVERLOAD float16_from_float32(float f) {
     F32ToF16(f, (__fp16 *)&f16);
     return f16;
 }
+#else
+// No __fp16 storage type (GCC on x86): go through the batch converters below.
+float AAPL_SIMD_OVERLOAD float32_from_float16(uint16_t i) {
+    float f;
+    float32_from_float16(&f, &i, 1);
+    return f;
+}
+
+uint16_t AAPL_SIMD_OVERLOAD float16_from_float32(float f) {
+    uint16_t f16;
+    float16_from_float32(&f16, &f, 1);
+    return f16;
+}
+#endif
+
+// Scalar float -> half with round-to-nearest-even. Matches vcvtps2ph / fcvtn bit for bit,
+// including subnormals, overflow to infinity and NaN payloads.
+static inline uint16_t sHalfBitsFromFloat(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t absx = x & 0x7FFFFFFFu;
+    uint32_t h;
+
+    if (absx > 0x7F800000u)         // NaN: keep the top payload bits, force quiet
+        h = 0x7E00u | ((absx >> 13) & 0x3FFu);
+    else if (absx >= 0x47800000u)   // >= 65536 or infinity
+        h = 0x7C00u;
+    else if (absx < 0x38800000u)    // half subnormal or zero: let the FPU round
+    {
+        const uint32_t magicBits = (127 - 15 + 23 - 10 + 1) << 23;
+        float magic, v;
+        memcpy(&magic, &magicBits, sizeof(magic));
+        memcpy(&v, &absx, sizeof(v));
+        v += magic;
+        memcpy(&h, &v, sizeof(h));
+        h -= magicBits;
+    }
+    else
+    {
+        const uint32_t mantOdd = (absx >> 13) & 1u;
+        absx += ((uint32_t)(15 - 127) << 23) + 0xFFFu + mantOdd;
+        h = absx >> 13;             // a carry out of the mantissa rounds up to infinity
+    }
+    return (uint16_t)(sign | h);
+}
+
+static inline float sFloatFromHalfBits(uint16_t h) {
+    const uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1Fu;
+    const uint32_t mantissa = h & 0x3FFu;
+    uint32_t x;
+
+    if (exponent == 0x1Fu)          // infinity, or NaN made quiet as the hardware does
+        x = sign | 0x7F800000u | (mantissa ? 0x400000u | (mantissa << 13) : 0u);
+    else if (exponent != 0)
+        x = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    else
+    {
+        float v = (float)mantissa * (1.0f / 16777216.0f); // exact, mantissa * 2^-24
+        memcpy(&x, &v, sizeof(x));
+        x |= sign;
+    }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+void AAPL_SIMD_OVERLOAD float16_from_float32(uint16_t* pDst, const float* pSrc, size_t count) {
+    size_t i = 0;
+#if defined(__F16C__)
+# if defined(__AVX__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(pSrc + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *)(pDst + i), h);
+    }
+# endif
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i h = _mm_cvtps_ph(_mm_loadu_ps(pSrc + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storel_epi64((__m128i *)(pDst + i), h);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        float16x8_t h = vcombine_f16(vcvt_f16_f32(vld1q_f32(pSrc + i)), vcvt_f16_f32(vld1q_f32(pSrc + i + 4)));
+        vst1q_u16(pDst + i, vreinterpretq_u16_f16(h));
+    }
+    for (; i + 4 <= count; i += 4)
+        vst1_u16(pDst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(pSrc + i))));
+#endif
+    for (; i < count; ++i)
+        pDst[i] = sHalfBitsFromFloat(pSrc[i]);
+}
+
+void AAPL_SIMD_OVERLOAD float32_from_float16(float* pDst, const uint16_t* pSrc, size_t count) {
+    size_t i = 0;
+#if defined(__F16C__)
+# if defined(__AVX__)
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(pDst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(pSrc + i))));
+# endif
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(pDst + i, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(pSrc + i))));
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        float16x8_t h = vreinterpretq_f16_u16(vld1q_u16(pSrc + i));
+        vst1q_f32(pDst + i, vcvt_f32_f16(vget_low_f16(h)));
+        vst1q_f32(pDst + i + 4, vcvt_f32_f16(vget_high_f16(h)));
+    }
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(pDst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(pSrc + i))));
+#endif
+    for (; i < count; ++i)
+        pDst[i] = sFloatFromHalfBits(pSrc[i]);
+}
+
+void AAPL_SIMD_OVERLOAD half4_from_float4(uint16_t* pDst, const vector_float4* pSrc, size_t count) {
+    // vector_float4 is 16 bytes with no padding, so the stream is a plain float array.
+    static_assert(sizeof(vector_float4) == 4 * sizeof(float), "vector_float4 must be tightly packed");
+    float16_from_float32(pDst, (const float *)pSrc, count * 4);
+}
 
 vector_float3 AAPL_SIMD_OVERLOAD generate_random_vector(float min, float max)
 {
@@ -187,10 +347,9 @@ matrix_float3x3 AAPL_SIMD_OVERLOAD matrix_make_rows(
                                    float m00, float m10, float m20,
                                    float m01, float m11, float m21,
                                    float m02, float m12, float m22) {
-    return (matrix_float3x3){ {
-            { m00, m01, m02 },      // each line here provides column data
-            { m10, m11, m12 },
-            { m20, m21, m22 } } };
+    return math::cx::matrix_make_rows(m00, m10, m20,
+                                      m01, m11, m21,
+                                      m02, m12, m22);
 }
 
 matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_make_rows(
@@ -198,11 +357,10 @@ matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_make_rows(
                                    float m01, float m11, float m21, float m31,
                                    float m02, float m12, float m22, float m32,
                                    float m03, float m13, float m23, float m33) {
-    return (matrix_float4x4){ {
-        { m00, m01, m02, m03 },     // each line here provides column data
-        { m10, m11, m12, m13 },
-        { m20, m21, m22, m23 },
-        { m30, m31, m32, m33 } } };
+    return math::cx::matrix_make_rows(m00, m10, m20, m30,
+                                      m01, m11, m21, m31,
+                                      m02, m12, m22, m32,
+                                      m03, m13, m23, m33);
 }
 
 // each arg is a column vector
@@ -477,6 +635,55 @@ matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_transpose(matrix_float4x4 m) {
     return matrix_invert(matrix_transpose(m));
 }
 
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_rigid(matrix_float4x4 m) {
+    matrix_float3x3 rt = matrix_transpose(matrix3x3_upper_left(m));
+    vector_float3 t = -matrix_multiply(rt, m.columns[3].xyz);
+    return matrix_make_columns(simd_make_float4(rt.columns[0], 0),
+                               simd_make_float4(rt.columns[1], 0),
+                               simd_make_float4(rt.columns[2], 0),
+                               simd_make_float4(t, 1));
+}
+
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_affine(matrix_float4x4 m) {
+    vector_float3 c0 = m.columns[0].xyz;
+    vector_float3 c1 = m.columns[1].xyz;
+    vector_float3 c2 = m.columns[2].xyz;
+    vector_float3 t  = m.columns[3].xyz;
+
+    // The rows of the inverse are the cross products of the columns over the determinant.
+    vector_float3 r0 = vector_cross(c1, c2);
+    vector_float3 r1 = vector_cross(c2, c0);
+    vector_float3 r2 = vector_cross(c0, c1);
+    float invDet = 1.0f / vector_dot(c0, r0);
+    r0 *= invDet;
+    r1 *= invDet;
+    r2 *= invDet;
+
+    return matrix_make_rows(r0.x, r0.y, r0.z, -vector_dot(r0, t),
+                            r1.x, r1.y, r1.z, -vector_dot(r1, t),
+                            r2.x, r2.y, r2.z, -vector_dot(r2, t),
+                               0,    0,    0,                  1 );
+}
+
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_perspective_left_hand(float fovyRadians, float aspect, float nearZ, float farZ) {
+    float ys = 1 / tanf(fovyRadians * 0.5);
+    float xs = ys / aspect;
+    float zs = farZ / (farZ - nearZ);
+    // Forward: x' = xs x, y' = ys y, z' = zs z - nearZ zs w, w' = z.
+    return matrix_make_rows(1 / xs,      0,                    0,         0,
+                                 0, 1 / ys,                    0,         0,
+                                 0,      0,                    0,         1,
+                                 0,      0, -1 / (nearZ * zs), 1 / nearZ );
+}
+
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_ortho_left_hand(float left, float right, float bottom, float top, float nearZ, float farZ) {
+    return matrix_make_rows(
+        (right - left) / 2,                  0,              0, (right + left) / 2,
+                         0, (top - bottom) / 2,              0, (top + bottom) / 2,
+                         0,                  0, farZ - nearZ,              nearZ,
+                         0,                  0,              0,                  1 );
+}
+
 quaternion_float AAPL_SIMD_OVERLOAD quaternion(float x, float y, float z, float w) {
     return (quaternion_float){ x, y, z, w };
 }
@@ -486,7 +693,7 @@ quaternion_float AAPL_SIMD_OVERLOAD quaternion(vector_float3 v, float w) {
 }
 
 quaternion_float AAPL_SIMD_OVERLOAD quaternion_identity() {
-    return quaternion(0, 0, 0, 1);
+    return math::cx::quaternion_identity();
 }
 
 quaternion_float AAPL_SIMD_OVERLOAD quaternion_from_axis_angle(vector_float3 axis, float radians) {
@@ -676,8 +883,7 @@ static inline quaternion_float AAPL_SIMD_OVERLOAD quaternion_from_direction_vect
     quaternion_float q = quaternion_from_matrix3x3(m);
 
     if(right_handed) {
-        q = q.yxwz;
-        q.xw = -q.xw;
+        q = simd_make_float4(-q.y, q.x, q.w, -q.z);
     }
 
     q = vector_normalize(q);
@@ -726,3 +932,250 @@ vector_float3 AAPL_SIMD_OVERLOAD right_direction_vector_from_quaternion(quaterni
     // Negate for a right-handed coordinate system
     return direction;
 }
+
+namespace math
+{
+    namespace
+    {
+        struct InverseCase
+        {
+            matrix_float4x4 m;
+            float           p[6];   // projection parameters
+        };
+
+        // Largest element difference, relative to the element once it is above one, so the large
+        // entries of a near-plane-heavy projection do not dominate.
+        float sMaxError(const matrix_float4x4& a, const matrix_float4x4& b)
+        {
+            float worst = 0.f;
+            for (int c = 0; c < 4; ++c)
+            {
+                for (int r = 0; r < 4; ++r)
+                    worst = std::max(worst, fabsf(a.columns[c][r] - b.columns[c][r]) / std::max(1.f, fabsf(b.columns[c][r])));
+            }
+            return (worst);
+        }
+
+        float sResidual(const matrix_float4x4& m, const matrix_float4x4& inverse)
+        {
+            return (sMaxError(simd_mul(m, inverse), matrix_identity_float4x4));
+        }
+
+        simd::float4 sPlaneNormalize(const simd::float4& plane)
+        {
+            return (plane / simd::length(plane.xyz));
+        }
+
+        // RMDLCamera::updateUniforms as it was before the closed-form inverses: every inverse goes
+        // through simd_inverse. The benchmark times it against the current updateUniforms.
+        RMDLCameraUniforms sSimdInverseUniforms(const RMDLCamera& camera)
+        {
+            RMDLCameraUniforms uniforms;
+            const simd::float3 position = camera.position();
+            const simd::float3 direction = camera.direction();
+            const simd::float3 up = camera.up();
+            uniforms.viewMatrix = matrix_look_at_left_hand(position, position + direction, up);
+            if (camera.isPerspective())
+                uniforms.projectionMatrix = matrix_perspective_left_hand(camera.viewAngle(), camera.aspectRatio(), camera.nearPlane(), camera.farPlane());
+            else
+            {
+                const float halfHeight = camera.width() * 0.5f;
+                const float halfWidth = halfHeight * camera.aspectRatio();
+                uniforms.projectionMatrix = matrix_ortho_left_hand(-halfWidth, halfWidth, -halfHeight, halfHeight, camera.nearPlane(), camera.farPlane());
+            }
+            uniforms.viewProjectionMatrix = uniforms.projectionMatrix * uniforms.viewMatrix;
+            uniforms.invProjectionMatrix = simd_inverse(uniforms.projectionMatrix);
+            uniforms.invOrientationProjectionMatrix = simd_inverse(uniforms.projectionMatrix * matrix_look_at_left_hand(simd::float3{0, 0, 0}, direction, up));
+            uniforms.invViewProjectionMatrix = simd_inverse(uniforms.viewProjectionMatrix);
+            uniforms.invViewMatrix = simd_inverse(uniforms.viewMatrix);
+            const simd::float4x4 transposed = simd::transpose(uniforms.viewProjectionMatrix);
+            uniforms.frustumPlanes[0] = sPlaneNormalize(transposed.columns[3] + transposed.columns[0]);
+            uniforms.frustumPlanes[1] = sPlaneNormalize(transposed.columns[3] - transposed.columns[0]);
+            uniforms.frustumPlanes[2] = sPlaneNormalize(transposed.columns[3] + transposed.columns[1]);
+            uniforms.frustumPlanes[3] = sPlaneNormalize(transposed.columns[3] - transposed.columns[1]);
+            uniforms.frustumPlanes[4] = sPlaneNormalize(transposed.columns[3] + transposed.columns[2]);
+            uniforms.frustumPlanes[5] = sPlaneNormalize(transposed.columns[3] - transposed.columns[2]);
+            return (uniforms);
+        }
+
+        // Largest residual of the three inverses updateUniforms builds from invertible matrices it
+        // also returns; invOrientationProjectionMatrix is compared against the reference instead.
+        float sUniformsResidual(const RMDLCameraUniforms& u)
+        {
+            return (std::max({ sResidual(u.viewMatrix, u.invViewMatrix),
+                               sResidual(u.projectionMatrix, u.invProjectionMatrix),
+                               sResidual(u.viewProjectionMatrix, u.invViewProjectionMatrix) }));
+        }
+
+        float sUniformsError(const RMDLCameraUniforms& u, const RMDLCameraUniforms& reference)
+        {
+            return (std::max({ sMaxError(u.invViewMatrix, reference.invViewMatrix),
+                               sMaxError(u.invProjectionMatrix, reference.invProjectionMatrix),
+                               sMaxError(u.invViewProjectionMatrix, reference.invViewProjectionMatrix),
+                               sMaxError(u.invOrientationProjectionMatrix, reference.invOrientationProjectionMatrix) }));
+        }
+    }
+
+    void benchmarkInverses(FILE* out)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr size_t kCases = 4096;
+        constexpr int kRuns = 5;
+        // A closed-form inverse is flagged once its worst |M * inverse - I| passes both 1e-3 and four
+        // times what simd_inverse reaches on the same matrices; the camera view-projections with a far
+        // translation are ill-conditioned enough that simd_inverse itself lands well above 1e-3.
+        auto withinBound = [](float residual, float simdResidual)
+        {
+            return (residual <= std::max(1e-3f, 4.f * simdResidual));
+        };
+
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(-1.f, 1.f);
+        std::uniform_real_distribution<float> angle(0.f, 2.f * (float)M_PI);
+        std::uniform_real_distribution<float> scale(0.1f, 10.f);
+        std::uniform_real_distribution<float> translate(-100.f, 100.f);
+        std::uniform_real_distribution<float> fovy(radians_from_degrees(30.f), radians_from_degrees(120.f));
+        std::uniform_real_distribution<float> aspect(0.5f, 2.5f);
+        std::uniform_real_distribution<float> nearZ(0.01f, 1.f);
+        std::uniform_real_distribution<float> farZ(10.f, 1000.f);
+
+        auto rotation = [&]()
+        {
+            const vector_float3 axis = vector_normalize(simd_make_float3(unit(rng), unit(rng), unit(rng)) + simd_make_float3(0.f, 0.f, 1e-3f));
+            return (matrix4x4_rotation(angle(rng), axis));
+        };
+
+        enum Kind { Rigid, Affine, Perspective, Ortho, KindCount };
+        const char* names[KindCount] = { "rigid", "affine", "perspective", "ortho" };
+
+        fprintf(out, "%12s %14s %14s %14s %12s %12s\n", "inverse", "max vs simd", "max residual", "simd residual", "closed ns", "simd ns");
+        for (int kind = 0; kind < KindCount; ++kind)
+        {
+            std::vector<InverseCase> cases(kCases);
+            for (InverseCase& c : cases)
+            {
+                const matrix_float4x4 t = matrix4x4_translation(translate(rng), translate(rng), translate(rng));
+                switch (kind)
+                {
+                    case Rigid:
+                        c.m = simd_mul(t, rotation());
+                        break;
+                    case Affine:
+                        c.m = simd_mul(t, simd_mul(rotation(), matrix4x4_scale(scale(rng), scale(rng), scale(rng))));
+                        break;
+                    case Perspective:
+                        c.p[0] = fovy(rng);
+                        c.p[1] = aspect(rng);
+                        c.p[2] = nearZ(rng);
+                        c.p[3] = farZ(rng);
+                        c.m = matrix_perspective_left_hand(c.p[0], c.p[1], c.p[2], c.p[3]);
+                        break;
+                    default:
+                        c.p[0] = -scale(rng);
+                        c.p[1] = scale(rng);
+                        c.p[2] = -scale(rng);
+                        c.p[3] = scale(rng);
+                        c.p[4] = nearZ(rng);
+                        c.p[5] = farZ(rng);
+                        c.m = matrix_ortho_left_hand(c.p[0], c.p[1], c.p[2], c.p[3], c.p[4], c.p[5]);
+                        break;
+                }
+            }
+
+            auto closed = [kind](const InverseCase& c)
+            {
+                switch (kind)
+                {
+                    case Rigid:         return (matrix_inverse_rigid(c.m));
+                    case Affine:        return (matrix_inverse_affine(c.m));
+                    case Perspective:   return (matrix_inverse_perspective_left_hand(c.p[0], c.p[1], c.p[2], c.p[3]));
+                    default:            return (matrix_inverse_ortho_left_hand(c.p[0], c.p[1], c.p[2], c.p[3], c.p[4], c.p[5]));
+                }
+            };
+
+            float maxError = 0.f;
+            float maxResidual = 0.f;
+            float simdResidual = 0.f;
+            for (const InverseCase& c : cases)
+            {
+                const matrix_float4x4 reference = simd_inverse(c.m);
+                const matrix_float4x4 inverse = closed(c);
+                maxError = std::max(maxError, sMaxError(inverse, reference));
+                maxResidual = std::max(maxResidual, sResidual(c.m, inverse));
+                simdResidual = std::max(simdResidual, sResidual(c.m, reference));
+            }
+
+            // The volatile sink keeps the inverses from being optimized away.
+            double closedNs = 1e30;
+            double simdNs = 1e30;
+            volatile float sink = 0.f;
+            for (int run = 0; run < kRuns; ++run)
+            {
+                auto start = Clock::now();
+                for (const InverseCase& c : cases)
+                    sink = sink + closed(c).columns[3][0];
+                closedNs = std::min(closedNs, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kCases);
+
+                start = Clock::now();
+                for (const InverseCase& c : cases)
+                    sink = sink + simd_inverse(c.m).columns[3][0];
+                simdNs = std::min(simdNs, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kCases);
+            }
+
+            fprintf(out, "%12s %14.3g %14.3g %14.3g %12.2f %12.2f%s\n", names[kind], maxError, maxResidual, simdResidual,
+                    closedNs, simdNs, withinBound(maxResidual, simdResidual) ? "" : "  MISMATCH");
+        }
+
+        // The same check on whole RMDLCamera::updateUniforms calls, against the simd_inverse version
+        // it replaced, for random perspective and parallel cameras.
+        const char* cameraNames[2] = { "persp cam", "ortho cam" };
+        for (int perspective = 1; perspective >= 0; --perspective)
+        {
+            std::vector<RMDLCamera> cameras(kCases);
+            for (RMDLCamera& camera : cameras)
+            {
+                const simd::float3 position = simd_make_float3(translate(rng), translate(rng), translate(rng));
+                const simd::float3 direction = vector_normalize(simd_make_float3(unit(rng), unit(rng), unit(rng)) + simd_make_float3(0.f, 0.f, 1e-3f));
+                const simd::float3 up = fabsf(direction.y) < 0.9f ? simd_make_float3(0.f, 1.f, 0.f) : simd_make_float3(1.f, 0.f, 0.f);
+                if (perspective)
+                    camera.initPerspectiveWithPosition(position, direction, up, fovy(rng), aspect(rng), nearZ(rng), farZ(rng));
+                else
+                    camera.initParallelWithPosition(position, direction, up, scale(rng), scale(rng), nearZ(rng), farZ(rng));
+            }
+
+            float maxError = 0.f;
+            float maxResidual = 0.f;
+            float simdResidual = 0.f;
+            for (RMDLCamera& camera : cameras)
+            {
+                const RMDLCameraUniforms reference = sSimdInverseUniforms(camera);
+                const RMDLCameraUniforms uniforms = camera.uniforms();
+                maxError = std::max(maxError, sUniformsError(uniforms, reference));
+                maxResidual = std::max(maxResidual, sUniformsResidual(uniforms));
+                simdResidual = std::max(simdResidual, sUniformsResidual(reference));
+            }
+
+            double closedNs = 1e30;
+            double simdNs = 1e30;
+            volatile float sink = 0.f;
+            for (int run = 0; run < kRuns; ++run)
+            {
+                auto start = Clock::now();
+                for (RMDLCamera& camera : cameras)
+                {
+                    camera.updateUniforms();
+                    sink = sink + camera.uniforms().invViewProjectionMatrix.columns[3][0];
+                }
+                closedNs = std::min(closedNs, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kCases);
+
+                start = Clock::now();
+                for (const RMDLCamera& camera : cameras)
+                    sink = sink + sSimdInverseUniforms(camera).invViewProjectionMatrix.columns[3][0];
+                simdNs = std::min(simdNs, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kCases);
+            }
+
+            fprintf(out, "%12s %14.3g %14.3g %14.3g %12.2f %12.2f%s\n", cameraNames[1 - perspective], maxError, maxResidual,
+                    simdResidual, closedNs, simdNs, withinBound(maxResidual, simdResidual) ? "" : "  MISMATCH");
+        }
+    }
+}
@@ -11,8 +11,9 @@
 #ifndef MathUtils_hpp
 # define MathUtils_hpp
 
-# include <simd/simd.h>
+# include "RMDLSimd.hpp"
 # include <assert.h>
+# include <stdio.h>
 # include <stdlib.h>
 
 namespace math
@@ -28,10 +29,227 @@ namespace math
     simd::float4x4 makeScale( const simd::float3& v );
     simd::float4x3 discardTranslation( const simd::float4x4& m );
     simd::float3x3 discardTranslationP( const simd::float4x4& m );
+
+    /// Checks matrix_inverse_rigid, matrix_inverse_affine, matrix_inverse_perspective_left_hand and
+    /// matrix_inverse_ortho_left_hand against simd_inverse on random camera-like matrices, and
+    /// prints the largest element difference, the largest |M * inverse - I| of both, and the
+    /// time per inverse to out. Two more rows time RMDLCamera::updateUniforms against its
+    /// simd_inverse version. A row ends in MISMATCH when the residual is out of bounds.
+    void benchmarkInverses( FILE* out );
+
+    /// Compile-time versions of the constructors above. The runtime makeIdentity, makeScale,
+    /// makeTranslate, makeOrtho, makePerspective, makeZRotate, matrix_make_rows and
+    /// quaternion_identity forward to these, so a constant transform gives the same bits whether
+    /// it is folded or computed at run time.
+    /// Matrices are plain column-major arrays so they can be inspected in static_assert, and
+    /// convert implicitly to the simd types.
+    namespace cx
+    {
+        constexpr double kPi = 3.14159265358979323846;
+
+        struct Matrix3
+        {
+            float columns[3][3];
+
+            constexpr operator simd_float3x3() const
+            {
+                return simd_float3x3{ {
+                    simd_float3{ columns[0][0], columns[0][1], columns[0][2] },
+                    simd_float3{ columns[1][0], columns[1][1], columns[1][2] },
+                    simd_float3{ columns[2][0], columns[2][1], columns[2][2] } } };
+            }
+
+            operator simd::float3x3() const
+            {
+                return (simd::float3x3((simd_float3x3)*this));
+            }
+        };
+
+        struct Matrix4
+        {
+            float columns[4][4];
+
+            constexpr operator simd_float4x4() const
+            {
+                return simd_float4x4{ {
+                    simd_float4{ columns[0][0], columns[0][1], columns[0][2], columns[0][3] },
+                    simd_float4{ columns[1][0], columns[1][1], columns[1][2], columns[1][3] },
+                    simd_float4{ columns[2][0], columns[2][1], columns[2][2], columns[2][3] },
+                    simd_float4{ columns[3][0], columns[3][1], columns[3][2], columns[3][3] } } };
+            }
+
+            operator simd::float4x4() const
+            {
+                return (simd::float4x4((simd_float4x4)*this));
+            }
+        };
+
+        struct Quaternion
+        {
+            float x, y, z, w;
+
+            constexpr operator simd_float4() const
+            {
+                return simd_float4{ x, y, z, w };
+            }
+        };
+
+        constexpr double abs(double x)
+        {
+            return (x < 0 ? -x : x);
+        }
+
+        /// Newton iteration in double, converging from above; exact for perfect squares.
+        constexpr float sqrt(float x)
+        {
+            if (x < 0.f || x != x)
+                return (__builtin_nanf(""));
+            if (x == 0.f || x == __builtin_huge_valf())
+                return (x);
+            double r = x > 1.f ? x : 1.0;
+            for (;;)
+            {
+                double next = 0.5 * (r + x / r);
+                if (next >= r)
+                    break;
+                r = next;
+            }
+            return (float)r;
+        }
+
+        /// Taylor series in double after reduction to [-pi, pi].
+        constexpr double sinReduced(double x)
+        {
+            const double twoPi = 2.0 * kPi;
+            x -= twoPi * (double)(long long)(x / twoPi);
+            if (x > kPi)
+                x -= twoPi;
+            else if (x < -kPi)
+                x += twoPi;
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 12; ++n)
+            {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return (sum);
+        }
+
+        constexpr float sin(float radians)
+        {
+            return (float)sinReduced(radians);
+        }
+
+        constexpr float cos(float radians)
+        {
+            return (float)sinReduced(radians + kPi / 2);
+        }
+
+        constexpr float tan(float radians)
+        {
+            return (float)(sinReduced(radians) / sinReduced(radians + kPi / 2));
+        }
+
+        constexpr Matrix3 matrix_make_rows(float m00, float m10, float m20,
+                                           float m01, float m11, float m21,
+                                           float m02, float m12, float m22)
+        {
+            return Matrix3{ {
+                { m00, m01, m02 },
+                { m10, m11, m12 },
+                { m20, m21, m22 } } };
+        }
+
+        constexpr Matrix4 matrix_make_rows(float m00, float m10, float m20, float m30,
+                                           float m01, float m11, float m21, float m31,
+                                           float m02, float m12, float m22, float m32,
+                                           float m03, float m13, float m23, float m33)
+        {
+            return Matrix4{ {
+                { m00, m01, m02, m03 },
+                { m10, m11, m12, m13 },
+                { m20, m21, m22, m23 },
+                { m30, m31, m32, m33 } } };
+        }
+
+        constexpr Matrix4 makeIdentity()
+        {
+            return Matrix4{ {
+                { 1.f, 0.f, 0.f, 0.f },
+                { 0.f, 1.f, 0.f, 0.f },
+                { 0.f, 0.f, 1.f, 0.f },
+                { 0.f, 0.f, 0.f, 1.f } } };
+        }
+
+        constexpr Matrix4 makeScale(float x, float y, float z)
+        {
+            return Matrix4{ {
+                { x, 0.f, 0.f, 0.f },
+                { 0.f, y, 0.f, 0.f },
+                { 0.f, 0.f, z, 0.f },
+                { 0.f, 0.f, 0.f, 1.f } } };
+        }
+
+        constexpr Matrix4 makeTranslate(float x, float y, float z)
+        {
+            return Matrix4{ {
+                { 1.f, 0.f, 0.f, 0.f },
+                { 0.f, 1.f, 0.f, 0.f },
+                { 0.f, 0.f, 1.f, 0.f },
+                { x, y, z, 1.f } } };
+        }
+
+        constexpr Matrix4 makeOrtho(float left, float right, float top, float bottom, float near, float far)
+        {
+            return Matrix4{ {
+                { 2.f/(right - left), 0.f, 0.f, 0.f },
+                { 0.f, 2.f/(top - bottom), 0.f, 0.f },
+                { 0.f, 0.f, -2.f/(far - near), 0.f },
+                { -(right+left)/(right-left), -(top+bottom)/(top-bottom), -(far+near)/(far-near), 1.f } } };
+        }
+
+        constexpr Matrix4 makePerspective(float fovRadians, float aspect, float znear, float zfar)
+        {
+            float ys = 1.f / tan(fovRadians * 0.5f);
+            float xs = ys / aspect;
+            float zs = zfar / (znear - zfar);
+            return matrix_make_rows(xs, 0.f, 0.f, 0.f,
+                                    0.f, ys, 0.f, 0.f,
+                                    0.f, 0.f, zs, znear * zs,
+                                    0.f, 0.f, -1.f, 0.f);
+        }
+
+        constexpr Matrix4 makeZRotate(float angleRadians)
+        {
+            const float c = cos(angleRadians);
+            const float s = sin(angleRadians);
+            return matrix_make_rows(c, s, 0.f, 0.f,
+                                    -s, c, 0.f, 0.f,
+                                    0.f, 0.f, 1.f, 0.f,
+                                    0.f, 0.f, 0.f, 1.f);
+        }
+
+        constexpr Quaternion quaternion_identity()
+        {
+            return Quaternion{ 0.f, 0.f, 0.f, 1.f };
+        }
+
+        /// The axis must already be normalized.
+        constexpr Quaternion quaternion_from_axis_angle(float x, float y, float z, float radians)
+        {
+            const float s = sin(radians * 0.5f);
+            return Quaternion{ x * s, y * s, z * s, cos(radians * 0.5f) };
+        }
+    }
 }
 
 // Because these are common methods, allow other libraries to overload their implementation.
-#define AAPL_SIMD_OVERLOAD __attribute__((__overloadable__))
+#if defined(__has_attribute) && __has_attribute(__overloadable__)
+# define AAPL_SIMD_OVERLOAD __attribute__((__overloadable__))
+#else
+# define AAPL_SIMD_OVERLOAD
+#endif
 
 /// A single-precision quaternion type.
 typedef vector_float4 quaternion_float;
@@ -42,6 +260,17 @@ float AAPL_SIMD_OVERLOAD float32_from_float16(uint16_t i);
 // Given a 32-bit float, returns a uint16_t encoded as a 16-bit float.
 uint16_t AAPL_SIMD_OVERLOAD float16_from_float32(float f);
 
+/// Converts count 32-bit floats to 16-bit floats, rounding to nearest even.
+/// Uses F16C on x86 and the native conversion on ARM; the scalar fallback gives the same bits.
+void AAPL_SIMD_OVERLOAD float16_from_float32(uint16_t* pDst, const float* pSrc, size_t count);
+
+/// Converts count 16-bit floats to 32-bit floats. The conversion is exact.
+void AAPL_SIMD_OVERLOAD float32_from_float16(float* pDst, const uint16_t* pSrc, size_t count);
+
+/// Packs count vector_float4 values into consecutive half4 (4 x uint16_t), e.g. for RGBA16Float uploads
+/// or Half4 vertex attributes.
+void AAPL_SIMD_OVERLOAD half4_from_float4(uint16_t* pDst, const vector_float4* pSrc, size_t count);
+
 /// Returns the number of degrees in the specified number of radians.
 float AAPL_SIMD_OVERLOAD degrees_from_radians(float radians);
 
@@ -209,6 +438,22 @@ matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_perspective_frustum_right_hand(float l
 /// Returns the inverse of the transpose of the given matrix.
 matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_transpose(matrix_float4x4 m);
 
+/// Returns the inverse of a rigid transform (orthonormal rotation plus translation).
+/// The rotation is transposed and the translation is rotated back and negated.
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_rigid(matrix_float4x4 m);
+
+/// Returns the inverse of an affine transform (invertible upper 3x3 plus translation, last row 0 0 0 1).
+/// The 3x3 part is inverted from its cofactors instead of a general 4x4 inversion.
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_affine(matrix_float4x4 m);
+
+/// Returns the inverse of matrix_perspective_left_hand(fovyRadians, aspect, nearZ, farZ),
+/// built directly from the same parameters.
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_perspective_left_hand(float fovyRadians, float aspect, float nearZ, float farZ);
+
+/// Returns the inverse of matrix_ortho_left_hand(left, right, bottom, top, nearZ, farZ),
+/// built directly from the same parameters.
+matrix_float4x4 AAPL_SIMD_OVERLOAD matrix_inverse_ortho_left_hand(float left, float right, float bottom, float top, float nearZ, float farZ);
+
 /// Constructs an identity quaternion.
 quaternion_float AAPL_SIMD_OVERLOAD quaternion_identity(void);
 
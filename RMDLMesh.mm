@@ -7,6 +7,7 @@
 
 #import "RMDLMainRenderer_shared.h"
 #include "RMDLUtilities.h"
+#include "RMDLMathUtils.hpp"
 
 #include <Metal/Metal.hpp>
 
@@ -640,13 +641,18 @@ static void packVertexData(void *output, MTL::VertexFormat format, vector_float4
             ((int16_t*)output)[0] = 0x7FFF * (2.0 * value.x -1.0);
             break;
         case MTL::VertexFormatHalf4:
-            ((__fp16 *)output)[3] = value.w;
+            half4_from_float4((uint16_t *)output, &value, 1);
+            break;
         case MTL::VertexFormatHalf3:
-            ((__fp16 *)output)[2] = value.z;
         case MTL::VertexFormatHalf2:
-            ((__fp16 *)output)[1] = value.y;
-            ((__fp16 *)output)[0] = value.x;
+        {
+            // Convert all four lanes in one go and store only the ones the attribute holds, since
+            // the next attribute may start right after them.
+            uint16_t halves[4];
+            half4_from_float4(halves, &value, 1);
+            memcpy(output, halves, (format == MTL::VertexFormatHalf3 ? 3 : 2) * sizeof(uint16_t));
             break;
+        }
         case MTL::VertexFormatFloat4:
             ((float*)output)[3] = value.w;
         case MTL::VertexFormatFloat3:
@@ -0,0 +1,199 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLNarrowphase.cpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 20:24:58      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLNarrowphase.hpp"
+
+#include "RMDLSimd.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // The two bodies of up to eight pairs, one lane per pair. Unused lanes repeat the last pair,
+    // so they hold real numbers; the caller ignores them.
+    struct PairLanes
+    {
+        simd_float8 dx;     // item - query
+        simd_float8 dy;
+        simd_float8 queryExtentX;
+        simd_float8 queryExtentY;
+        simd_float8 itemExtentX;
+        simd_float8 itemExtentY;
+        simd_float8 moveX;      // query motion over the tick, relative to the item
+        simd_float8 moveY;
+
+        PairLanes(const physics::Bodies2D& queries, const physics::Bodies2D& items, const physics::CandidatePair* pPairs, size_t lanes)
+        {
+            for (size_t lane = 0; lane < 8; ++lane)
+            {
+                const physics::CandidatePair& pair = pPairs[std::min(lane, lanes - 1)];
+                const size_t q = pair.query * queries.stride;
+                const size_t i = pair.item * items.stride;
+                dx[lane] = items.pX[i] - queries.pX[q];
+                dy[lane] = items.pY[i] - queries.pY[q];
+                queryExtentX[lane] = queries.pExtentX ? queries.pExtentX[pair.query] : queries.extentX;
+                queryExtentY[lane] = queries.pExtentY ? queries.pExtentY[pair.query] : queries.extentY;
+                itemExtentX[lane] = items.pExtentX ? items.pExtentX[pair.item] : items.extentX;
+                itemExtentY[lane] = items.pExtentY ? items.pExtentY[pair.item] : items.extentY;
+                moveX[lane] = (queries.pDeltaX ? queries.pDeltaX[pair.query] : queries.deltaX)
+                            - (items.pDeltaX ? items.pDeltaX[pair.item] : items.deltaX);
+                moveY[lane] = (queries.pDeltaY ? queries.pDeltaY[pair.query] : queries.deltaY)
+                            - (items.pDeltaY ? items.pDeltaY[pair.item] : items.deltaY);
+            }
+        }
+    };
+
+    // Branch-free compaction: every lane is written, only hits advance.
+    size_t sCompact(simd_int8 hit, const physics::CandidatePair* pPairs, size_t lanes, physics::CandidatePair* pOut)
+    {
+        size_t written = 0;
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            pOut[written] = pPairs[lane];
+            written += hit[lane] & 1;
+        }
+        return (written);
+    }
+
+    size_t sCompact(simd_int8 hit, simd_float8 toi, const physics::CandidatePair* pPairs, size_t lanes,
+                    physics::CandidatePair* pOut, float* pToiOut)
+    {
+        size_t written = 0;
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            pOut[written] = pPairs[lane];
+            pToiOut[written] = toi[lane];
+            written += hit[lane] & 1;
+        }
+        return (written);
+    }
+
+    // A point moving by (moveX, moveY) over the tick against a box centered (dx, dy) away, one
+    // slab per axis. An axis without motion is inside for the whole tick or never.
+    simd_int8 sSweepPointBox(const PairLanes& p, simd_float8 extentX, simd_float8 extentY, simd_float8& toi)
+    {
+        const simd_float8 zero = simdSplat<simd_float8>(0.f);
+        const simd_float8 one = simdSplat<simd_float8>(1.f);
+        const simd_float8 never = simdSplat<simd_float8>(1e30f);
+
+        auto slab = [&](simd_float8 center, simd_float8 extent, simd_float8 move, simd_float8& enter, simd_float8& exit)
+        {
+            const simd_int8 still = move == zero;
+            const simd_float8 invMove = one / simd_select(move, one, still);
+            const simd_float8 t0 = (center - extent) * invMove;
+            const simd_float8 t1 = (center + extent) * invMove;
+            const simd_float8 stillEnter = simd_select(never, -never, simd_abs(center) < extent);
+            enter = simd_select(simd_min(t0, t1), stillEnter, still);
+            exit = simd_select(simd_max(t0, t1), never, still);
+        };
+
+        simd_float8 enterX, exitX, enterY, exitY;
+        slab(p.dx, extentX, p.moveX, enterX, exitX);
+        slab(p.dy, extentY, p.moveY, enterY, exitY);
+        const simd_float8 enter = simd_max(enterX, enterY);
+        const simd_float8 exit = simd_min(exitX, exitY);
+        toi = simd_max(enter, zero);
+        return ((enter < exit) & (enter < one) & (exit > zero));
+    }
+
+    template <typename SweepTest>
+    size_t sSweep(const physics::Bodies2D& queries, const physics::Bodies2D& items,
+                  const physics::CandidatePair* pPairs, size_t count, physics::CandidatePair* pHits, float* pToi,
+                  SweepTest test)
+    {
+        size_t hits = 0;
+        for (size_t base = 0; base < count; base += 8)
+        {
+            const size_t lanes = std::min<size_t>(8, count - base);
+            const PairLanes p(queries, items, pPairs + base, lanes);
+            simd_float8 toi;
+            const simd_int8 hit = test(p, toi);
+            hits += sCompact(hit, toi, pPairs + base, lanes, pHits + hits, pToi + hits);
+        }
+        return (hits);
+    }
+}
+
+namespace physics
+{
+    size_t overlapAabbAabb(const Bodies2D& queries, const Bodies2D& items,
+                           const CandidatePair* pPairs, size_t count, CandidatePair* pHits)
+    {
+        size_t hits = 0;
+        for (size_t base = 0; base < count; base += 8)
+        {
+            const size_t lanes = std::min<size_t>(8, count - base);
+            const PairLanes p(queries, items, pPairs + base, lanes);
+            const simd_int8 hit = (simd_abs(p.dx) < p.queryExtentX + p.itemExtentX)
+                                & (simd_abs(p.dy) < p.queryExtentY + p.itemExtentY);
+            hits += sCompact(hit, pPairs + base, lanes, pHits + hits);
+        }
+        return (hits);
+    }
+
+    size_t overlapCircleAabb(const Bodies2D& queries, const Bodies2D& items,
+                             const CandidatePair* pPairs, size_t count, CandidatePair* pHits)
+    {
+        const simd_float8 zero = simdSplat<simd_float8>(0.f);
+        size_t hits = 0;
+        for (size_t base = 0; base < count; base += 8)
+        {
+            const size_t lanes = std::min<size_t>(8, count - base);
+            const PairLanes p(queries, items, pPairs + base, lanes);
+            // Distance from the circle's center to the box, per axis, then squared length.
+            const simd_float8 outsideX = simd_max(simd_abs(p.dx) - p.itemExtentX, zero);
+            const simd_float8 outsideY = simd_max(simd_abs(p.dy) - p.itemExtentY, zero);
+            const simd_int8 hit = outsideX * outsideX + outsideY * outsideY < p.queryExtentX * p.queryExtentX;
+            hits += sCompact(hit, pPairs + base, lanes, pHits + hits);
+        }
+        return (hits);
+    }
+
+    size_t sweepSegmentCircle(const Bodies2D& queries, const Bodies2D& items,
+                              const CandidatePair* pPairs, size_t count, CandidatePair* pHits, float* pToi)
+    {
+        return (sSweep(queries, items, pPairs, count, pHits, pToi, [](const PairLanes& p, simd_float8& toi)
+        {
+            const simd_float8 zero = simdSplat<simd_float8>(0.f);
+            const simd_float8 one = simdSplat<simd_float8>(1.f);
+            // |o + t m| = r with o the start offset from the circle's center: a t^2 + 2 b t + c = 0.
+            const simd_float8 a = p.moveX * p.moveX + p.moveY * p.moveY;
+            const simd_float8 b = -(p.dx * p.moveX + p.dy * p.moveY);
+            const simd_float8 c = p.dx * p.dx + p.dy * p.dy - p.itemExtentX * p.itemExtentX;
+            const simd_float8 discriminant = b * b - a * c;
+            const simd_float8 tiny = simdSplat<simd_float8>(1e-30f);
+            const simd_float8 root = simd_max(discriminant, tiny);
+            const simd_float8 t = (-b - root * simd_precise_rsqrt(root)) / simd_select(a, one, a == zero);
+            // Starting inside is a hit at 0; otherwise the point has to be closing in and reach
+            // the circle before the end of the tick.
+            const simd_int8 inside = c < zero;
+            toi = simd_select(simd_max(t, zero), zero, inside);
+            return (inside | ((b < zero) & (discriminant > zero) & (t < one)));
+        }));
+    }
+
+    size_t sweepSegmentAabb(const Bodies2D& queries, const Bodies2D& items,
+                            const CandidatePair* pPairs, size_t count, CandidatePair* pHits, float* pToi)
+    {
+        return (sSweep(queries, items, pPairs, count, pHits, pToi, [](const PairLanes& p, simd_float8& toi)
+        {
+            return (sSweepPointBox(p, p.itemExtentX, p.itemExtentY, toi));
+        }));
+    }
+
+    size_t sweepAabbAabb(const Bodies2D& queries, const Bodies2D& items,
+                         const CandidatePair* pPairs, size_t count, CandidatePair* pHits, float* pToi)
+    {
+        return (sSweep(queries, items, pPairs, count, pHits, pToi, [](const PairLanes& p, simd_float8& toi)
+        {
+            return (sSweepPointBox(p, p.queryExtentX + p.itemExtentX, p.queryExtentY + p.itemExtentY, toi));
+        }));
+    }
+}
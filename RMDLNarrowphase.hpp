@@ -0,0 +1,71 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLNarrowphase.hpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 20:24:51      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLNARROWPHASE_HPP
+# define RMDLNARROWPHASE_HPP
+
+# include <cstddef>
+# include <cstdint>
+
+# include "RMDLBroadphase.hpp"
+
+namespace physics
+{
+    /// 2D bodies as structure of arrays. Body i is at (pX[i * stride], pY[i * stride]); its half
+    /// size (or radius, in x) is pExtentX[i], pExtentY[i] when given, extentX, extentY otherwise.
+    /// The swept tests also read how far it moves over the tick, pDeltaX[i], pDeltaY[i] when
+    /// given, deltaX, deltaY otherwise; left zero, the body is static.
+    struct Bodies2D
+    {
+        const float*    pX;
+        const float*    pY;
+        size_t          stride;
+        const float*    pExtentX;
+        const float*    pExtentY;
+        float           extentX;
+        float           extentY;
+        const float*    pDeltaX;
+        const float*    pDeltaY;
+        float           deltaX;
+        float           deltaY;
+    };
+
+    /// Exact tests for broadphase candidates, eight pairs per iteration.
+    ///
+    /// Each call gathers the two bodies of eight pairs into 8-wide registers, computes a hit mask
+    /// without branches, and compacts the hits into pHits by writing every pair and advancing the
+    /// output only for hits. pHits must have room for count pairs; it may alias pPairs, since
+    /// hits are only ever written at or before the pair being read. Returns the number of hits,
+    /// which keep their order from pPairs. Touching edges do not count as overlap.
+    size_t  overlapAabbAabb(const Bodies2D& queries, const Bodies2D& items,
+                            const CandidatePair* pPairs, size_t count, CandidatePair* pHits);
+    /// queries are circles (radius in extentX / pExtentX), items boxes.
+    size_t  overlapCircleAabb(const Bodies2D& queries, const Bodies2D& items,
+                              const CandidatePair* pPairs, size_t count, CandidatePair* pHits);
+
+    /// Swept tests, for bodies fast enough to pass through each other within one tick.
+    ///
+    /// Positions are where the bodies start the tick and only the query's motion relative to the
+    /// item matters. Each hit also gets its time of impact in pToi, the fraction of the tick at
+    /// which the two first touch; pairs already overlapping at the start hit at 0. Same batching,
+    /// order and aliasing rules as the overlap tests; pToi must have room for count values.
+    ///
+    /// The query is a point moving along a segment, items are circles (radius in extentX).
+    size_t  sweepSegmentCircle(const Bodies2D& queries, const Bodies2D& items,
+                               const CandidatePair* pPairs, size_t count, CandidatePair* pHits, float* pToi);
+    /// The query is a point moving along a segment, items are boxes.
+    size_t  sweepSegmentAabb(const Bodies2D& queries, const Bodies2D& items,
+                             const CandidatePair* pPairs, size_t count, CandidatePair* pHits, float* pToi);
+    /// Both are boxes; the item box grown by the query's half size makes it a segment test.
+    size_t  sweepAabbAabb(const Bodies2D& queries, const Bodies2D& items,
+                          const CandidatePair* pPairs, size_t count, CandidatePair* pHits, float* pToi);
+}
+
+#endif /* RMDLNARROWPHASE_HPP */
@@ -0,0 +1,483 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLOcclusionCulling.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 17:18:33      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLOcclusionCulling.hpp"
+
+#include "RMDLCamera.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace
+{
+    constexpr uint32_t kTileSize = 32;
+    constexpr float kMinW = 1e-6f;
+
+    double sMillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    float sReduceMin(simd_float8 v)
+    {
+        return (simd_reduce_min(v));
+    }
+
+    float sReduceMax(simd_float8 v)
+    {
+        return (simd_reduce_max(v));
+    }
+
+    // Near plane z >= 0 (Metal clip space); returns the vertex count of the clipped polygon.
+    int sClipNear(const simd_float4 (&in)[3], simd_float4 (&out)[4])
+    {
+        int count = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            const simd_float4 a = in[i];
+            const simd_float4 b = in[(i + 1) % 3];
+            if (a.z >= 0.f)
+                out[count++] = a;
+            if ((a.z >= 0.f) != (b.z >= 0.f))
+                out[count++] = a + (b - a) * (a.z / (a.z - b.z));
+        }
+        return (count);
+    }
+}
+
+namespace culling
+{
+    OcclusionCuller::OcclusionCuller(const OcclusionSettings& settings)
+    : _settings(settings)
+    , _viewProjection(matrix_identity_float4x4)
+    , _frame(1)     // so a zeroed _lastVisibleFrame never reads as "visible last frame"
+    , _stats()
+    {
+        _settings.width = std::max(_settings.width, 1u);
+        _settings.height = std::max(_settings.height, 1u);
+        for (uint32_t w = _settings.width, h = _settings.height; ; w = (w + 1) / 2, h = (h + 1) / 2)
+        {
+            _levels.push_back({ w, h, std::vector<float>((size_t)w * h, 1.f) });
+            if (w == 1 && h == 1)
+                break;
+        }
+    }
+
+    void OcclusionCuller::beginFrame(const simd_float4x4& viewProjection)
+    {
+        _viewProjection = viewProjection;
+        _occluders.clear();
+        ++_frame;
+    }
+
+    void OcclusionCuller::addOccluder(const Occluder& occluder)
+    {
+        _occluders.push_back(occluder);
+    }
+
+    void OcclusionCuller::setupOccluder(const Occluder& occluder, std::vector<Triangle>& triangles) const
+    {
+        const simd_float4x4 transform = simd_mul(_viewProjection, occluder.transform);
+        const float width = (float)_settings.width;
+        const float height = (float)_settings.height;
+
+        for (uint32_t i = 0; i + 2 < occluder.indexCount; i += 3)
+        {
+            simd_float4 in[3];
+            for (int j = 0; j < 3; ++j)
+            {
+                float position[3];
+                memcpy(position, (const uint8_t *)occluder.pPositions + (size_t)occluder.pIndices[i + j] * occluder.stride, sizeof(position));
+                in[j] = simd_mul(transform, simd_make_float4(position[0], position[1], position[2], 1.f));
+            }
+            simd_float4 clipped[4];
+            const int clippedCount = sClipNear(in, clipped);
+
+            for (int k = 1; k + 1 < clippedCount; ++k)
+            {
+                const simd_float4 v[3] = { clipped[0], clipped[k], clipped[k + 1] };
+                if (v[0].w <= kMinW || v[1].w <= kMinW || v[2].w <= kMinW)
+                    continue;
+
+                Triangle t;
+                hit_test::Triangle screen;
+                simd_float2* corners[3] = { &screen.a, &screen.b, &screen.c };
+                for (int j = 0; j < 3; ++j)
+                {
+                    const float invW = 1.f / v[j].w;
+                    *corners[j] = simd_make_float2((v[j].x * invW * 0.5f + 0.5f) * width, (v[j].y * invW * 0.5f + 0.5f) * height);
+                    t.z[j] = v[j].z * invW;
+                }
+                t.edges = hit_test::edgeFunctions(screen);
+                if (t.edges.area == 0.f)
+                    continue;
+
+                const float minX = std::min({ screen.a.x, screen.b.x, screen.c.x });
+                const float maxX = std::max({ screen.a.x, screen.b.x, screen.c.x });
+                const float minY = std::min({ screen.a.y, screen.b.y, screen.c.y });
+                const float maxY = std::max({ screen.a.y, screen.b.y, screen.c.y });
+                t.minX = (int32_t)std::max(floorf(minX), 0.f);
+                t.maxX = (int32_t)std::min(ceilf(maxX), width - 1.f);
+                t.minY = (int32_t)std::max(floorf(height - maxY), 0.f);
+                t.maxY = (int32_t)std::min(ceilf(height - minY), height - 1.f);
+                if (t.minX > t.maxX || t.minY > t.maxY)
+                    continue;
+                t.invArea = 1.f / t.edges.area;
+                triangles.push_back(t);
+            }
+        }
+    }
+
+    void OcclusionCuller::rasterTile(uint32_t tileX, uint32_t tileY)
+    {
+        Level& level = _levels[0];
+        const int32_t x0 = (int32_t)(tileX * kTileSize);
+        const int32_t y0 = (int32_t)(tileY * kTileSize);
+        const int32_t x1 = std::min(x0 + (int32_t)kTileSize, (int32_t)level.width) - 1;
+        const int32_t y1 = std::min(y0 + (int32_t)kTileSize, (int32_t)level.height) - 1;
+        const simd_float8 laneOffset = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+        const simd_int8 laneIndex = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        float depth[kTileSize * kTileSize];
+        std::fill(depth, depth + kTileSize * kTileSize, 1.f);
+
+        for (const Triangle& t : _triangles)
+        {
+            if (t.maxX < x0 || t.minX > x1 || t.maxY < y0 || t.minY > y1)
+                continue;
+            const int32_t rowEnd = std::min(t.maxY, y1);
+            const int32_t columnBegin = x0 + (std::max(t.minX, x0) - x0) / 8 * 8;
+            const int32_t columnEnd = std::min(t.maxX, x1);
+
+            for (int32_t row = std::max(t.minY, y0); row <= rowEnd; ++row)
+            {
+                const simd_float8 y = simdSplat<simd_float8>((float)level.height - (float)row - 0.5f);
+                for (int32_t column = columnBegin; column <= columnEnd; column += 8)
+                {
+                    simd_float8 e[3];
+                    simd_int8 mask = hit_test::coverage8(t.edges, (float)column + laneOffset, y, e);
+                    mask &= (column + laneIndex) <= columnEnd;
+                    if (!simd_any(mask))
+                        continue;
+                    const simd_float8 z = (e[0] * t.z[0] + e[1] * t.z[1] + e[2] * t.z[2]) * t.invArea;
+                    float* pDepth = depth + (row - y0) * kTileSize + (column - x0);
+                    simd_float8 current;
+                    memcpy(&current, pDepth, sizeof(current));
+                    mask &= z >= 0.f;
+                    current = simd_select(current, simd_min(current, z), mask);
+                    memcpy(pDepth, &current, sizeof(current));
+                }
+            }
+        }
+
+        for (int32_t row = y0; row <= y1; ++row)
+            memcpy(level.depth.data() + (size_t)row * level.width + x0, depth + (row - y0) * kTileSize, (x1 - x0 + 1) * sizeof(float));
+    }
+
+    void OcclusionCuller::buildHiZ()
+    {
+        for (size_t l = 1; l < _levels.size(); ++l)
+        {
+            const Level& src = _levels[l - 1];
+            Level& dst = _levels[l];
+            parallel::parallelFor(dst.height, [&](size_t y)
+            {
+                const uint32_t y0 = (uint32_t)y * 2;
+                const uint32_t y1 = std::min(y0 + 1, src.height - 1);
+                for (uint32_t x = 0; x < dst.width; ++x)
+                {
+                    const uint32_t x0 = x * 2;
+                    const uint32_t x1 = std::min(x0 + 1, src.width - 1);
+                    dst.depth[y * dst.width + x] = std::max({ src.depth[y0 * src.width + x0], src.depth[y0 * src.width + x1],
+                                                              src.depth[y1 * src.width + x0], src.depth[y1 * src.width + x1] });
+                }
+            }, dst.height * dst.width >= 4096 ? _settings.threadCount : 1);
+        }
+    }
+
+    void OcclusionCuller::rasterizeOccluders()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::vector<Triangle>> occluderTriangles(_occluders.size());
+        parallel::parallelFor(_occluders.size(), [&](size_t i)
+        {
+            setupOccluder(_occluders[i], occluderTriangles[i]);
+        }, _settings.threadCount);
+        _triangles.clear();
+        for (const std::vector<Triangle>& triangles : occluderTriangles)
+            _triangles.insert(_triangles.end(), triangles.begin(), triangles.end());
+
+        const uint32_t tilesX = (_settings.width + kTileSize - 1) / kTileSize;
+        const uint32_t tilesY = (_settings.height + kTileSize - 1) / kTileSize;
+        parallel::parallelFor(tilesX * tilesY, [&](size_t tile)
+        {
+            rasterTile((uint32_t)(tile % tilesX), (uint32_t)(tile / tilesX));
+        }, _settings.threadCount);
+        _stats.rasterMs = sMillisecondsSince(start);
+
+        const auto hiZStart = std::chrono::steady_clock::now();
+        buildHiZ();
+        _stats.hiZMs = sMillisecondsSince(hiZStart);
+        _stats.occluderTriangles = _triangles.size();
+    }
+
+    bool OcclusionCuller::isVisible(simd_float3 center, simd_float3 extent) const
+    {
+        // The eight corners, one per lane.
+        const simd_float8 signX = { -1.f, 1.f, -1.f, 1.f, -1.f, 1.f, -1.f, 1.f };
+        const simd_float8 signY = { -1.f, -1.f, 1.f, 1.f, -1.f, -1.f, 1.f, 1.f };
+        const simd_float8 signZ = { -1.f, -1.f, -1.f, -1.f, 1.f, 1.f, 1.f, 1.f };
+        const simd_float8 x = center.x + extent.x * signX;
+        const simd_float8 y = center.y + extent.y * signY;
+        const simd_float8 z = center.z + extent.z * signZ;
+        const simd_float4x4& m = _viewProjection;
+        const simd_float8 clipX = m.columns[0].x * x + m.columns[1].x * y + m.columns[2].x * z + m.columns[3].x;
+        const simd_float8 clipY = m.columns[0].y * x + m.columns[1].y * y + m.columns[2].y * z + m.columns[3].y;
+        const simd_float8 clipZ = m.columns[0].z * x + m.columns[1].z * y + m.columns[2].z * z + m.columns[3].z;
+        const simd_float8 clipW = m.columns[0].w * x + m.columns[1].w * y + m.columns[2].w * z + m.columns[3].w;
+        if (simd_any((clipW <= kMinW) | (clipZ < 0.f)))
+            return (true);
+
+        const Level& base = _levels[0];
+        const simd_float8 invW = 1.f / clipW;
+        const simd_float8 screenX = (clipX * invW * 0.5f + 0.5f) * (float)base.width;
+        const simd_float8 screenRow = (0.5f - clipY * invW * 0.5f) * (float)base.height;
+        const float minX = sReduceMin(screenX);
+        const float maxX = sReduceMax(screenX);
+        const float minRow = sReduceMin(screenRow);
+        const float maxRow = sReduceMax(screenRow);
+        const float nearestZ = sReduceMin(clipZ * invW);
+        if (maxX < 0.f || minX >= base.width || maxRow < 0.f || minRow >= base.height || nearestZ > 1.f)
+            return (false);
+
+        const uint32_t px0 = (uint32_t)std::max(minX, 0.f);
+        const uint32_t px1 = (uint32_t)std::min(maxX, base.width - 1.f);
+        const uint32_t py0 = (uint32_t)std::max(minRow, 0.f);
+        const uint32_t py1 = (uint32_t)std::min(maxRow, base.height - 1.f);
+        uint32_t l = 0;
+        while (l + 1 < _levels.size() && ((px1 >> l) - (px0 >> l) >= 4 || (py1 >> l) - (py0 >> l) >= 4))
+            ++l;
+
+        const Level& level = _levels[l];
+        float farthest = 0.f;
+        for (uint32_t ty = py0 >> l; ty <= (py1 >> l); ++ty)
+        {
+            for (uint32_t tx = px0 >> l; tx <= (px1 >> l); ++tx)
+                farthest = std::max(farthest, level.depth[ty * level.width + tx]);
+        }
+        return (nearestZ <= farthest);
+    }
+
+    size_t OcclusionCuller::cull(const AabbSoA& boxes, const uint32_t* pCandidates, size_t candidateCount, std::vector<uint32_t>& visibleIndices)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        if (_lastVisibleFrame.size() < boxes.count)
+            _lastVisibleFrame.resize(boxes.count, 0);
+        _candidateVisible.resize(candidateCount);
+
+        constexpr size_t kCandidatesPerTask = 1024;
+        std::atomic<uint64_t> tested(0);
+        parallel::parallelFor((candidateCount + kCandidatesPerTask - 1) / kCandidatesPerTask, [&](size_t task)
+        {
+            const size_t end = std::min(candidateCount, (task + 1) * kCandidatesPerTask);
+            uint64_t taskTested = 0;
+            for (size_t c = task * kCandidatesPerTask; c < end; ++c)
+            {
+                const uint32_t index = pCandidates[c];
+                const bool reuse = _settings.revalidateFrames > 0 && _lastVisibleFrame[index] + 1 == _frame
+                                   && (index + _frame) % _settings.revalidateFrames != 0;
+                if (reuse)
+                {
+                    _candidateVisible[c] = 1;
+                    continue;
+                }
+                ++taskTested;
+                _candidateVisible[c] = isVisible(simd_make_float3(boxes.pCenterX[index], boxes.pCenterY[index], boxes.pCenterZ[index]),
+                                                 simd_make_float3(boxes.pExtentX[index], boxes.pExtentY[index], boxes.pExtentZ[index]));
+            }
+            tested.fetch_add(taskTested, std::memory_order_relaxed);
+        }, _settings.threadCount);
+
+        visibleIndices.clear();
+        for (size_t c = 0; c < candidateCount; ++c)
+        {
+            if (!_candidateVisible[c])
+                continue;
+            visibleIndices.push_back(pCandidates[c]);
+            _lastVisibleFrame[pCandidates[c]] = _frame;
+        }
+
+        _stats.candidates = candidateCount;
+        _stats.tested = tested.load();
+        _stats.visible = visibleIndices.size();
+        _stats.testMs = sMillisecondsSince(start);
+        return (visibleIndices.size());
+    }
+
+    const float* OcclusionCuller::level(uint32_t i, uint32_t& width, uint32_t& height) const
+    {
+        width = _levels[i].width;
+        height = _levels[i].height;
+        return (_levels[i].depth.data());
+    }
+
+    void benchmarkOcclusion(FILE* out)
+    {
+        constexpr int kRuns = 5;
+        constexpr int kReuseFrames = 8;
+        constexpr uint32_t kBlocks = 10;
+        const size_t counts[] = { 10000, 100000, 1000000 };
+
+        RMDLCamera camera;
+        camera.initPerspectiveWithPosition(simd::float3{ 0.f, 2.f, 0.f }, simd::float3{ 0.f, 0.f, 1.f },
+                                           simd::float3{ 0.f, 1.f, 0.f }, (float)M_PI / 3.f, 16.f / 9.f, 0.1f, 500.f);
+        const simd_float4x4 viewProjection = camera.ViewProjectionMatrix();
+        const Frustum frustum = Frustum::fromCamera(camera);
+
+        // Buildings 16 units across on a 24 unit grid from 30 units ahead, so streets stay open
+        // between them. One cube mesh, scaled and placed by each occluder's transform.
+        const float cube[8][3] = { { -1.f, -1.f, -1.f }, { 1.f, -1.f, -1.f }, { -1.f, 1.f, -1.f }, { 1.f, 1.f, -1.f },
+                                   { -1.f, -1.f, 1.f }, { 1.f, -1.f, 1.f }, { -1.f, 1.f, 1.f }, { 1.f, 1.f, 1.f } };
+        const uint32_t cubeIndices[36] = { 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 2, 6, 0, 6, 4,
+                                           1, 5, 7, 1, 7, 3, 0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6 };
+        std::mt19937 buildingRng(3);
+        std::uniform_real_distribution<float> buildingHeight(4.f, 15.f);
+        std::vector<Occluder> buildings;
+        for (uint32_t bz = 0; bz < kBlocks; ++bz)
+        {
+            for (uint32_t bx = 0; bx < kBlocks; ++bx)
+            {
+                const float halfHeight = buildingHeight(buildingRng);
+                simd_float4x4 transform = matrix_identity_float4x4;
+                transform.columns[0].x = 8.f;
+                transform.columns[1].y = halfHeight;
+                transform.columns[2].z = 8.f;
+                transform.columns[3] = simd_make_float4(((float)bx - (kBlocks - 1) * 0.5f) * 24.f, halfHeight, 38.f + (float)bz * 24.f, 1.f);
+                buildings.push_back(Occluder{ cube, sizeof(cube[0]), cubeIndices, 36, transform });
+            }
+        }
+
+        OcclusionSettings everyFrame;
+        everyFrame.revalidateFrames = 0;
+        OcclusionCuller full(everyFrame);
+        OcclusionCuller reuse;
+        auto rasterize = [&](OcclusionCuller& culler)
+        {
+            culler.beginFrame(viewProjection);
+            for (const Occluder& building : buildings)
+                culler.addOccluder(building);
+            culler.rasterizeOccluders();
+        };
+
+        fprintf(out, "%10s %10s %10s %10s %10s %10s %10s %10s %10s %8s\n",
+                "boxes", "in frustum", "visible", "occ tris", "raster ms", "hi-z ms", "test ms", "reuse ms", "tested", "wrong");
+        for (size_t count : counts)
+        {
+            // Crates and props scattered over the streets and behind the buildings.
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> across(-150.f, 150.f);
+            std::uniform_real_distribution<float> ahead(1.f, 400.f);
+            std::uniform_real_distribution<float> up(0.f, 10.f);
+            std::uniform_real_distribution<float> extent(0.25f, 1.5f);
+            std::vector<float> cx(count), cy(count), cz(count), ex(count), ey(count), ez(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                cx[i] = across(rng);
+                cy[i] = up(rng);
+                cz[i] = ahead(rng);
+                ex[i] = extent(rng);
+                ey[i] = extent(rng);
+                ez[i] = extent(rng);
+            }
+            const AabbSoA boxes = { cx.data(), cy.data(), cz.data(), ex.data(), ey.data(), ez.data(), count };
+            std::vector<uint32_t> candidates;
+            FrustumCuller().cull(frustum, boxes, candidates);
+
+            double rasterMs = 1e30;
+            double hiZMs = 1e30;
+            double testMs = 1e30;
+            std::vector<uint32_t> visible;
+            for (int run = 0; run < kRuns; ++run)
+            {
+                rasterize(full);
+                rasterMs = std::min(rasterMs, full.stats().rasterMs);
+                hiZMs = std::min(hiZMs, full.stats().hiZMs);
+                full.cull(boxes, candidates.data(), candidates.size(), visible);
+                testMs = std::min(testMs, full.stats().testMs);
+            }
+
+            // Steady state of a still camera: most visible boxes are taken from the last frame.
+            double reuseMs = 1e30;
+            uint64_t tested = 0;
+            std::vector<uint32_t> reused;
+            size_t notReused = 0;
+            for (int frame = 0; frame < kReuseFrames; ++frame)
+            {
+                rasterize(reuse);
+                reuse.cull(boxes, candidates.data(), candidates.size(), reused);
+                if (frame < kReuseFrames / 2)
+                    continue;
+                reuseMs = std::min(reuseMs, reuse.stats().testMs);
+                tested = reuse.stats().tested;
+                notReused += !std::includes(reused.begin(), reused.end(), visible.begin(), visible.end());
+            }
+
+            // A box is hidden only if its nearest depth is behind every texel of the full-size
+            // depth buffer under it; the pyramid can only be more conservative than that. Ties
+            // within rounding of the projection are boxes touching an occluder face.
+            uint32_t baseWidth = 0;
+            uint32_t baseHeight = 0;
+            const float* pDepth = full.level(0, baseWidth, baseHeight);
+            size_t wrong = notReused;
+            size_t next = 0;
+            for (uint32_t index : candidates)
+            {
+                if (next < visible.size() && visible[next] == index)
+                {
+                    ++next;
+                    continue;
+                }
+                float nearestZ = 1.f;
+                float minX = (float)baseWidth;
+                float maxX = 0.f;
+                float minRow = (float)baseHeight;
+                float maxRow = 0.f;
+                for (int corner = 0; corner < 8; ++corner)
+                {
+                    const simd_float4 p = simd_mul(viewProjection, simd_make_float4(cx[index] + (corner & 1 ? ex[index] : -ex[index]),
+                                                                                    cy[index] + (corner & 2 ? ey[index] : -ey[index]),
+                                                                                    cz[index] + (corner & 4 ? ez[index] : -ez[index]), 1.f));
+                    nearestZ = std::min(nearestZ, p.z / p.w);
+                    minX = std::min(minX, (p.x / p.w * 0.5f + 0.5f) * (float)baseWidth);
+                    maxX = std::max(maxX, (p.x / p.w * 0.5f + 0.5f) * (float)baseWidth);
+                    minRow = std::min(minRow, (0.5f - p.y / p.w * 0.5f) * (float)baseHeight);
+                    maxRow = std::max(maxRow, (0.5f - p.y / p.w * 0.5f) * (float)baseHeight);
+                }
+                if (maxX < 0.f || minX >= (float)baseWidth || maxRow < 0.f || minRow >= (float)baseHeight)
+                    continue;
+                float farthest = 0.f;
+                for (uint32_t y = (uint32_t)std::max(minRow, 0.f); y <= (uint32_t)std::min(maxRow, baseHeight - 1.f); ++y)
+                {
+                    for (uint32_t x = (uint32_t)std::max(minX, 0.f); x <= (uint32_t)std::min(maxX, baseWidth - 1.f); ++x)
+                        farthest = std::max(farthest, pDepth[y * baseWidth + x]);
+                }
+                wrong += nearestZ < farthest - 1e-6f;
+            }
+
+            fprintf(out, "%10zu %10zu %10zu %10llu %10.3f %10.3f %10.3f %10.3f %10llu %8zu%s\n",
+                    count, candidates.size(), visible.size(), (unsigned long long)full.stats().occluderTriangles,
+                    rasterMs, hiZMs, testMs, reuseMs, (unsigned long long)tested, wrong, wrong ? "  MISMATCH" : "");
+        }
+    }
+}
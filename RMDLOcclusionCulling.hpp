@@ -0,0 +1,129 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLOcclusionCulling.hpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 17:18:26      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLOCCLUSIONCULLING_HPP
+# define RMDLOCCLUSIONCULLING_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstddef>
+# include <cstdint>
+# include <cstdio>
+# include <vector>
+
+# include "RMDLFrustumCulling.hpp"
+# include "RMDLPointInTriangle.hpp"
+
+namespace culling
+{
+    struct OcclusionSettings
+    {
+        uint32_t    width = 320;            // depth buffer size; a fraction of the screen
+        uint32_t    height = 192;
+        uint32_t    revalidateFrames = 4;   // 0: test every candidate every frame
+        unsigned    threadCount = 0;
+    };
+
+    /// An occluder mesh: float3 positions at pPositions + i * stride, 32-bit triangle indices.
+    struct Occluder
+    {
+        const void*     pPositions;
+        size_t          stride;
+        const uint32_t* pIndices;
+        uint32_t        indexCount;
+        simd_float4x4   transform;  // model to world
+    };
+
+    struct OcclusionStats
+    {
+        uint64_t    occluderTriangles;
+        uint64_t    candidates;
+        uint64_t    tested;         // the rest were reused from last frame
+        uint64_t    visible;
+        double      rasterMs;       // triangle setup and the depth buffer
+        double      hiZMs;          // the max-depth pyramid over it
+        double      testMs;
+    };
+
+    /// CPU occlusion culling against a low-resolution depth buffer.
+    ///
+    /// Each frame: beginFrame() with RMDLCameraUniforms::viewProjectionMatrix, addOccluder() for the
+    /// large occluders (walls, buildings, terrain), rasterizeOccluders(), then cull() the candidates
+    /// that survived frustum culling.
+    ///
+    /// Occluders are rasterized depth-only in 32x32 tiles, one tile per task, eight pixels at a time
+    /// with hit_test::coverage8, keeping the nearest depth (Metal's [0, 1]). A max-depth pyramid
+    /// (hierarchical Z) is built over it; a box is hidden when its nearest projected depth is behind
+    /// the farthest depth under its screen rectangle, read from the level where the rectangle spans
+    /// at most a few texels. Boxes crossing the near plane are always visible, boxes entirely off
+    /// screen never are.
+    ///
+    /// Temporal coherence: a candidate visible last frame is accepted again without a test, except
+    /// on one frame in revalidateFrames (staggered by index), so hidden objects drop out within a
+    /// few frames while most visible ones skip the test. The result is never less than the true
+    /// visible set, only sometimes a few frames larger.
+    class OcclusionCuller
+    {
+    public:
+        explicit OcclusionCuller(const OcclusionSettings& settings = OcclusionSettings());
+
+        void    beginFrame(const simd_float4x4& viewProjection);
+        void    addOccluder(const Occluder& occluder);
+        void    rasterizeOccluders();
+
+        /// pCandidates index boxes, and also identify objects across frames for the temporal reuse.
+        size_t  cull(const AabbSoA& boxes, const uint32_t* pCandidates, size_t candidateCount, std::vector<uint32_t>& visibleIndices);
+        bool    isVisible(simd_float3 center, simd_float3 extent) const;
+
+        uint32_t        width() const { return (_settings.width); }
+        uint32_t        height() const { return (_settings.height); }
+        uint32_t        levelCount() const { return ((uint32_t)_levels.size()); }
+        /// Level 0 is the depth buffer itself, rows top to bottom.
+        const float*    level(uint32_t i, uint32_t& width, uint32_t& height) const;
+        const OcclusionStats&   stats() const { return (_stats); }
+
+    private:
+        struct Triangle
+        {
+            hit_test::EdgeFunctions edges;
+            float       invArea;
+            float       z[3];
+            int32_t     minX, minY, maxX, maxY;     // pixels, rows top to bottom, inclusive
+        };
+
+        struct Level
+        {
+            uint32_t            width;
+            uint32_t            height;
+            std::vector<float>  depth;
+        };
+
+        void    setupOccluder(const Occluder& occluder, std::vector<Triangle>& triangles) const;
+        void    rasterTile(uint32_t tileX, uint32_t tileY);
+        void    buildHiZ();
+
+        OcclusionSettings       _settings;
+        simd_float4x4           _viewProjection;
+        std::vector<Occluder>   _occluders;
+        std::vector<Triangle>   _triangles;
+        std::vector<Level>      _levels;
+        std::vector<uint32_t>   _lastVisibleFrame;
+        std::vector<uint8_t>    _candidateVisible;
+        uint32_t                _frame;
+        OcclusionStats          _stats;
+    };
+
+    /// Culls 10k to 1M boxes that survived frustum culling behind a 10x10 block of buildings,
+    /// testing every candidate and then with temporal reuse, and prints the raster, Hi-Z and test
+    /// times to out. Hidden boxes are checked against the full-resolution depth buffer, and the
+    /// reuse frames against the full test.
+    void    benchmarkOcclusion(FILE* out);
+}
+
+#endif /* RMDLOCCLUSIONCULLING_HPP */
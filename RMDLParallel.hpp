@@ -0,0 +1,45 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLParallel.hpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 13:21:08      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPARALLEL_HPP
+# define RMDLPARALLEL_HPP
+
+# include <algorithm>
+# include <cstddef>
+# include <thread>
+
+# include "RMDLJobSystem.hpp"
+
+namespace parallel
+{
+    inline unsigned defaultThreadCount()
+    {
+        return (std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    /// Calls fn(i) for every i in [0, count) on the shared job system, which splits the range
+    /// adaptively and lets idle workers steal halves of it, so uneven work balances itself. The
+    /// calling thread takes part and runs other queued jobs until all are done, so this may be
+    /// called from inside a job. threadCount caps the threads working on the range, the caller
+    /// included: 0 uses every worker, 1 runs everything on the caller, in order.
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn, unsigned threadCount = 0)
+    {
+        if (threadCount == 1 || count <= 1)
+        {
+            for (size_t i = 0; i < count; ++i)
+                fn(i);
+            return;
+        }
+        jobs::JobSystem::shared().parallelFor(count, fn, 0, threadCount);
+    }
+}
+
+#endif /* RMDLPARALLEL_HPP */
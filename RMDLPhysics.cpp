@@ -8,8 +8,1200 @@
 /*                                                           */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
-#include "RMDLGame.hpp"
+#include "RMDLPhysics.hpp"
 
-void RMDLGame::updateCollisions()
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace
 {
+    using float3 = simd::float3;
+    using float4 = simd::float4;
+
+    constexpr uint32_t kMaxContactsPerPair = 4;
+    constexpr float kWarmStartMatchDistance = 0.05f;
+    // Contacts are made this far before the shapes touch (negative depth). The solver lets such
+    // a contact close its gap within the step but no further, so a body rocking on an edge is
+    // caught as it comes back down instead of hitting and bouncing.
+    constexpr float kContactMargin = 0.02f;
+
+    struct Shape
+    {
+        physics::ShapeType  type;
+        float3              center;
+        const float3*       pAxis[3];
+        float3              size;
+    };
+
+    struct ManifoldOut
+    {
+        float3      normal;     // from the first shape to the second
+        float3      point[8];
+        float       depth[8];
+        uint32_t    count;
+    };
+
+    float3 sRotate(float4 q, float3 v)
+    {
+        const float3 u = simd_make_float3(q.x, q.y, q.z);
+        return (v + simd_cross(u, simd_cross(u, v) + v * q.w) * 2.f);
+    }
+
+    float4 sNormalizeQuat(float4 q)
+    {
+        return (q * (1.f / sqrtf(simd_dot(q, q))));
+    }
+
+    float3 sAxis(const Shape& s, int i)
+    {
+        return (*s.pAxis[i]);
+    }
+
+    float3 sOrthogonal(float3 n)
+    {
+        if (fabsf(n.x) >= 0.57735f)
+            return (simd_normalize(simd_make_float3(n.y, -n.x, 0.f)));
+        return (simd_normalize(simd_make_float3(0.f, n.z, -n.y)));
+    }
+
+    void sAddContact(ManifoldOut& out, float3 point, float depth)
+    {
+        out.point[out.count] = point;
+        out.depth[out.count] = depth;
+        ++out.count;
+    }
+
+    // Closest points between segments p1q1 and p2q2 (Ericson, Real-Time Collision Detection 5.1.9).
+    void sClosestSegmentSegment(float3 p1, float3 q1, float3 p2, float3 q2, float3& c1, float3& c2)
+    {
+        const float3 d1 = q1 - p1;
+        const float3 d2 = q2 - p2;
+        const float3 r = p1 - p2;
+        const float a = simd_dot(d1, d1);
+        const float e = simd_dot(d2, d2);
+        const float f = simd_dot(d2, r);
+        float s = 0.f;
+        float t = 0.f;
+        if (a <= 1e-12f && e <= 1e-12f)
+        {
+        }
+        else if (a <= 1e-12f)
+            t = std::clamp(f / e, 0.f, 1.f);
+        else
+        {
+            const float c = simd_dot(d1, r);
+            if (e <= 1e-12f)
+                s = std::clamp(-c / a, 0.f, 1.f);
+            else
+            {
+                const float b = simd_dot(d1, d2);
+                const float denom = a * e - b * b;
+                s = denom > 1e-12f ? std::clamp((b * f - c * e) / denom, 0.f, 1.f) : 0.f;
+                t = (b * s + f) / e;
+                if (t < 0.f)
+                {
+                    t = 0.f;
+                    s = std::clamp(-c / a, 0.f, 1.f);
+                }
+                else if (t > 1.f)
+                {
+                    t = 1.f;
+                    s = std::clamp((b - c) / a, 0.f, 1.f);
+                }
+            }
+        }
+        c1 = p1 + d1 * s;
+        c2 = p2 + d2 * t;
+    }
+
+    float3 sClosestOnSegment(float3 p, float3 q, float3 x)
+    {
+        const float3 d = q - p;
+        const float len2 = simd_dot(d, d);
+        const float t = len2 > 1e-12f ? std::clamp(simd_dot(x - p, d) / len2, 0.f, 1.f) : 0.f;
+        return (p + d * t);
+    }
+
+    void sSegment(const Shape& capsule, float3& p, float3& q)
+    {
+        p = capsule.center - sAxis(capsule, 1) * capsule.size.y;
+        q = capsule.center + sAxis(capsule, 1) * capsule.size.y;
+    }
+
+    // Two spheres; the normal goes from a to b.
+    bool sSphereSphere(float3 a, float ra, float3 b, float rb, ManifoldOut& out)
+    {
+        const float3 d = b - a;
+        const float dist2 = simd_dot(d, d);
+        if (dist2 >= (ra + rb + kContactMargin) * (ra + rb + kContactMargin))
+            return (false);
+        const float dist = sqrtf(dist2);
+        out.normal = dist > 1e-6f ? d * (1.f / dist) : simd_make_float3(0.f, 1.f, 0.f);
+        const float depth = ra + rb - dist;
+        sAddContact(out, a + out.normal * (ra - depth * 0.5f), depth);
+        return (true);
+    }
+
+    float3 sClampToBox(const Shape& box, float3 x)
+    {
+        const float3 d = x - box.center;
+        float3 closest = box.center;
+        for (int i = 0; i < 3; ++i)
+            closest += sAxis(box, i) * std::clamp(simd_dot(d, sAxis(box, i)), -box.size[i], box.size[i]);
+        return (closest);
+    }
+
+    // A sphere against a box; the normal goes from the sphere to the box.
+    bool sSphereBox(float3 c, float r, const Shape& box, ManifoldOut& out)
+    {
+        const float3 closest = sClampToBox(box, c);
+        const float3 d = closest - c;
+        const float dist2 = simd_dot(d, d);
+        if (dist2 > 1e-12f)
+        {
+            if (dist2 >= (r + kContactMargin) * (r + kContactMargin))
+                return (false);
+            const float dist = sqrtf(dist2);
+            out.normal = d * (1.f / dist);
+            sAddContact(out, (c + out.normal * r + closest) * 0.5f, r - dist);
+            return (true);
+        }
+        // The center is inside: push out through the nearest face.
+        const float3 local = c - box.center;
+        int face = 0;
+        float faceDistance = 1e30f;
+        for (int i = 0; i < 3; ++i)
+        {
+            const float distance = box.size[i] - fabsf(simd_dot(local, sAxis(box, i)));
+            if (distance < faceDistance)
+            {
+                faceDistance = distance;
+                face = i;
+            }
+        }
+        const float side = simd_dot(local, sAxis(box, face)) < 0.f ? -1.f : 1.f;
+        out.normal = sAxis(box, face) * -side;
+        sAddContact(out, c, r + faceDistance);
+        return (true);
+    }
+
+    bool sCapsuleBox(const Shape& capsule, const Shape& box, ManifoldOut& out)
+    {
+        float3 p, q;
+        sSegment(capsule, p, q);
+        const float r = capsule.size.x;
+
+        // The segment point closest to the box, by alternating projections.
+        float3 onSegment = sClosestOnSegment(p, q, box.center);
+        for (int i = 0; i < 3; ++i)
+            onSegment = sClosestOnSegment(p, q, sClampToBox(box, onSegment));
+        ManifoldOut primary;
+        primary.count = 0;
+        if (!sSphereBox(onSegment, r, box, primary))
+            return (false);
+
+        // Both ends touching along the same normal, as a capsule lying on a face, give two
+        // contacts to rest on rather than one to rock about.
+        out.normal = primary.normal;
+        for (const float3& end : { p, q })
+        {
+            ManifoldOut cap;
+            cap.count = 0;
+            if (sSphereBox(end, r, box, cap) && simd_dot(cap.normal, primary.normal) > 0.95f)
+                sAddContact(out, cap.point[0], cap.depth[0]);
+        }
+        if (out.count == 0)
+            sAddContact(out, primary.point[0], primary.depth[0]);
+        return (true);
+    }
+
+    bool sCapsuleCapsule(const Shape& a, const Shape& b, ManifoldOut& out)
+    {
+        float3 pa, qa, pb, qb, ca, cb;
+        sSegment(a, pa, qa);
+        sSegment(b, pb, qb);
+        sClosestSegmentSegment(pa, qa, pb, qb, ca, cb);
+        ManifoldOut primary;
+        primary.count = 0;
+        if (!sSphereSphere(ca, a.size.x, cb, b.size.x, primary))
+            return (false);
+
+        out.normal = primary.normal;
+        const float3 da = qa - pa;
+        const float3 db = qb - pb;
+        const float lengths = sqrtf(simd_dot(da, da) * simd_dot(db, db));
+        if (lengths > 1e-6f && fabsf(simd_dot(da, db)) > 0.99f * lengths)
+        {
+            // Side by side: contacts at the ends of the overlap, measured along the normal.
+            const float3 ends[4][2] = { { pa, sClosestOnSegment(pb, qb, pa) }, { qa, sClosestOnSegment(pb, qb, qa) },
+                                        { sClosestOnSegment(pa, qa, pb), pb }, { sClosestOnSegment(pa, qa, qb), qb } };
+            for (const auto& end : ends)
+            {
+                const float reach = a.size.x + b.size.x + kContactMargin;
+                if (simd_length_squared(end[1] - end[0]) >= reach * reach)
+                    continue;
+                const float depth = a.size.x + b.size.x - simd_dot(end[1] - end[0], out.normal);
+                const float3 point = (end[0] + end[1]) * 0.5f;
+                bool duplicate = false;
+                for (uint32_t k = 0; k < out.count; ++k)
+                    duplicate |= simd_length_squared(out.point[k] - point) < 1e-6f;
+                if (depth > -kContactMargin && !duplicate && out.count < kMaxContactsPerPair)
+                    sAddContact(out, point, depth);
+            }
+        }
+        if (out.count == 0)
+            sAddContact(out, primary.point[0], primary.depth[0]);
+        return (true);
+    }
+
+    // Sutherland-Hodgman against the half space dot(n, x) <= offset.
+    uint32_t sClip(const float3* pIn, uint32_t count, float3 n, float offset, float3* pOut)
+    {
+        uint32_t written = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float3 a = pIn[i];
+            const float3 b = pIn[(i + 1) % count];
+            const float da = simd_dot(n, a) - offset;
+            const float db = simd_dot(n, b) - offset;
+            if (da <= 0.f)
+                pOut[written++] = a;
+            if ((da < 0.f && db > 0.f) || (da > 0.f && db < 0.f))
+                pOut[written++] = a + (b - a) * (da / (da - db));
+        }
+        return (written);
+    }
+
+    // Keeps the deepest point, the one farthest from it, and the two that add the most area.
+    void sReduceContacts(ManifoldOut& m)
+    {
+        if (m.count <= kMaxContactsPerPair)
+            return;
+        uint32_t keep[4];
+        keep[0] = 0;
+        for (uint32_t i = 1; i < m.count; ++i)
+            keep[0] = m.depth[i] > m.depth[keep[0]] ? i : keep[0];
+        auto farthest = [&](auto score)
+        {
+            uint32_t best = 0;
+            float bestScore = -1.f;
+            for (uint32_t i = 0; i < m.count; ++i)
+            {
+                const float s = score(m.point[i]);
+                if (s > bestScore)
+                {
+                    bestScore = s;
+                    best = i;
+                }
+            }
+            return (best);
+        };
+        const float3 p0 = m.point[keep[0]];
+        keep[1] = farthest([&](float3 p) { return (simd_length_squared(p - p0)); });
+        const float3 p1 = m.point[keep[1]];
+        keep[2] = farthest([&](float3 p) { return (simd_length_squared(simd_cross(p - p0, p1 - p0))); });
+        const float3 p2 = m.point[keep[2]];
+        // The fourth goes on the other side of the triangle from the third.
+        const float3 side = simd_cross(p1 - p0, m.normal);
+        const float thirdSide = simd_dot(p2 - p0, side);
+        keep[3] = farthest([&](float3 p)
+        {
+            const float s = simd_dot(p - p0, side);
+            return ((s * thirdSide < 0.f) ? simd_length_squared(simd_cross(p - p0, p1 - p0)) : -0.5f);
+        });
+        ManifoldOut reduced = m;
+        reduced.count = 0;
+        for (uint32_t k = 0; k < 4; ++k)
+        {
+            bool duplicate = false;
+            for (uint32_t j = 0; j < k; ++j)
+                duplicate |= keep[j] == keep[k];
+            if (!duplicate)
+                sAddContact(reduced, m.point[keep[k]], m.depth[keep[k]]);
+        }
+        m = reduced;
+    }
+
+    // Separating axis test over the 15 axes, then clipping of the incident face against the
+    // reference face, or one edge / edge contact.
+    bool sBoxBox(const Shape& a, const Shape& b, ManifoldOut& out)
+    {
+        const float3 t = b.center - a.center;
+        auto separation = [&](float3 axis, float3& oriented)
+        {
+            float ra = 0.f;
+            float rb = 0.f;
+            for (int k = 0; k < 3; ++k)
+            {
+                ra += a.size[k] * fabsf(simd_dot(sAxis(a, k), axis));
+                rb += b.size[k] * fabsf(simd_dot(sAxis(b, k), axis));
+            }
+            const float distance = simd_dot(t, axis);
+            oriented = distance < 0.f ? -axis : axis;
+            return (fabsf(distance) - (ra + rb));
+        };
+
+        struct Candidate
+        {
+            float   separation = -1e30f;
+            float3  axis = simd_make_float3(0.f, 1.f, 0.f);
+            int     i = 0;
+            int     j = 0;
+        };
+        Candidate faceA, faceB, edge;
+        for (int i = 0; i < 3; ++i)
+        {
+            float3 axis;
+            const float s = separation(sAxis(a, i), axis);
+            if (s > kContactMargin)
+                return (false);
+            if (s > faceA.separation)
+                faceA = { s, axis, i, 0 };
+        }
+        for (int j = 0; j < 3; ++j)
+        {
+            float3 axis;
+            const float s = separation(sAxis(b, j), axis);
+            if (s > kContactMargin)
+                return (false);
+            if (s > faceB.separation)
+                faceB = { s, axis, 0, j };
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                float3 axis = simd_cross(sAxis(a, i), sAxis(b, j));
+                const float length2 = simd_dot(axis, axis);
+                if (length2 < 1e-6f)
+                    continue;   // parallel edges; the face axes cover them
+                const float s = separation(axis * (1.f / sqrtf(length2)), axis);
+                if (s > kContactMargin)
+                    return (false);
+                if (s > edge.separation)
+                    edge = { s, axis, i, j };
+            }
+        }
+
+        // Faces of a, then faces of b, then edges, each only when clearly shallower, so resting
+        // contacts keep the same reference face from one step to the next.
+        Candidate best = faceA;
+        int bestKind = 0;   // 0: face of a, 1: face of b, 2: edge pair
+        if (faceB.separation > 0.95f * best.separation + 0.01f)
+        {
+            best = faceB;
+            bestKind = 1;
+        }
+        if (edge.separation > 0.95f * best.separation + 0.01f)
+        {
+            best = edge;
+            bestKind = 2;
+        }
+        const float3 bestAxis = best.axis;
+        const float bestSeparation = best.separation;
+        const int bestA = best.i;
+        const int bestB = best.j;
+
+        out.normal = bestAxis;
+        if (bestKind == 2)
+        {
+            // The edges of a and b parallel to the two axes that are furthest along the normal.
+            float3 pa = a.center;
+            float3 pb = b.center;
+            for (int k = 0; k < 3; ++k)
+            {
+                if (k != bestA)
+                    pa += sAxis(a, k) * (simd_dot(sAxis(a, k), bestAxis) > 0.f ? a.size[k] : -a.size[k]);
+                if (k != bestB)
+                    pb += sAxis(b, k) * (simd_dot(sAxis(b, k), bestAxis) < 0.f ? b.size[k] : -b.size[k]);
+            }
+            float3 ca, cb;
+            sClosestSegmentSegment(pa - sAxis(a, bestA) * a.size[bestA], pa + sAxis(a, bestA) * a.size[bestA],
+                                   pb - sAxis(b, bestB) * b.size[bestB], pb + sAxis(b, bestB) * b.size[bestB], ca, cb);
+            sAddContact(out, (ca + cb) * 0.5f, -bestSeparation);
+            return (true);
+        }
+
+        // Reference face on one box, incident face on the other: the face of the other box whose
+        // normal is most opposed to the reference one.
+        const Shape& reference = bestKind == 0 ? a : b;
+        const Shape& incident = bestKind == 0 ? b : a;
+        const int referenceFace = bestKind == 0 ? bestA : bestB;
+        const float3 referenceNormal = bestKind == 0 ? bestAxis : -bestAxis;   // out of the reference box
+
+        int incidentFace = 0;
+        float mostOpposed = 1e30f;
+        for (int k = 0; k < 3; ++k)
+        {
+            const float d = simd_dot(sAxis(incident, k), referenceNormal);
+            if (-fabsf(d) < mostOpposed)
+            {
+                mostOpposed = -fabsf(d);
+                incidentFace = k;
+            }
+        }
+        const float incidentSign = simd_dot(sAxis(incident, incidentFace), referenceNormal) > 0.f ? -1.f : 1.f;
+        const float3 incidentCenter = incident.center + sAxis(incident, incidentFace) * (incidentSign * incident.size[incidentFace]);
+        const int iu = (incidentFace + 1) % 3;
+        const int iv = (incidentFace + 2) % 3;
+        const float3 u = sAxis(incident, iu) * incident.size[iu];
+        const float3 v = sAxis(incident, iv) * incident.size[iv];
+        float3 polygon[8] = { incidentCenter + u + v, incidentCenter - u + v, incidentCenter - u - v, incidentCenter + u - v };
+        float3 clipped[8];
+        uint32_t count = 4;
+
+        for (int side = 1; side <= 2 && count; ++side)
+        {
+            const int k = (referenceFace + side) % 3;
+            const float3 axis = sAxis(reference, k);
+            const float center = simd_dot(axis, reference.center);
+            count = sClip(polygon, count, axis, center + reference.size[k], clipped);
+            count = sClip(clipped, count, -axis, -center + reference.size[k], polygon);
+        }
+
+        const float faceOffset = simd_dot(referenceNormal, reference.center) + reference.size[referenceFace];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float depth = faceOffset - simd_dot(referenceNormal, polygon[i]);
+            if (depth >= -kContactMargin)
+                sAddContact(out, polygon[i] + referenceNormal * (depth * 0.5f), depth);
+        }
+        sReduceContacts(out);
+        return (out.count > 0);
+    }
+
+    // Shapes in ShapeType order, a.type <= b.type.
+    bool sCollide(const Shape& a, const Shape& b, ManifoldOut& out)
+    {
+        using physics::ShapeType;
+        out.count = 0;
+        if (a.type == ShapeType::Sphere && b.type == ShapeType::Sphere)
+            return (sSphereSphere(a.center, a.size.x, b.center, b.size.x, out));
+        if (a.type == ShapeType::Sphere && b.type == ShapeType::Box)
+            return (sSphereBox(a.center, a.size.x, b, out));
+        if (a.type == ShapeType::Sphere && b.type == ShapeType::Capsule)
+        {
+            float3 p, q;
+            sSegment(b, p, q);
+            return (sSphereSphere(a.center, a.size.x, sClosestOnSegment(p, q, a.center), b.size.x, out));
+        }
+        if (a.type == ShapeType::Box && b.type == ShapeType::Box)
+            return (sBoxBox(a, b, out));
+        if (a.type == ShapeType::Box && b.type == ShapeType::Capsule)
+        {
+            if (!sCapsuleBox(b, a, out))
+                return (false);
+            out.normal = -out.normal;
+            return (true);
+        }
+        return (sCapsuleCapsule(a, b, out));
+    }
+}
+
+namespace physics
+{
+    RigidBodyWorld::RigidBodyWorld(const WorldSettings& settings)
+    : _settings(settings)
+    {
+    }
+
+    BodyId RigidBodyWorld::addBody(const BodyDesc& desc)
+    {
+        const BodyId body = (BodyId)_position.size();
+        const float3 size = desc.collider.size;
+        const bool isStatic = desc.mass <= 0.f;
+
+        // Solid inertia about the center. A capsule uses its bounding box, which is close enough
+        // for a solver that only needs the right order of magnitude.
+        float3 inertia;
+        if (desc.collider.type == ShapeType::Sphere)
+            inertia = simd_make_float3(1.f, 1.f, 1.f) * (0.4f * desc.mass * size.x * size.x);
+        else
+        {
+            const float3 half = desc.collider.type == ShapeType::Box ? size : simd_make_float3(size.x, size.y + size.x, size.x);
+            const float3 full2 = half * half * 4.f;
+            inertia = simd_make_float3(full2.y + full2.z, full2.x + full2.z, full2.x + full2.y) * (desc.mass / 12.f);
+        }
+
+        _position.push_back(desc.position);
+        _orientation.push_back(sNormalizeQuat(desc.orientation));
+        _linearVelocity.push_back(isStatic ? simd_make_float3(0.f, 0.f, 0.f) : desc.linearVelocity);
+        _angularVelocity.push_back(isStatic ? simd_make_float3(0.f, 0.f, 0.f) : desc.angularVelocity);
+        _invMass.push_back(isStatic ? 0.f : 1.f / desc.mass);
+        _invInertiaLocal.push_back(isStatic ? simd_make_float3(0.f, 0.f, 0.f)
+                                            : simd_make_float3(1.f / inertia.x, 1.f / inertia.y, 1.f / inertia.z));
+        _friction.push_back(desc.friction);
+        _shape.push_back(desc.collider.type);
+        _size.push_back(size);
+        return (body);
+    }
+
+    void RigidBodyWorld::clear()
+    {
+        _position.clear();
+        _orientation.clear();
+        _linearVelocity.clear();
+        _angularVelocity.clear();
+        _invMass.clear();
+        _invInertiaLocal.clear();
+        _friction.clear();
+        _shape.clear();
+        _size.clear();
+        _sweepOrder.clear();
+        _cacheKeys.clear();
+        _cacheFirst.assign(1, 0);
+        _cacheLocalPoint.clear();
+        _cacheImpulse.clear();
+        _stats = WorldStats();
+    }
+
+    void RigidBodyWorld::setVelocity(BodyId body, simd::float3 linear, simd::float3 angular)
+    {
+        if (_invMass[body] == 0.f)
+            return;
+        _linearVelocity[body] = linear;
+        _angularVelocity[body] = angular;
+    }
+
+    simd::float3 RigidBodyWorld::applyInvInertia(BodyId body, simd::float3 v) const
+    {
+        return (_invInertiaWorld[0][body] * v.x + _invInertiaWorld[1][body] * v.y + _invInertiaWorld[2][body] * v.z);
+    }
+
+    uint64_t RigidBodyWorld::stateHash() const
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        auto mix = [&](const void* pData, size_t bytes)
+        {
+            const uint8_t* p = (const uint8_t*)pData;
+            for (size_t i = 0; i < bytes; ++i)
+                hash = (hash ^ p[i]) * 0x100000001b3ull;
+        };
+        for (size_t i = 0; i < _position.size(); ++i)
+        {
+            const float values[13] = { _position[i].x, _position[i].y, _position[i].z,
+                                       _orientation[i].x, _orientation[i].y, _orientation[i].z, _orientation[i].w,
+                                       _linearVelocity[i].x, _linearVelocity[i].y, _linearVelocity[i].z,
+                                       _angularVelocity[i].x, _angularVelocity[i].y, _angularVelocity[i].z };
+            mix(values, sizeof(values));
+        }
+        return (hash);
+    }
+
+    void RigidBodyWorld::step(float dt)
+    {
+        using Clock = std::chrono::steady_clock;
+        auto elapsedMs = [](Clock::time_point start)
+        {
+            return (std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        };
+
+        _stats.bodies = _position.size();
+        if (_position.empty() || dt <= 0.f)
+            return;
+
+        auto start = Clock::now();
+        prepareBodies();
+        findPairs();
+        _stats.broadphaseMs = elapsedMs(start);
+
+        start = Clock::now();
+        generateContacts();
+        _stats.narrowphaseMs = elapsedMs(start);
+
+        start = Clock::now();
+        buildIslands();
+        setupConstraints();
+        _stats.islandMs = elapsedMs(start);
+
+        start = Clock::now();
+        const size_t islands = _islandStart.size() - 1;
+        parallel::parallelFor(islands, [this, dt](size_t island) { solveIsland(island, dt); }, _settings.threadCount);
+        cacheImpulses();
+        _stats.solveMs = elapsedMs(start);
+
+        start = Clock::now();
+        integrateFreeBodies(dt);
+        _stats.integrateMs = elapsedMs(start);
+    }
+
+    void RigidBodyWorld::prepareBodies()
+    {
+        const size_t count = _position.size();
+        for (int k = 0; k < 3; ++k)
+        {
+            _axis[k].resize(count);
+            _invInertiaWorld[k].resize(count);
+        }
+        _boundsMin.resize(count);
+        _boundsMax.resize(count);
+        _moved.resize(count);
+        _turned.resize(count);
+
+        parallel::parallelFor(count, [&](size_t i)
+        {
+            const float4 q = _orientation[i];
+            float3 axis[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                float3 unit = simd_make_float3(0.f, 0.f, 0.f);
+                unit[k] = 1.f;
+                axis[k] = sRotate(q, unit);
+                _axis[k][i] = axis[k];
+            }
+            // R diag(inv inertia) R^T, column by column.
+            const float3 d = _invInertiaLocal[i];
+            for (int c = 0; c < 3; ++c)
+                _invInertiaWorld[c][i] = axis[0] * (d.x * axis[0][c]) + axis[1] * (d.y * axis[1][c]) + axis[2] * (d.z * axis[2][c]);
+
+            // World bounds of the collider.
+            const float3 size = _size[i];
+            float3 extent;
+            if (_shape[i] == ShapeType::Sphere)
+                extent = simd_make_float3(size.x, size.x, size.x);
+            else if (_shape[i] == ShapeType::Box)
+                extent = simd_abs(axis[0]) * size.x + simd_abs(axis[1]) * size.y + simd_abs(axis[2]) * size.z;
+            else
+                extent = simd_abs(axis[1]) * size.y + simd_make_float3(size.x, size.x, size.x);
+            extent += kContactMargin;
+            _boundsMin[i] = _position[i] - extent;
+            _boundsMax[i] = _position[i] + extent;
+        }, _settings.threadCount);
+    }
+
+    void RigidBodyWorld::findPairs()
+    {
+        // Sort and sweep along x. The order is kept between steps, and bodies move little per
+        // step, so an insertion sort is close to linear; the index breaks ties, so the order is
+        // the same however it was reached.
+        const size_t count = _position.size();
+        auto before = [this](BodyId a, BodyId b)
+        {
+            return (_boundsMin[a].x < _boundsMin[b].x || (_boundsMin[a].x == _boundsMin[b].x && a < b));
+        };
+        if (_sweepOrder.size() != count)
+        {
+            _sweepOrder.resize(count);
+            for (BodyId i = 0; i < count; ++i)
+                _sweepOrder[i] = i;
+            std::sort(_sweepOrder.begin(), _sweepOrder.end(), before);
+        }
+        else
+        {
+            for (size_t i = 1; i < count; ++i)
+            {
+                const BodyId body = _sweepOrder[i];
+                size_t j = i;
+                for (; j > 0 && before(body, _sweepOrder[j - 1]); --j)
+                    _sweepOrder[j] = _sweepOrder[j - 1];
+                _sweepOrder[j] = body;
+            }
+        }
+
+        _pairs.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const BodyId a = _sweepOrder[i];
+            const float3 minA = _boundsMin[a];
+            const float3 maxA = _boundsMax[a];
+            for (size_t j = i + 1; j < count; ++j)
+            {
+                const BodyId b = _sweepOrder[j];
+                if (_boundsMin[b].x > maxA.x)
+                    break;
+                if ((_invMass[a] == 0.f && _invMass[b] == 0.f)
+                    || _boundsMin[b].y > maxA.y || _boundsMax[b].y < minA.y
+                    || _boundsMin[b].z > maxA.z || _boundsMax[b].z < minA.z)
+                    continue;
+                const BodyId lo = std::min(a, b);
+                const BodyId hi = std::max(a, b);
+                _pairs.push_back(Pair{ ((uint64_t)lo << 32) | hi, lo, hi });
+            }
+        }
+        std::sort(_pairs.begin(), _pairs.end(), [](const Pair& x, const Pair& y) { return (x.key < y.key); });
+        _stats.candidatePairs = _pairs.size();
+    }
+
+    void RigidBodyWorld::generateContacts()
+    {
+        const size_t pairCount = _pairs.size();
+        _pairNormal.resize(pairCount);
+        _pairContactCount.resize(pairCount);
+        _slotPoint.resize(pairCount * kMaxContactsPerPair);
+        _slotDepth.resize(pairCount * kMaxContactsPerPair);
+
+        parallel::parallelFor(pairCount, [&](size_t p)
+        {
+            BodyId a = _pairs[p].a;
+            BodyId b = _pairs[p].b;
+            const bool swapped = _shape[a] > _shape[b];
+            if (swapped)
+                std::swap(a, b);
+            auto shape = [this](BodyId body)
+            {
+                return (Shape{ _shape[body], _position[body], { &_axis[0][body], &_axis[1][body], &_axis[2][body] }, _size[body] });
+            };
+            ManifoldOut manifold;
+            _pairContactCount[p] = 0;
+            if (!sCollide(shape(a), shape(b), manifold))
+                return;
+            _pairNormal[p] = swapped ? -manifold.normal : manifold.normal;
+            _pairContactCount[p] = (uint8_t)manifold.count;
+            for (uint32_t k = 0; k < manifold.count; ++k)
+            {
+                _slotPoint[p * kMaxContactsPerPair + k] = manifold.point[k];
+                _slotDepth[p * kMaxContactsPerPair + k] = manifold.depth[k];
+            }
+        }, _settings.threadCount);
+    }
+
+    void RigidBodyWorld::buildIslands()
+    {
+        // Union-find over the dynamic bodies of touching pairs; the root of a set is its lowest
+        // body, so island numbering follows body order whatever order pairs are joined in.
+        const size_t count = _position.size();
+        _islandParent.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+            _islandParent[i] = i;
+        auto find = [this](uint32_t x)
+        {
+            while (_islandParent[x] != x)
+            {
+                _islandParent[x] = _islandParent[_islandParent[x]];
+                x = _islandParent[x];
+            }
+            return (x);
+        };
+
+        size_t manifoldCount = 0;
+        for (size_t p = 0; p < _pairs.size(); ++p)
+        {
+            if (!_pairContactCount[p])
+                continue;
+            ++manifoldCount;
+            const BodyId a = _pairs[p].a;
+            const BodyId b = _pairs[p].b;
+            if (_invMass[a] == 0.f || _invMass[b] == 0.f)
+                continue;
+            const uint32_t ra = find(a);
+            const uint32_t rb = find(b);
+            if (ra != rb)
+                _islandParent[std::max(ra, rb)] = std::min(ra, rb);
+        }
+
+        // Islands with contacts are numbered in the order of their lowest body.
+        _pairIsland.resize(_pairs.size());
+        _rootIsland.assign(count, UINT32_MAX);
+        for (size_t p = 0; p < _pairs.size(); ++p)
+        {
+            if (!_pairContactCount[p])
+                continue;
+            _pairIsland[p] = find(_invMass[_pairs[p].a] > 0.f ? _pairs[p].a : _pairs[p].b);
+            _rootIsland[_pairIsland[p]] = 0;
+        }
+        uint32_t islands = 0;
+        for (uint32_t root = 0; root < count; ++root)
+        {
+            if (_rootIsland[root] != UINT32_MAX)
+                _rootIsland[root] = islands++;
+        }
+
+        // Manifolds island by island, by a counting sort that keeps key order inside an island,
+        // then their contacts in the same order.
+        _islandManifoldStart.assign(islands + 1, 0);
+        for (size_t p = 0; p < _pairs.size(); ++p)
+        {
+            if (!_pairContactCount[p])
+                continue;
+            _pairIsland[p] = _rootIsland[_pairIsland[p]];
+            ++_islandManifoldStart[_pairIsland[p] + 1];
+        }
+        for (uint32_t i = 0; i < islands; ++i)
+            _islandManifoldStart[i + 1] += _islandManifoldStart[i];
+        _manifoldPairs.resize(manifoldCount);
+        for (size_t p = 0; p < _pairs.size(); ++p)
+        {
+            if (_pairContactCount[p])
+                _manifoldPairs[_islandManifoldStart[_pairIsland[p]]++] = (uint32_t)p;
+        }
+
+        _manifoldFirstContact.resize(_pairs.size());
+        _islandStart.assign(islands + 1, 0);
+        uint32_t contacts = 0;
+        size_t largest = 0;
+        for (uint32_t i = 0, m = 0; i < islands; ++i)
+        {
+            // _islandManifoldStart[i] now holds the end of island i.
+            _islandStart[i] = contacts;
+            for (; m < _islandManifoldStart[i]; ++m)
+            {
+                _manifoldFirstContact[_manifoldPairs[m]] = contacts;
+                contacts += _pairContactCount[_manifoldPairs[m]];
+            }
+            largest = std::max<size_t>(largest, contacts - _islandStart[i]);
+        }
+        _islandStart[islands] = contacts;
+
+        // Dynamic bodies island by island, in body order.
+        _bodyIsland.resize(count);
+        _islandBodyStart.assign(islands + 1, 0);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _bodyIsland[i] = _invMass[i] > 0.f ? _rootIsland[find(i)] : UINT32_MAX;
+            if (_bodyIsland[i] != UINT32_MAX)
+                ++_islandBodyStart[_bodyIsland[i] + 1];
+        }
+        for (uint32_t i = 0; i < islands; ++i)
+            _islandBodyStart[i + 1] += _islandBodyStart[i];
+        _islandBodies.resize(_islandBodyStart[islands]);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (_bodyIsland[i] != UINT32_MAX)
+                _islandBodies[_islandBodyStart[_bodyIsland[i]]++] = i;
+        }
+        // Each start was advanced to the next island's start; shift them back.
+        for (uint32_t i = islands; i > 0; --i)
+            _islandBodyStart[i] = _islandBodyStart[i - 1];
+        _islandBodyStart[0] = 0;
+
+        _stats.manifolds = manifoldCount;
+        _stats.contacts = _islandStart.back();
+        _stats.islands = islands;
+        _stats.largestIsland = largest;
+    }
+
+    void RigidBodyWorld::setupConstraints()
+    {
+        const size_t contactCount = _islandStart.back();
+        _contactA.resize(contactCount);
+        _contactB.resize(contactCount);
+        _contactLocalPoint.resize(contactCount);
+        _contactRA.resize(contactCount);
+        _contactRB.resize(contactCount);
+        _contactNormal.resize(contactCount);
+        _contactTangent1.resize(contactCount);
+        _contactTangent2.resize(contactCount);
+        _contactNormalMass.resize(contactCount);
+        _contactTangentMass1.resize(contactCount);
+        _contactTangentMass2.resize(contactCount);
+        _contactDepth.resize(contactCount);
+        _contactBias.resize(contactCount);
+        _contactFriction.resize(contactCount);
+        _contactImpulse.resize(contactCount);
+
+        std::atomic<size_t> warmStarted(0);
+        parallel::parallelFor(_manifoldPairs.size(), [&](size_t m)
+        {
+            const uint32_t p = _manifoldPairs[m];
+            const BodyId a = _pairs[p].a;
+            const BodyId b = _pairs[p].b;
+            const float3 n = _pairNormal[p];
+            const float3 t1 = sOrthogonal(n);
+            const float3 t2 = simd_cross(n, t1);
+            const float friction = sqrtf(_friction[a] * _friction[b]);
+
+            // Last step's contacts for this pair, if it was touching then.
+            const auto cached = std::lower_bound(_cacheKeys.begin(), _cacheKeys.end(), _pairs[p].key);
+            uint32_t cacheBegin = 0;
+            uint32_t cacheEnd = 0;
+            if (cached != _cacheKeys.end() && *cached == _pairs[p].key)
+            {
+                cacheBegin = _cacheFirst[cached - _cacheKeys.begin()];
+                cacheEnd = _cacheFirst[cached - _cacheKeys.begin() + 1];
+            }
+
+            size_t matched = 0;
+            for (uint32_t k = 0; k < _pairContactCount[p]; ++k)
+            {
+                const uint32_t c = _manifoldFirstContact[p] + k;
+                const float3 point = _slotPoint[p * kMaxContactsPerPair + k];
+                const float depth = _slotDepth[p * kMaxContactsPerPair + k];
+                const float3 ra = point - _position[a];
+                const float3 rb = point - _position[b];
+                const float4 qa = _orientation[a];
+                const float3 local = sRotate(simd_make_float4(-qa.x, -qa.y, -qa.z, qa.w), ra);
+
+                auto effectiveMass = [&](float3 dir)
+                {
+                    const float3 raxd = simd_cross(ra, dir);
+                    const float3 rbxd = simd_cross(rb, dir);
+                    const float k = _invMass[a] + _invMass[b]
+                                  + simd_dot(raxd, applyInvInertia(a, raxd)) + simd_dot(rbxd, applyInvInertia(b, rbxd));
+                    return (k > 0.f ? 1.f / k : 0.f);
+                };
+
+                _contactA[c] = a;
+                _contactB[c] = b;
+                _contactLocalPoint[c] = local;
+                _contactRA[c] = ra;
+                _contactRB[c] = rb;
+                _contactNormal[c] = n;
+                _contactTangent1[c] = t1;
+                _contactTangent2[c] = t2;
+                _contactNormalMass[c] = effectiveMass(n);
+                _contactTangentMass1[c] = effectiveMass(t1);
+                _contactTangentMass2[c] = effectiveMass(t2);
+                _contactDepth[c] = depth;
+                _contactFriction[c] = friction;
+
+                float3 impulse = simd_make_float3(0.f, 0.f, 0.f);
+                float bestDistance = kWarmStartMatchDistance * kWarmStartMatchDistance;
+                for (uint32_t old = cacheBegin; old < cacheEnd; ++old)
+                {
+                    const float distance = simd_length_squared(_cacheLocalPoint[old] - local);
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        impulse = _cacheImpulse[old] * _settings.warmStartFactor;
+                    }
+                }
+                matched += impulse.x > 0.f;
+                _contactImpulse[c] = impulse;
+            }
+            warmStarted.fetch_add(matched, std::memory_order_relaxed);
+        }, _settings.threadCount);
+        _stats.warmStarted = warmStarted.load();
+    }
+
+    void RigidBodyWorld::solveIsland(size_t island, float dt)
+    {
+        const uint32_t begin = _islandStart[island];
+        const uint32_t end = _islandStart[island + 1];
+        const uint32_t bodyBegin = _islandBodyStart[island];
+        const uint32_t bodyEnd = _islandBodyStart[island + 1];
+        const uint32_t substeps = std::max(_settings.substeps, 1u);
+        const float h = dt / substeps;
+        const float invH = 1.f / h;
+        const float biasFactor = _settings.baumgarte * invH;
+        const float damping = 1.f / (1.f + h * _settings.angularDamping);
+
+        // Static bodies are shared between islands, so they are only ever read.
+        auto apply = [this](uint32_t c, float3 impulse)
+        {
+            const BodyId a = _contactA[c];
+            const BodyId b = _contactB[c];
+            if (_invMass[a] > 0.f)
+            {
+                _linearVelocity[a] -= impulse * _invMass[a];
+                _angularVelocity[a] -= applyInvInertia(a, simd_cross(_contactRA[c], impulse));
+            }
+            if (_invMass[b] > 0.f)
+            {
+                _linearVelocity[b] += impulse * _invMass[b];
+                _angularVelocity[b] += applyInvInertia(b, simd_cross(_contactRB[c], impulse));
+            }
+        };
+        auto relativeVelocity = [this](uint32_t c)
+        {
+            const BodyId a = _contactA[c];
+            const BodyId b = _contactB[c];
+            return (_linearVelocity[b] + simd_cross(_angularVelocity[b], _contactRB[c])
+                  - _linearVelocity[a] - simd_cross(_angularVelocity[a], _contactRA[c]));
+        };
+        // How far the contact point on a body has moved since the step began; static bodies
+        // are never in an island's body list, so theirs stays zero.
+        auto moved = [this](BodyId body, float3 r)
+        {
+            return (_invMass[body] > 0.f ? _moved[body] + simd_cross(_turned[body], r) : simd_make_float3(0.f, 0.f, 0.f));
+        };
+
+        for (uint32_t i = bodyBegin; i < bodyEnd; ++i)
+        {
+            _moved[_islandBodies[i]] = simd_make_float3(0.f, 0.f, 0.f);
+            _turned[_islandBodies[i]] = simd_make_float3(0.f, 0.f, 0.f);
+        }
+
+        for (uint32_t substep = 0; substep < substeps; ++substep)
+        {
+            for (uint32_t i = bodyBegin; i < bodyEnd; ++i)
+            {
+                const BodyId body = _islandBodies[i];
+                _linearVelocity[body] += _settings.gravity * h;
+                _angularVelocity[body] *= damping;
+            }
+
+            // A gap lets the bodies close it within the substep; penetration past the slop is
+            // pushed out a fraction per substep.
+            for (uint32_t c = begin; c < end; ++c)
+            {
+                const float depth = _contactDepth[c] - simd_dot(_contactNormal[c],
+                                    moved(_contactB[c], _contactRB[c]) - moved(_contactA[c], _contactRA[c]));
+                _contactBias[c] = depth < 0.f ? depth * invH : biasFactor * std::max(depth - _settings.penetrationSlop, 0.f);
+
+                const float3 impulse = _contactImpulse[c];
+                apply(c, _contactNormal[c] * impulse.x + _contactTangent1[c] * impulse.y + _contactTangent2[c] * impulse.z);
+            }
+
+            for (uint32_t iteration = 0; iteration < _settings.velocityIterations; ++iteration)
+            {
+                for (uint32_t c = begin; c < end; ++c)
+                {
+                    float3& accumulated = _contactImpulse[c];
+
+                    // Friction first, bounded by the normal impulse so far.
+                    const float limit = _contactFriction[c] * accumulated.x;
+                    float3 dv = relativeVelocity(c);
+                    float old = accumulated.y;
+                    accumulated.y = std::clamp(old - simd_dot(dv, _contactTangent1[c]) * _contactTangentMass1[c], -limit, limit);
+                    apply(c, _contactTangent1[c] * (accumulated.y - old));
+
+                    dv = relativeVelocity(c);
+                    old = accumulated.z;
+                    accumulated.z = std::clamp(old - simd_dot(dv, _contactTangent2[c]) * _contactTangentMass2[c], -limit, limit);
+                    apply(c, _contactTangent2[c] * (accumulated.z - old));
+
+                    // Normal: push apart until closing speed reaches the bias.
+                    dv = relativeVelocity(c);
+                    old = accumulated.x;
+                    accumulated.x = std::max(old + (_contactBias[c] - simd_dot(dv, _contactNormal[c])) * _contactNormalMass[c], 0.f);
+                    apply(c, _contactNormal[c] * (accumulated.x - old));
+                }
+            }
+
+            for (uint32_t i = bodyBegin; i < bodyEnd; ++i)
+            {
+                const BodyId body = _islandBodies[i];
+                _moved[body] += _linearVelocity[body] * h;
+                _turned[body] += _angularVelocity[body] * h;
+                integrateBody(body, h);
+            }
+        }
+    }
+
+    void RigidBodyWorld::cacheImpulses()
+    {
+        // In key order, so the next step can look pairs up by binary search.
+        _cacheKeys.clear();
+        _cacheFirst.assign(1, 0);
+        _cacheLocalPoint.clear();
+        _cacheImpulse.clear();
+        for (size_t p = 0; p < _pairs.size(); ++p)
+        {
+            if (!_pairContactCount[p])
+                continue;
+            _cacheKeys.push_back(_pairs[p].key);
+            for (uint32_t k = 0; k < _pairContactCount[p]; ++k)
+            {
+                const uint32_t c = _manifoldFirstContact[p] + k;
+                _cacheLocalPoint.push_back(_contactLocalPoint[c]);
+                _cacheImpulse.push_back(_contactImpulse[c]);
+            }
+            _cacheFirst.push_back((uint32_t)_cacheLocalPoint.size());
+        }
+    }
+
+    void RigidBodyWorld::integrateFreeBodies(float dt)
+    {
+        const float damping = 1.f / (1.f + dt * _settings.angularDamping);
+        parallel::parallelFor(_position.size(), [&](size_t i)
+        {
+            if (_invMass[i] == 0.f || _bodyIsland[i] != UINT32_MAX)
+                return;
+            _linearVelocity[i] += _settings.gravity * dt;
+            _angularVelocity[i] *= damping;
+            integrateBody((BodyId)i, dt);
+        }, _settings.threadCount);
+    }
+
+    void RigidBodyWorld::integrateBody(BodyId body, float dt)
+    {
+        _position[body] += _linearVelocity[body] * dt;
+        const float3 w = _angularVelocity[body] * (0.5f * dt);
+        const float4 q = _orientation[body];
+        // q += 0.5 dt (w, 0) q
+        const float4 dq = simd_make_float4(w.x * q.w + w.y * q.z - w.z * q.y,
+                                           w.y * q.w + w.z * q.x - w.x * q.z,
+                                           w.z * q.w + w.x * q.y - w.y * q.x,
+                                           -(w.x * q.x + w.y * q.y + w.z * q.z));
+        _orientation[body] = sNormalizeQuat(q + dq);
+    }
+
+    void benchmarkRigidBodies(FILE* out, size_t boxCount, uint32_t steps)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr uint32_t kStackHeight = 10;
+        constexpr float kDt = 1.f / 60.f;
+        const size_t stacks = (boxCount + kStackHeight - 1) / kStackHeight;
+        const size_t side = (size_t)ceilf(sqrtf((float)stacks));
+        const float spacing = 1.5f;
+
+        auto build = [&](RigidBodyWorld& world, size_t count)
+        {
+            world.clear();
+            BodyDesc ground;
+            ground.mass = 0.f;
+            ground.collider.size = simd_make_float3(side * spacing + 2.f, 0.5f, side * spacing + 2.f);
+            ground.position = simd_make_float3(0.f, -0.5f, 0.f);
+            world.addBody(ground);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const size_t stack = i / kStackHeight;
+                BodyDesc box;
+                box.position = simd_make_float3(((float)(stack % side) - side * 0.5f) * spacing,
+                                                0.5f + (float)(i % kStackHeight),
+                                                ((float)(stack / side) - side * 0.5f) * spacing);
+                world.addBody(box);
+            }
+        };
+
+        RigidBodyWorld world;
+        build(world, boxCount);
+        WorldStats total;
+        double worstStepMs = 0.0;
+        const auto start = Clock::now();
+        for (uint32_t s = 0; s < steps; ++s)
+        {
+            const auto stepStart = Clock::now();
+            world.step(kDt);
+            worstStepMs = std::max(worstStepMs, std::chrono::duration<double, std::milli>(Clock::now() - stepStart).count());
+            const WorldStats& stats = world.stats();
+            total.broadphaseMs += stats.broadphaseMs;
+            total.narrowphaseMs += stats.narrowphaseMs;
+            total.islandMs += stats.islandMs;
+            total.solveMs += stats.solveMs;
+            total.integrateMs += stats.integrateMs;
+        }
+        const double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // Settled stacks stay where they were built: report the worst drift and boxes that fell.
+        float drift = 0.f;
+        size_t fallen = 0;
+        for (size_t i = 0; i < boxCount; ++i)
+        {
+            const size_t stack = i / kStackHeight;
+            const float3 p = world.position((BodyId)(i + 1));
+            const float dx = p.x - ((float)(stack % side) - side * 0.5f) * spacing;
+            const float dz = p.z - ((float)(stack / side) - side * 0.5f) * spacing;
+            drift = std::max(drift, sqrtf(dx * dx + dz * dz));
+            fallen += p.y < 0.5f + (float)(i % kStackHeight) - 0.25f;
+        }
+
+        const WorldStats& stats = world.stats();
+        fprintf(out, "%zu boxes in %zu stacks of %u, %u steps at 60 Hz\n", boxCount, stacks, kStackHeight, steps);
+        fprintf(out, "  per step: %.3f ms (worst %.3f): broadphase %.3f, narrowphase %.3f, islands %.3f, solve %.3f, integrate %.3f\n",
+                totalMs / steps, worstStepMs, total.broadphaseMs / steps, total.narrowphaseMs / steps,
+                total.islandMs / steps, total.solveMs / steps, total.integrateMs / steps);
+        fprintf(out, "  last step: %zu pairs, %zu contacts (%zu warm started), %zu islands, largest %zu contacts\n",
+                stats.candidatePairs, stats.contacts, stats.warmStarted, stats.islands, stats.largestIsland);
+        fprintf(out, "  drift %.4f, %zu boxes sagged or fell\n", drift, fallen);
+
+        // Determinism: a shorter run on one thread and on every thread.
+        const size_t checkCount = std::min<size_t>(boxCount, 1000);
+        RigidBodyWorld single;
+        RigidBodyWorld threaded;
+        single.settings().threadCount = 1;
+        build(single, checkCount);
+        build(threaded, checkCount);
+        for (uint32_t s = 0; s < 120; ++s)
+        {
+            single.step(kDt);
+            threaded.step(kDt);
+        }
+        fprintf(out, "  1 thread vs %u threads after 120 steps: %s\n", parallel::defaultThreadCount(),
+                single.stateHash() == threaded.stateHash() ? "identical" : "DIFFERENT");
+    }
 }
@@ -0,0 +1,287 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPointInTriangle.cpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 11:03:31      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLPointInTriangle.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    // Edge i is the line through the two vertices other than vertex i, written as
+    // E(p) = a * p.x + b * p.y + c. It is positive inside, and E_i / area is the weight of vertex i.
+    // Swapping the two vertices negates a, b and c exactly, in float as well as in integers, so
+    // neighbouring triangles agree on which side of a shared edge a point is.
+    template <typename Scalar>
+    struct TriangleSetup
+    {
+        Scalar  edgeA[3];
+        Scalar  edgeB[3];
+        Scalar  edgeC[3];
+        bool    topLeft[3];
+        Scalar  area;
+        Scalar  minX, minY, maxX, maxY;
+        bool    degenerate;
+        bool    clockwise;
+    };
+
+    template <typename Scalar>
+    TriangleSetup<Scalar> sSetup(const Scalar (&x)[3], const Scalar (&y)[3])
+    {
+        TriangleSetup<Scalar> s;
+        for (int i = 0; i < 3; ++i)
+        {
+            const int j = (i + 1) % 3;
+            const int k = (i + 2) % 3;
+            s.edgeA[i] = y[j] - y[k];
+            s.edgeB[i] = x[k] - x[j];
+            s.edgeC[i] = x[j] * y[k] - y[j] * x[k];
+        }
+        s.area = s.edgeA[0] * x[0] + s.edgeB[0] * y[0] + s.edgeC[0];
+        s.degenerate = !(s.area > 0 || s.area < 0);
+        s.clockwise = s.area < 0;
+        if (s.clockwise)
+        {
+            // Clockwise: flip every edge so the inside is positive and the edge directions are
+            // the counter-clockwise ones the top-left rule below is written for.
+            for (int i = 0; i < 3; ++i)
+            {
+                s.edgeA[i] = -s.edgeA[i];
+                s.edgeB[i] = -s.edgeB[i];
+                s.edgeC[i] = -s.edgeC[i];
+            }
+            s.area = -s.area;
+        }
+        // For a counter-clockwise edge with direction d (y up), a = -d.y and b = d.x.
+        // Left edges go down (a > 0); top edges are horizontal and go left (a == 0, b < 0).
+        for (int i = 0; i < 3; ++i)
+            s.topLeft[i] = s.edgeA[i] > 0 || (s.edgeA[i] == 0 && s.edgeB[i] < 0);
+        s.minX = std::min({ x[0], x[1], x[2] });
+        s.minY = std::min({ y[0], y[1], y[2] });
+        s.maxX = std::max({ x[0], x[1], x[2] });
+        s.maxY = std::max({ y[0], y[1], y[2] });
+        return (s);
+    }
+
+    struct FloatLanes
+    {
+        using Scalar = float;
+        using Vec = simd_float8;
+        using Input = float;
+        using InputTriangle = hit_test::Triangle;
+
+        static Vec load(const float* p, size_t lanes)
+        {
+            Vec v = {};
+            memcpy(&v, p, lanes * sizeof(float));
+            return (v);
+        }
+
+        static Scalar scalar(float v)
+        {
+            return (v);
+        }
+
+        static TriangleSetup<Scalar> setup(const hit_test::Triangle& t)
+        {
+            const float x[3] = { t.a.x, t.b.x, t.c.x };
+            const float y[3] = { t.a.y, t.b.y, t.c.y };
+            return (sSetup(x, y));
+        }
+
+        static simd_int8 inside(Vec e, bool topLeft)
+        {
+            return ((e > 0.f) | ((e == 0.f) & (topLeft ? -1 : 0)));
+        }
+
+        static Vec select(Vec a, Vec b, simd_int8 mask)
+        {
+            return (simd_select(a, b, mask));
+        }
+
+        static simd_float8 toFloat(Vec v)
+        {
+            return (v);
+        }
+    };
+
+    struct FixedLanes
+    {
+        using Scalar = simd_long1;
+        using Vec = simd_long8;
+        using Input = fixed::Fixed24_8;
+        using InputTriangle = hit_test::TriangleFixed;
+
+        static Vec load(const fixed::Fixed24_8* p, size_t lanes)
+        {
+            simd_int8 raw = {};
+            memcpy(&raw, (const void *)p, lanes * sizeof(int32_t));
+            return (__builtin_convertvector(raw, simd_long8));
+        }
+
+        static Scalar scalar(fixed::Fixed24_8 v)
+        {
+            return (v.raw());
+        }
+
+        static TriangleSetup<Scalar> setup(const hit_test::TriangleFixed& t)
+        {
+            const simd_long1 x[3] = { t.a.x.raw(), t.b.x.raw(), t.c.x.raw() };
+            const simd_long1 y[3] = { t.a.y.raw(), t.b.y.raw(), t.c.y.raw() };
+            return (sSetup(x, y));
+        }
+
+        static simd_int8 inside(Vec e, bool topLeft)
+        {
+            // Exact integers: "e > 0, or e == 0 on a top-left edge" is e >= bias.
+            return (__builtin_convertvector(e >= (topLeft ? 0 : 1), simd_int8));
+        }
+
+        static Vec select(Vec a, Vec b, simd_int8 mask)
+        {
+            return (simd_bitselect(a, b, __builtin_convertvector(mask, simd_long8)));
+        }
+
+        static simd_float8 toFloat(Vec v)
+        {
+            return (__builtin_convertvector(v, simd_float8));
+        }
+    };
+
+    // Points are processed eight at a time in the outer loop so the running hit and edge values
+    // stay in registers while all triangles are tested; the triangle loop first rejects by
+    // bounding box against the whole group of eight.
+    template <typename Lanes>
+    void sPointsInTriangles(const typename Lanes::Input* pX, const typename Lanes::Input* pY, size_t count,
+                            const TriangleSetup<typename Lanes::Scalar>* pSetups, size_t triangleCount,
+                            int32_t* pHit, uint8_t* pInside, simd_float3* pBarycentrics)
+    {
+        using Scalar = typename Lanes::Scalar;
+        using Vec = typename Lanes::Vec;
+        const simd_int8 laneIndex = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+        for (size_t base = 0; base < count; base += 8)
+        {
+            const size_t lanes = std::min<size_t>(8, count - base);
+            const Vec x = Lanes::load(pX + base, lanes);
+            const Vec y = Lanes::load(pY + base, lanes);
+            const simd_int8 valid = laneIndex < (int)lanes;
+
+            Scalar minX = Lanes::scalar(pX[base]);
+            Scalar maxX = minX;
+            Scalar minY = Lanes::scalar(pY[base]);
+            Scalar maxY = minY;
+            for (size_t i = 1; i < lanes; ++i)
+            {
+                minX = std::min(minX, Lanes::scalar(pX[base + i]));
+                maxX = std::max(maxX, Lanes::scalar(pX[base + i]));
+                minY = std::min(minY, Lanes::scalar(pY[base + i]));
+                maxY = std::max(maxY, Lanes::scalar(pY[base + i]));
+            }
+
+            simd_int8 hit = simdSplat<simd_int8>(-1);
+            Vec w0 = {}, w1 = {}, w2 = {}, area = simdSplat<Vec>(1);
+            for (size_t t = 0; t < triangleCount; ++t)
+            {
+                const TriangleSetup<Scalar>& s = pSetups[t];
+                if (s.degenerate || s.maxX < minX || s.minX > maxX || s.maxY < minY || s.minY > maxY)
+                    continue;
+                const Vec e0 = s.edgeA[0] * x + s.edgeB[0] * y + s.edgeC[0];
+                const Vec e1 = s.edgeA[1] * x + s.edgeB[1] * y + s.edgeC[1];
+                const Vec e2 = s.edgeA[2] * x + s.edgeB[2] * y + s.edgeC[2];
+                const simd_int8 inside = valid & Lanes::inside(e0, s.topLeft[0]) & Lanes::inside(e1, s.topLeft[1]) & Lanes::inside(e2, s.topLeft[2]);
+                if (!simd_any(inside))
+                    continue;
+                hit = simd_bitselect(hit, simdSplat<simd_int8>((int)t), inside);
+                if (pBarycentrics)
+                {
+                    w0 = Lanes::select(w0, e0, inside);
+                    w1 = Lanes::select(w1, e1, inside);
+                    w2 = Lanes::select(w2, e2, inside);
+                    area = Lanes::select(area, simdSplat<Vec>(s.area), inside);
+                }
+            }
+
+            for (size_t i = 0; i < lanes; ++i)
+            {
+                if (pHit)
+                    pHit[base + i] = hit[i];
+                if (pInside)
+                    pInside[base + i] = hit[i] >= 0;
+            }
+            if (pBarycentrics)
+            {
+                const simd_float8 invArea = 1.f / Lanes::toFloat(area);
+                const simd_float8 b0 = Lanes::toFloat(w0) * invArea;
+                const simd_float8 b1 = Lanes::toFloat(w1) * invArea;
+                const simd_float8 b2 = Lanes::toFloat(w2) * invArea;
+                for (size_t i = 0; i < lanes; ++i)
+                    pBarycentrics[base + i] = hit[i] >= 0 ? simd_make_float3(b0[i], b1[i], b2[i]) : simd_make_float3(0.f, 0.f, 0.f);
+            }
+        }
+    }
+
+    template <typename Lanes>
+    void sPointsInTriangles(const typename Lanes::Input* pX, const typename Lanes::Input* pY, size_t count,
+                            const typename Lanes::InputTriangle* pTriangles, size_t triangleCount,
+                            int32_t* pHit, uint8_t* pInside, simd_float3* pBarycentrics)
+    {
+        std::vector<TriangleSetup<typename Lanes::Scalar>> setups(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t)
+            setups[t] = Lanes::setup(pTriangles[t]);
+        sPointsInTriangles<Lanes>(pX, pY, count, setups.data(), triangleCount, pHit, pInside, pBarycentrics);
+    }
+}
+
+namespace hit_test
+{
+    EdgeFunctions edgeFunctions(const Triangle& triangle)
+    {
+        const TriangleSetup<float> setup = FloatLanes::setup(triangle);
+        EdgeFunctions edges;
+        for (int i = 0; i < 3; ++i)
+        {
+            edges.a[i] = setup.edgeA[i];
+            edges.b[i] = setup.edgeB[i];
+            edges.c[i] = setup.edgeC[i];
+            edges.topLeft[i] = setup.topLeft[i];
+        }
+        edges.area = setup.degenerate ? 0.f : setup.area;
+        edges.clockwise = setup.clockwise;
+        return (edges);
+    }
+
+    void pointsInTriangle(const float* pX, const float* pY, size_t count, const Triangle& triangle,
+                          uint8_t* pInside, simd_float3* pBarycentrics)
+    {
+        const TriangleSetup<float> setup = FloatLanes::setup(triangle);
+        sPointsInTriangles<FloatLanes>(pX, pY, count, &setup, 1, nullptr, pInside, pBarycentrics);
+    }
+
+    void pointsInTriangle(const fixed::Fixed24_8* pX, const fixed::Fixed24_8* pY, size_t count, const TriangleFixed& triangle,
+                          uint8_t* pInside, simd_float3* pBarycentrics)
+    {
+        const TriangleSetup<simd_long1> setup = FixedLanes::setup(triangle);
+        sPointsInTriangles<FixedLanes>(pX, pY, count, &setup, 1, nullptr, pInside, pBarycentrics);
+    }
+
+    void pointsInTriangles(const float* pX, const float* pY, size_t count, const Triangle* pTriangles, size_t triangleCount,
+                           int32_t* pHit, simd_float3* pBarycentrics)
+    {
+        sPointsInTriangles<FloatLanes>(pX, pY, count, pTriangles, triangleCount, pHit, nullptr, pBarycentrics);
+    }
+
+    void pointsInTriangles(const fixed::Fixed24_8* pX, const fixed::Fixed24_8* pY, size_t count, const TriangleFixed* pTriangles, size_t triangleCount,
+                           int32_t* pHit, simd_float3* pBarycentrics)
+    {
+        sPointsInTriangles<FixedLanes>(pX, pY, count, pTriangles, triangleCount, pHit, nullptr, pBarycentrics);
+    }
+}
@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPointInTriangle.hpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 11:03:27      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPOINTINTRIANGLE_HPP
+# define RMDLPOINTINTRIANGLE_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstddef>
+# include <cstdint>
+
+# include "RMDLFixed.hpp"
+
+/// Batch 2D point-in-triangle tests for hit-testing sprites and UI.
+///
+/// Points are passed as separate x and y arrays and tested eight at a time with edge functions.
+/// Coordinates are y-up (as in the game's ortho projection) and triangles may have either winding.
+/// Points exactly on an edge follow the top-left fill convention: they are inside only for top
+/// (horizontal, largest y) and left edges. A point on an edge shared by two triangles therefore
+/// hits exactly one of them, the same way the rasterizer would cover it.
+/// Degenerate (zero-area) triangles contain no points.
+///
+/// Barycentrics are the weights of a, b and c; they are written as zero for points that miss.
+namespace hit_test
+{
+    struct Triangle
+    {
+        simd_float2 a;
+        simd_float2 b;
+        simd_float2 c;
+    };
+
+    struct PointFixed
+    {
+        fixed::Fixed24_8 x;
+        fixed::Fixed24_8 y;
+    };
+
+    /// Edge functions are evaluated exactly in 64-bit integers, which holds while every coordinate
+    /// satisfies |raw()| < 2^29 (|value| < 2^21).
+    struct TriangleFixed
+    {
+        PointFixed a;
+        PointFixed b;
+        PointFixed c;
+    };
+
+    /// Edge functions of a float triangle, oriented so the inside is positive. The tests below and
+    /// the software rasterizer both evaluate these, so they agree on every edge pixel.
+    struct EdgeFunctions
+    {
+        float   a[3];
+        float   b[3];
+        float   c[3];
+        bool    topLeft[3];
+        float   area;       // E_i at vertex i; 0 for degenerate triangles
+        bool    clockwise;  // winding of the input vertices
+    };
+
+    EdgeFunctions edgeFunctions(const Triangle& triangle);
+
+    /// Lane i is -1 when (x[i], y[i]) is inside. e receives the edge values, which divided by
+    /// area are the barycentrics.
+    inline simd_int8 coverage8(const EdgeFunctions& edges, simd_float8 x, simd_float8 y, simd_float8 (&e)[3])
+    {
+        simd_int8 inside = simdSplat<simd_int8>(-1);
+        for (int i = 0; i < 3; ++i)
+        {
+            e[i] = edges.a[i] * x + edges.b[i] * y + edges.c[i];
+            inside &= (e[i] > 0.f) | ((e[i] == 0.f) & (edges.topLeft[i] ? -1 : 0));
+        }
+        return (inside);
+    }
+
+    /// pInside[i] is 1 if point i is inside the triangle, 0 otherwise.
+    void pointsInTriangle(const float* pX, const float* pY, size_t count, const Triangle& triangle,
+                          uint8_t* pInside, simd_float3* pBarycentrics = nullptr);
+
+    void pointsInTriangle(const fixed::Fixed24_8* pX, const fixed::Fixed24_8* pY, size_t count, const TriangleFixed& triangle,
+                          uint8_t* pInside, simd_float3* pBarycentrics = nullptr);
+
+    /// pHit[i] is the index of the last triangle containing point i, which is the one drawn on top
+    /// when triangles are submitted in order, or -1 if no triangle contains it.
+    void pointsInTriangles(const float* pX, const float* pY, size_t count, const Triangle* pTriangles, size_t triangleCount,
+                           int32_t* pHit, simd_float3* pBarycentrics = nullptr);
+
+    void pointsInTriangles(const fixed::Fixed24_8* pX, const fixed::Fixed24_8* pY, size_t count, const TriangleFixed* pTriangles, size_t triangleCount,
+                           int32_t* pHit, simd_float3* pBarycentrics = nullptr);
+}
+
+#endif /* RMDLPOINTINTRIANGLE_HPP */
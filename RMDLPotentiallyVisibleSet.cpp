@@ -0,0 +1,797 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPotentiallyVisibleSet.cpp  +++   +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 13:25:02      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLPotentiallyVisibleSet.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <utility>
+
+namespace
+{
+    using Winding = std::vector<simd_float3>;
+    using Bits = std::vector<uint64_t>;
+
+    enum WindingSide
+    {
+        kWindingFront,
+        kWindingBack,
+        kWindingOn,
+        kWindingSplit
+    };
+
+    inline void sSetBit(Bits& bits, uint32_t i)
+    {
+        bits[i >> 6] |= 1ull << (i & 63);
+    }
+
+    inline bool sTestBit(const Bits& bits, uint32_t i)
+    {
+        return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    inline simd_float4 sFlip(simd_float4 plane)
+    {
+        return (-plane);
+    }
+
+    inline float sDistance(simd_float4 plane, simd_float3 p)
+    {
+        return (simd_dot(plane.xyz, p) - plane.w);
+    }
+
+    /// Splits in by plane. pFront and pBack (either may be null) receive the pieces only when the
+    /// winding is actually cut; otherwise the return value says which side it lies on.
+    WindingSide sSplit(const Winding& in, simd_float4 plane, float eps, Winding* pFront, Winding* pBack)
+    {
+        std::vector<float> distances(in.size());
+        bool front = false;
+        bool back = false;
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            distances[i] = sDistance(plane, in[i]);
+            front |= distances[i] > eps;
+            back |= distances[i] < -eps;
+        }
+        if (!front && !back)
+            return (kWindingOn);
+        if (!back)
+            return (kWindingFront);
+        if (!front)
+            return (kWindingBack);
+
+        if (pFront)
+            pFront->clear();
+        if (pBack)
+            pBack->clear();
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            const size_t j = (i + 1) % in.size();
+            const float da = distances[i];
+            const float db = distances[j];
+            if (da >= -eps && pFront)
+                pFront->push_back(in[i]);
+            if (da <= eps && pBack)
+                pBack->push_back(in[i]);
+            if ((da > eps && db < -eps) || (da < -eps && db > eps))
+            {
+                const simd_float3 p = in[i] + (in[j] - in[i]) * (da / (da - db));
+                if (pFront)
+                    pFront->push_back(p);
+                if (pBack)
+                    pBack->push_back(p);
+            }
+        }
+        return (kWindingSplit);
+    }
+
+    /// Keeps the part of in in front of plane; empty when nothing is left.
+    Winding sClip(const Winding& in, simd_float4 plane, float eps, bool keepOn)
+    {
+        Winding front;
+        switch (sSplit(in, plane, eps, &front, nullptr))
+        {
+            case kWindingFront: return (in);
+            case kWindingBack:  return (Winding());
+            case kWindingOn:    return (keepOn ? in : Winding());
+            case kWindingSplit: break;
+        }
+        return (front.size() >= 3 ? front : Winding());
+    }
+
+    float sArea(const Winding& w)
+    {
+        simd_float3 sum = {};
+        for (size_t i = 1; i + 1 < w.size(); ++i)
+            sum += simd_cross(w[i] - w[0], w[i + 1] - w[0]);
+        return (0.5f * simd_length(sum));
+    }
+
+    /// A square on plane, large enough to cover anything within extent of the origin.
+    Winding sBaseWinding(simd_float4 plane, float extent)
+    {
+        const simd_float3 n = plane.xyz;
+        const simd_float3 a = simd_abs(n);
+        simd_float3 up = a.z > a.x && a.z > a.y ? simd_make_float3(1.f, 0.f, 0.f) : simd_make_float3(0.f, 0.f, 1.f);
+        up = simd_normalize(up - n * simd_dot(up, n)) * extent;
+        const simd_float3 right = simd_cross(up, n);
+        const simd_float3 origin = n * plane.w;
+        return (Winding{ origin - right + up, origin + right + up, origin + right - up, origin - right - up });
+    }
+
+    /// Removes the convex polygon pWall (coplanar with w) from w, appending the uncovered convex
+    /// pieces to out.
+    void sSubtract(const Winding& w, const simd_float3* pWall, uint32_t wallCount, simd_float3 normal, float eps, std::vector<Winding>& out)
+    {
+        simd_float3 centroid = {};
+        for (uint32_t i = 0; i < wallCount; ++i)
+            centroid += pWall[i];
+        centroid /= (float)wallCount;
+
+        Winding inside = w;
+        for (uint32_t i = 0; i < wallCount; ++i)
+        {
+            const simd_float3 a = pWall[i];
+            const simd_float3 b = pWall[(i + 1) % wallCount];
+            const simd_float3 edge = simd_cross(b - a, normal);
+            if (simd_length_squared(edge) <= 0.f)
+                continue;
+            simd_float4 plane = simd_make_float4(simd_normalize(edge), 0.f);
+            plane.w = simd_dot(plane.xyz, a);
+            if (sDistance(plane, centroid) > 0.f)
+                plane = sFlip(plane);
+
+            Winding outside, rest;
+            switch (sSplit(inside, plane, eps, &outside, &rest))
+            {
+                case kWindingFront:
+                    out.push_back(inside);
+                    return;
+                case kWindingBack:
+                case kWindingOn:
+                    break;
+                case kWindingSplit:
+                    if (outside.size() >= 3)
+                        out.push_back(std::move(outside));
+                    inside = std::move(rest);
+                    break;
+            }
+        }
+        // Whatever is left is covered by the wall.
+    }
+
+    /// A winding on its way down the tree, and the node or leaf it has reached.
+    using PushDownStack = std::vector<std::pair<int32_t, Winding>>;
+
+    /// Sends w down the subtree at child, collecting the pieces that reach each leaf. pending is
+    /// the caller's scratch stack: the tree can be as deep as it has polygons, too deep to recurse
+    /// on a worker thread.
+    void sPushDown(const spatial::BspTree& tree, int32_t child, const Winding& w, float eps, PushDownStack& pending,
+                   std::vector<std::pair<Winding, uint32_t>>& out)
+    {
+        pending.clear();
+        pending.emplace_back(child, w);
+        while (!pending.empty())
+        {
+            auto [current, winding] = std::move(pending.back());
+            pending.pop_back();
+            if (spatial::BspTree::isLeaf(current))
+            {
+                out.emplace_back(std::move(winding), spatial::BspTree::leafIndex(current));
+                continue;
+            }
+            const spatial::BspNode& node = tree.nodes()[current];
+            Winding front, back;
+            switch (sSplit(winding, node.plane, eps, &front, &back))
+            {
+                case kWindingFront:
+                case kWindingOn:
+                    pending.emplace_back(node.front, std::move(winding));
+                    break;
+                case kWindingBack:
+                    pending.emplace_back(node.back, std::move(winding));
+                    break;
+                case kWindingSplit:
+                    // Back first, so the front piece comes out first.
+                    if (back.size() >= 3)
+                        pending.emplace_back(node.back, std::move(back));
+                    if (front.size() >= 3)
+                        pending.emplace_back(node.front, std::move(front));
+                    break;
+            }
+        }
+    }
+
+    /// One side of a portal: seen from owner, looking through into leaf. The plane normal points
+    /// into leaf.
+    struct DirectedPortal
+    {
+        Winding     winding;
+        simd_float4 plane;
+        uint32_t    owner;
+        uint32_t    leaf;
+    };
+
+    struct FlowStack
+    {
+        Winding     source;
+        Winding     pass;
+        simd_float4 portalPlane;
+        Bits        mightSee;
+    };
+
+    /// One step of a portal chain: the leaf it reached, the state it reached it with, and the
+    /// next of the leaf's portals to try.
+    struct FlowFrame
+    {
+        uint32_t    leaf;
+        size_t      next;
+        FlowStack   stack;
+    };
+
+    struct FlowContext
+    {
+        const std::vector<DirectedPortal>&          portals;
+        const std::vector<std::vector<uint32_t>>&   leafPortals;
+        const std::vector<Bits>&                    portalFlood;
+        float                                       eps;
+        simd_float4                                 sourcePlane;
+        Bits                                        portalVis;
+        Bits&                                       leafVis;
+    };
+
+    /// Clips target to the planes through an edge of source and a vertex of pass that have source
+    /// and pass on opposite sides: anything outside them cannot be seen from source through pass.
+    Winding sClipToSeparators(const Winding& source, const Winding& pass, Winding target, bool flipClip, float eps)
+    {
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            const size_t l = (i + 1) % source.size();
+            const simd_float3 v1 = source[l] - source[i];
+            for (size_t j = 0; j < pass.size(); ++j)
+            {
+                const simd_float3 v2 = pass[j] - source[i];
+                simd_float3 normal = simd_cross(v1, v2);
+                const float length = simd_length(normal);
+                if (length < eps)
+                    continue;
+                normal /= length;
+                simd_float4 plane = simd_make_float4(normal, simd_dot(pass[j], normal));
+
+                // Orient the plane so source is behind it.
+                size_t k = 0;
+                bool flip = false;
+                for (; k < source.size(); ++k)
+                {
+                    if (k == i || k == l)
+                        continue;
+                    const float d = sDistance(plane, source[k]);
+                    if (d < -eps)
+                        break;
+                    if (d > eps)
+                    {
+                        flip = true;
+                        break;
+                    }
+                }
+                if (k == source.size())
+                    continue;   // source lies in the plane
+                if (flip)
+                    plane = sFlip(plane);
+
+                // It separates only if all of pass is in front.
+                bool inFront = false;
+                for (k = 0; k < pass.size(); ++k)
+                {
+                    if (k == j)
+                        continue;
+                    const float d = sDistance(plane, pass[k]);
+                    if (d < -eps)
+                        break;
+                    inFront |= d > eps;
+                }
+                if (k != pass.size() || !inFront)
+                    continue;
+
+                if (flipClip)
+                    plane = sFlip(plane);
+                target = sClip(target, plane, eps, false);
+                if (target.empty())
+                    return (target);
+            }
+        }
+        return (target);
+    }
+
+    /// Flows from the source portal in head through every chain of portals out of leaf. The
+    /// chain can be as long as the level has portals, so it lives in frames, the job's scratch
+    /// stack, instead of recursing; frames keep their buffers from one flow to the next.
+    void sLeafFlow(FlowContext& ctx, uint32_t leaf, const FlowStack& head, std::vector<FlowFrame>& frames)
+    {
+        if (frames.empty())
+            frames.emplace_back();
+        frames[0].leaf = leaf;
+        frames[0].next = 0;
+        frames[0].stack = head;
+        sSetBit(ctx.leafVis, leaf);
+
+        size_t depth = 0;
+        for (;;)
+        {
+            const std::vector<uint32_t>& leafPortals = ctx.leafPortals[frames[depth].leaf];
+            if (frames[depth].next == leafPortals.size())
+            {
+                if (depth == 0)
+                    return;
+                --depth;
+                continue;
+            }
+            const uint32_t portalIndex = leafPortals[frames[depth].next++];
+            if (depth + 1 == frames.size())
+                frames.emplace_back();
+            const FlowStack& prev = frames[depth].stack;
+            FlowStack& stack = frames[depth + 1].stack;
+            if (!sTestBit(prev.mightSee, portalIndex))
+                continue;
+
+            // Skip portals that cannot lead anywhere not already seen.
+            const Bits& flood = ctx.portalFlood[portalIndex];
+            stack.mightSee.resize(prev.mightSee.size());
+            bool more = false;
+            for (size_t w = 0; w < stack.mightSee.size(); ++w)
+            {
+                stack.mightSee[w] = prev.mightSee[w] & flood[w];
+                more |= (stack.mightSee[w] & ~ctx.portalVis[w]) != 0;
+            }
+            if (!more && sTestBit(ctx.portalVis, portalIndex))
+                continue;
+
+            const DirectedPortal& portal = ctx.portals[portalIndex];
+            const simd_float4 backPlane = sFlip(portal.plane);
+            // Cannot leave through a face coplanar with the one we came in through.
+            if (simd_dot(prev.portalPlane.xyz, backPlane.xyz) > 1.f - 1e-6f)
+                continue;
+
+            stack.portalPlane = portal.plane;
+            stack.pass = sClip(portal.winding, ctx.sourcePlane, ctx.eps, false);
+            if (stack.pass.empty())
+                continue;
+            stack.source = sClip(prev.source, backPlane, ctx.eps, false);
+            if (stack.source.empty())
+                continue;
+
+            // The first portal past the source can only be hidden by being coplanar with it.
+            if (!prev.pass.empty())
+            {
+                stack.pass = sClipToSeparators(stack.source, prev.pass, std::move(stack.pass), false, ctx.eps);
+                if (stack.pass.empty())
+                    continue;
+                stack.pass = sClipToSeparators(prev.pass, stack.source, std::move(stack.pass), true, ctx.eps);
+                if (stack.pass.empty())
+                    continue;
+            }
+
+            sSetBit(ctx.portalVis, portalIndex);
+            sSetBit(ctx.leafVis, portal.leaf);
+            ++depth;
+            frames[depth].leaf = portal.leaf;
+            frames[depth].next = 0;
+        }
+    }
+
+    /// Marks every portal of portalFront reachable from leaf through portals of portalFront.
+    /// pending is the job's scratch stack of leaves still to visit.
+    void sFlood(const std::vector<DirectedPortal>& portals, const std::vector<std::vector<uint32_t>>& leafPortals,
+                const Bits& portalFront, uint32_t leaf, Bits& flood, std::vector<uint32_t>& pending)
+    {
+        pending.assign(1, leaf);
+        while (!pending.empty())
+        {
+            const uint32_t current = pending.back();
+            pending.pop_back();
+            for (uint32_t portalIndex : leafPortals[current])
+            {
+                if (!sTestBit(portalFront, portalIndex) || sTestBit(flood, portalIndex))
+                    continue;
+                sSetBit(flood, portalIndex);
+                pending.push_back(portals[portalIndex].leaf);
+            }
+        }
+    }
+
+    /// Whether the segment from a to b passes through the triangle p0 p1 p2 (Moller-Trumbore).
+    bool sSegmentHitsTriangle(simd_float3 a, simd_float3 b, simd_float3 p0, simd_float3 p1, simd_float3 p2)
+    {
+        const simd_float3 dir = b - a;
+        const simd_float3 e1 = p1 - p0;
+        const simd_float3 e2 = p2 - p0;
+        const simd_float3 p = simd_cross(dir, e2);
+        const float det = simd_dot(e1, p);
+        if (std::abs(det) < 1e-12f)
+            return (false);
+        const float invDet = 1.f / det;
+        const simd_float3 s = a - p0;
+        const float u = simd_dot(s, p) * invDet;
+        if (u < 0.f || u > 1.f)
+            return (false);
+        const simd_float3 q = simd_cross(s, e1);
+        const float v = simd_dot(dir, q) * invDet;
+        if (v < 0.f || u + v > 1.f)
+            return (false);
+        const float t = simd_dot(e2, q) * invDet;
+        return (t > 0.f && t < 1.f);
+    }
+
+    void sCompress(const uint8_t* pBits, size_t byteCount, std::vector<uint8_t>& out)
+    {
+        for (size_t i = 0; i < byteCount; )
+        {
+            if (pBits[i])
+            {
+                out.push_back(pBits[i++]);
+                continue;
+            }
+            uint8_t run = 0;
+            while (i < byteCount && !pBits[i] && run < 255)
+            {
+                ++i;
+                ++run;
+            }
+            out.push_back(0);
+            out.push_back(run);
+        }
+    }
+}
+
+namespace spatial
+{
+    PotentiallyVisibleSet::PotentiallyVisibleSet() : _leafCount(0)
+    {
+    }
+
+    void PotentiallyVisibleSet::build(const BspTree& tree, const PvsBuildSettings& settings)
+    {
+        const std::vector<BspNode>& nodes = tree.nodes();
+        const float eps = settings.planeEpsilon;
+        _leafCount = (uint32_t)tree.leaves().size();
+        _portals.clear();
+        _portalVertices.clear();
+        _data.clear();
+        _rowOffsets.assign(1, 0);
+
+        // Level bounds, padded so the outermost leaves still get portals between them.
+        simd_float3 boundsMin = simdSplat<simd_float3>(INFINITY);
+        simd_float3 boundsMax = simdSplat<simd_float3>(-INFINITY);
+        for (const simd_float3& v : tree.vertices())
+        {
+            boundsMin = simd_min(boundsMin, v);
+            boundsMax = simd_max(boundsMax, v);
+        }
+        if (tree.vertices().empty())
+            boundsMin = boundsMax = simd_float3{};
+        const simd_float3 pad = (boundsMax - boundsMin) * 0.01f + 1.f;
+        boundsMin -= pad;
+        boundsMax += pad;
+        const float extent = simd_length(simd_max(simd_abs(boundsMin), simd_abs(boundsMax))) * 2.f;
+        const simd_float4 boundsPlanes[6] = {
+            simd_make_float4(1.f, 0.f, 0.f, boundsMin.x), simd_make_float4(-1.f, 0.f, 0.f, -boundsMax.x),
+            simd_make_float4(0.f, 1.f, 0.f, boundsMin.y), simd_make_float4(0.f, -1.f, 0.f, -boundsMax.y),
+            simd_make_float4(0.f, 0.f, 1.f, boundsMin.z), simd_make_float4(0.f, 0.f, -1.f, -boundsMax.z) };
+
+        std::vector<int32_t> parent(nodes.size(), -1);
+        std::vector<bool> isFrontChild(nodes.size(), false);
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            if (!BspTree::isLeaf(nodes[i].front))
+            {
+                parent[nodes[i].front] = (int32_t)i;
+                isFrontChild[nodes[i].front] = true;
+            }
+            if (!BspTree::isLeaf(nodes[i].back))
+                parent[nodes[i].back] = (int32_t)i;
+        }
+
+        // Portals: each node plane, cut to the bounds and the node's region, minus its polygons,
+        // pushed down both sides to find the leaves it separates.
+        std::vector<std::vector<std::pair<Winding, std::pair<uint32_t, uint32_t>>>> nodePortals(nodes.size());
+        parallel::parallelFor(nodes.size(), [&](size_t n)
+        {
+            const BspNode& node = nodes[n];
+            Winding w = sBaseWinding(node.plane, extent);
+            for (const simd_float4& plane : boundsPlanes)
+            {
+                if (w.empty())
+                    return;
+                w = sClip(w, plane, eps, true);
+            }
+            for (int32_t child = (int32_t)n; parent[child] >= 0 && !w.empty(); child = parent[child])
+            {
+                const simd_float4 plane = nodes[parent[child]].plane;
+                w = sClip(w, isFrontChild[child] ? plane : sFlip(plane), eps, true);
+            }
+            if (w.empty())
+                return;
+
+            std::vector<Winding> open(1, w);
+            for (uint32_t p = 0; p < node.polygonCount; ++p)
+            {
+                const BspPolygon& polygon = tree.polygons()[node.firstPolygon + p];
+                std::vector<Winding> next;
+                for (const Winding& fragment : open)
+                    sSubtract(fragment, tree.vertices().data() + polygon.firstVertex, polygon.vertexCount, node.plane.xyz, eps, next);
+                open = std::move(next);
+            }
+
+            PushDownStack pending;
+            for (const Winding& fragment : open)
+            {
+                std::vector<std::pair<Winding, uint32_t>> frontPieces;
+                sPushDown(tree, node.front, fragment, eps, pending, frontPieces);
+                for (const auto& [frontPiece, frontLeaf] : frontPieces)
+                {
+                    std::vector<std::pair<Winding, uint32_t>> pieces;
+                    sPushDown(tree, node.back, frontPiece, eps, pending, pieces);
+                    for (auto& [piece, backLeaf] : pieces)
+                    {
+                        if (piece.size() >= 3 && sArea(piece) >= settings.minPortalArea)
+                            nodePortals[n].emplace_back(std::move(piece), std::make_pair(frontLeaf, backLeaf));
+                    }
+                }
+            }
+        }, settings.threadCount);
+
+        std::vector<DirectedPortal> directed;
+        std::vector<std::vector<uint32_t>> leafPortals(_leafCount);
+        for (size_t n = 0; n < nodes.size(); ++n)
+        {
+            for (auto& [winding, leaves] : nodePortals[n])
+            {
+                const auto [frontLeaf, backLeaf] = leaves;
+                _portals.push_back(PvsPortal{ nodes[n].plane, (uint32_t)_portalVertices.size(), (uint32_t)winding.size(), frontLeaf, backLeaf });
+                _portalVertices.insert(_portalVertices.end(), winding.begin(), winding.end());
+                leafPortals[backLeaf].push_back((uint32_t)directed.size());
+                directed.push_back(DirectedPortal{ winding, nodes[n].plane, backLeaf, frontLeaf });
+                leafPortals[frontLeaf].push_back((uint32_t)directed.size());
+                directed.push_back(DirectedPortal{ std::move(winding), sFlip(nodes[n].plane), frontLeaf, backLeaf });
+            }
+        }
+        nodePortals.clear();
+
+        // Base vis: a portal can only possibly see portals that are partly in front of it and
+        // that it is partly behind, flooded through the portal graph.
+        const size_t portalWords = (directed.size() + 63) / 64;
+        std::vector<Bits> portalFlood(directed.size(), Bits(portalWords, 0));
+        parallel::parallelFor(directed.size(), [&](size_t p)
+        {
+            Bits front(portalWords, 0);
+            for (size_t t = 0; t < directed.size(); ++t)
+            {
+                if (t == p)
+                    continue;
+                bool inFront = false;
+                for (const simd_float3& v : directed[t].winding)
+                    inFront |= sDistance(directed[p].plane, v) > eps;
+                if (!inFront)
+                    continue;
+                bool behind = false;
+                for (const simd_float3& v : directed[p].winding)
+                    behind |= sDistance(directed[t].plane, v) < -eps;
+                if (behind)
+                    sSetBit(front, (uint32_t)t);
+            }
+            std::vector<uint32_t> pending;
+            sFlood(directed, leafPortals, front, directed[p].leaf, portalFlood[p], pending);
+        }, settings.threadCount);
+
+        // Full vis, one leaf per task: flow out through each of its portals.
+        const size_t leafWords = (_leafCount + 63) / 64;
+        std::vector<std::vector<uint8_t>> rows(_leafCount);
+        parallel::parallelFor(_leafCount, [&](size_t leaf)
+        {
+            Bits leafVis(leafWords, 0);
+            sSetBit(leafVis, (uint32_t)leaf);
+            std::vector<FlowFrame> frames;
+            for (uint32_t portalIndex : leafPortals[leaf])
+            {
+                const DirectedPortal& portal = directed[portalIndex];
+                FlowContext ctx{ directed, leafPortals, portalFlood, eps, portal.plane, Bits(portalWords, 0), leafVis };
+                FlowStack head;
+                head.source = portal.winding;
+                head.portalPlane = portal.plane;
+                head.mightSee = portalFlood[portalIndex];
+                sLeafFlow(ctx, portal.leaf, head, frames);
+            }
+
+            std::vector<uint8_t> bytes(rowBytes(), 0);
+            for (uint32_t i = 0; i < _leafCount; ++i)
+            {
+                if (sTestBit(leafVis, i))
+                    bytes[i >> 3] |= (uint8_t)(1u << (i & 7));
+            }
+            sCompress(bytes.data(), bytes.size(), rows[leaf]);
+        }, settings.threadCount);
+
+        for (const std::vector<uint8_t>& row : rows)
+        {
+            _data.insert(_data.end(), row.begin(), row.end());
+            _rowOffsets.push_back((uint32_t)_data.size());
+        }
+    }
+
+    void PotentiallyVisibleSet::decompress(uint32_t leaf, uint8_t* pBits) const
+    {
+        uint8_t* pOut = pBits;
+        for (const uint8_t* p = rowBegin(leaf), *pEnd = rowEnd(leaf); p < pEnd; ++p)
+        {
+            if (*p == 0)
+            {
+                const uint8_t run = *++p;
+                std::fill(pOut, pOut + run, 0);
+                pOut += run;
+            }
+            else
+                *pOut++ = *p;
+        }
+    }
+
+    bool PotentiallyVisibleSet::isVisible(uint32_t fromLeaf, uint32_t toLeaf) const
+    {
+        const uint32_t target = toLeaf >> 3;
+        uint32_t byteIndex = 0;
+        for (const uint8_t* p = rowBegin(fromLeaf), *pEnd = rowEnd(fromLeaf); p < pEnd; ++p)
+        {
+            if (*p == 0)
+            {
+                byteIndex += *++p;
+                if (byteIndex > target)
+                    return (false);
+                continue;
+            }
+            if (byteIndex == target)
+                return ((*p >> (toLeaf & 7)) & 1);
+            ++byteIndex;
+        }
+        return (false);
+    }
+
+    void benchmarkPvs(FILE* out)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr size_t kSegments = 20000;
+        const uint32_t sizes[] = { 4, 8, 12 };
+
+        fprintf(out, "%8s %8s %8s %10s %10s %10s %10s %10s %10s %8s\n",
+                "maze", "leaves", "portals", "bsp ms", "1 thread", "all ms", "bytes", "visible %", "clear", "missing");
+        for (uint32_t size : sizes)
+        {
+            // A perfect maze of size x size unit cells, one unit high, closed by a floor, a ceiling
+            // and outer walls. Wall w of cell (x, z) is open once the depth-first carve crosses it.
+            std::mt19937 rng(size);
+            std::vector<uint8_t> openEast(size * size, 0);
+            std::vector<uint8_t> openNorth(size * size, 0);
+            std::vector<uint8_t> visited(size * size, 0);
+            std::vector<uint32_t> carve(1, 0);
+            visited[0] = 1;
+            while (!carve.empty())
+            {
+                const uint32_t cell = carve.back();
+                const uint32_t x = cell % size;
+                const uint32_t z = cell / size;
+                uint32_t options[4];
+                uint32_t optionCount = 0;
+                if (x + 1 < size && !visited[cell + 1])
+                    options[optionCount++] = cell + 1;
+                if (x > 0 && !visited[cell - 1])
+                    options[optionCount++] = cell - 1;
+                if (z + 1 < size && !visited[cell + size])
+                    options[optionCount++] = cell + size;
+                if (z > 0 && !visited[cell - size])
+                    options[optionCount++] = cell - size;
+                if (!optionCount)
+                {
+                    carve.pop_back();
+                    continue;
+                }
+                const uint32_t next = options[rng() % optionCount];
+                if (next == cell + 1)
+                    openEast[cell] = 1;
+                else if (next == cell - 1)
+                    openEast[next] = 1;
+                else if (next == cell + size)
+                    openNorth[cell] = 1;
+                else
+                    openNorth[next] = 1;
+                visited[next] = 1;
+                carve.push_back(next);
+            }
+
+            std::vector<simd_float3> positions;
+            std::vector<uint32_t> indices;
+            auto quad = [&](simd_float3 a, simd_float3 b, simd_float3 c, simd_float3 d)
+            {
+                const uint32_t first = (uint32_t)positions.size();
+                positions.insert(positions.end(), { a, b, c, d });
+                indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+            };
+            auto wallX = [&](float x, float z0, float z1) { quad({ x, 0.f, z0 }, { x, 0.f, z1 }, { x, 1.f, z1 }, { x, 1.f, z0 }); };
+            auto wallZ = [&](float z, float x0, float x1) { quad({ x0, 0.f, z }, { x1, 0.f, z }, { x1, 1.f, z }, { x0, 1.f, z }); };
+            const float extent = (float)size;
+            quad({ 0.f, 0.f, 0.f }, { extent, 0.f, 0.f }, { extent, 0.f, extent }, { 0.f, 0.f, extent });
+            quad({ 0.f, 1.f, 0.f }, { 0.f, 1.f, extent }, { extent, 1.f, extent }, { extent, 1.f, 0.f });
+            wallX(0.f, 0.f, extent);
+            wallX(extent, 0.f, extent);
+            wallZ(0.f, 0.f, extent);
+            wallZ(extent, 0.f, extent);
+            for (uint32_t z = 0; z < size; ++z)
+            {
+                for (uint32_t x = 0; x < size; ++x)
+                {
+                    if (x + 1 < size && !openEast[z * size + x])
+                        wallX((float)(x + 1), (float)z, (float)(z + 1));
+                    if (z + 1 < size && !openNorth[z * size + x])
+                        wallZ((float)(z + 1), (float)x, (float)(x + 1));
+                }
+            }
+
+            auto start = Clock::now();
+            BspTree tree;
+            tree.build(positions.data(), sizeof(simd_float3), positions.size(), indices.data(), indices.size());
+            const double bspMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            PvsBuildSettings single;
+            single.threadCount = 1;
+            PotentiallyVisibleSet serial;
+            start = Clock::now();
+            serial.build(tree, single);
+            const double serialMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            PotentiallyVisibleSet pvs;
+            start = Clock::now();
+            pvs.build(tree);
+            const double threadedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            uint64_t visiblePairs = 0;
+            for (uint32_t leaf = 0; leaf < pvs.leafCount(); ++leaf)
+                pvs.forEachVisible(leaf, [&](uint32_t) { ++visiblePairs; });
+
+            // The set is conservative: the two ends of a segment that no wall blocks must see each
+            // other, both ways.
+            std::uniform_real_distribution<float> across(0.01f, extent - 0.01f);
+            std::uniform_real_distribution<float> height(0.1f, 0.9f);
+            size_t clear = 0;
+            size_t missing = 0;
+            for (size_t i = 0; i < kSegments; ++i)
+            {
+                const simd_float3 a = simd_make_float3(across(rng), height(rng), across(rng));
+                const simd_float3 b = simd_make_float3(across(rng), height(rng), across(rng));
+                bool blocked = false;
+                for (size_t t = 0; t < indices.size() && !blocked; t += 3)
+                    blocked = sSegmentHitsTriangle(a, b, positions[indices[t]], positions[indices[t + 1]], positions[indices[t + 2]]);
+                if (blocked)
+                    continue;
+                ++clear;
+                const uint32_t leafA = tree.findLeaf(a);
+                const uint32_t leafB = tree.findLeaf(b);
+                missing += !pvs.isVisible(leafA, leafB) || !pvs.isVisible(leafB, leafA);
+            }
+
+            const bool same = serial.compressedBytes() == pvs.compressedBytes()
+                && memcmp(serial.rowBegin(0), pvs.rowBegin(0), pvs.compressedBytes()) == 0;
+            const uint64_t pairs = (uint64_t)pvs.leafCount() * pvs.leafCount();
+            fprintf(out, "%5ux%-2u %8u %8zu %10.3f %10.3f %10.3f %10zu %10.1f %10zu %8zu%s\n",
+                    size, size, pvs.leafCount(), pvs.portals().size(), bspMs, serialMs, threadedMs, pvs.compressedBytes(),
+                    pairs ? 100.0 * (double)visiblePairs / (double)pairs : 0.0, clear, missing,
+                    same && missing == 0 ? "" : "  MISMATCH");
+        }
+    }
+}
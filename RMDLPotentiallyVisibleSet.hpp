@@ -0,0 +1,112 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPotentiallyVisibleSet.hpp  +++   +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 13:24:50      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPOTENTIALLYVISIBLESET_HPP
+# define RMDLPOTENTIALLYVISIBLESET_HPP
+
+# include <cstdint>
+# include <cstdio>
+# include <vector>
+
+# include "RMDLSimd.hpp"
+
+# include "RMDLBinarySpacePartitioning.hpp"
+
+namespace spatial
+{
+    struct PvsBuildSettings
+    {
+        float       planeEpsilon = 1e-3f;   // tolerance when clipping portals
+        float       minPortalArea = 1e-6f;  // smaller portal fragments are dropped
+        unsigned    threadCount = 0;        // 0: one per hardware thread
+    };
+
+    /// A hole in a node plane between two leaves. The plane normal points from backLeaf to frontLeaf.
+    struct PvsPortal
+    {
+        simd_float4 plane;
+        uint32_t    firstVertex;
+        uint32_t    vertexCount;
+        uint32_t    frontLeaf;
+        uint32_t    backLeaf;
+    };
+
+    /// Cook-time potentially visible set over the leaves (cells) of a BspTree.
+    ///
+    /// build() cuts every node plane down to the parts that lie inside the level bounds, inside the
+    /// node's region and outside the polygons on that plane; what is left are the portals between
+    /// leaves. Visibility then flows from each leaf through chains of portals, clipped by the
+    /// separating planes between source, pass and target portals (the classic portal-flow vis),
+    /// one leaf per task across threads. Each leaf's row is stored as an RLE bitset: non-zero bytes
+    /// are literal and a zero byte is followed by the number of zero bytes it stands for.
+    ///
+    /// At run time, look the camera up with BspTree::findLeaf, then test or iterate its row.
+    class PotentiallyVisibleSet
+    {
+    public:
+        PotentiallyVisibleSet();
+
+        void    build(const BspTree& tree, const PvsBuildSettings& settings = PvsBuildSettings());
+
+        uint32_t    leafCount() const { return (_leafCount); }
+        size_t      rowBytes() const { return ((_leafCount + 7) / 8); }
+        size_t      compressedBytes() const { return (_data.size()); }
+
+        const std::vector<PvsPortal>&   portals() const { return (_portals); }
+        const std::vector<simd_float3>& portalVertices() const { return (_portalVertices); }
+
+        /// Compressed row of leaf; its size is rowEnd - rowBegin.
+        const uint8_t*  rowBegin(uint32_t leaf) const { return (_data.data() + _rowOffsets[leaf]); }
+        const uint8_t*  rowEnd(uint32_t leaf) const { return (_data.data() + _rowOffsets[leaf + 1]); }
+
+        /// Expands the row of leaf into rowBytes() bytes at pBits, bit i of byte i / 8 for leaf i.
+        void    decompress(uint32_t leaf, uint8_t* pBits) const;
+        bool    isVisible(uint32_t fromLeaf, uint32_t toLeaf) const;
+
+        /// Calls visit(leafIndex) for every leaf visible from leaf, skipping zero runs without
+        /// expanding them.
+        template <typename Visit>
+        void    forEachVisible(uint32_t leaf, Visit&& visit) const;
+
+    private:
+        uint32_t                    _leafCount;
+        std::vector<uint8_t>        _data;
+        std::vector<uint32_t>       _rowOffsets;
+        std::vector<PvsPortal>      _portals;
+        std::vector<simd_float3>    _portalVertices;
+    };
+
+    /// Builds the set for random mazes of 4x4 to 12x12 unit cells, on one thread and on every
+    /// worker, and prints the build times and how much of the level each leaf sees to out. Random
+    /// segments that no wall blocks are checked to join leaves that see each other.
+    void    benchmarkPvs(FILE* out);
+
+    template <typename Visit>
+    void PotentiallyVisibleSet::forEachVisible(uint32_t leaf, Visit&& visit) const
+    {
+        uint32_t byteIndex = 0;
+        for (const uint8_t* p = rowBegin(leaf), *pEnd = rowEnd(leaf); p < pEnd; ++p)
+        {
+            if (*p == 0)
+            {
+                byteIndex += *++p;
+                continue;
+            }
+            for (uint32_t bit = 0; bit < 8; ++bit)
+            {
+                if (*p & (1u << bit))
+                    visit(byteIndex * 8 + bit);
+            }
+            ++byteIndex;
+        }
+    }
+}
+
+#endif /* RMDLPOTENTIALLYVISIBLESET_HPP */
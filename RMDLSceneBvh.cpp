@@ -0,0 +1,640 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSceneBvh.cpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 16:41:15      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLSceneBvh.hpp"
+
+#include "RMDLCamera.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    // Plain floats with std::min / std::max: simd_min on the struct float3 of the portable
+    // vectors is a lane-by-lane fmin, which made binning a million instances take seconds.
+    struct Bounds
+    {
+        float   min[3];
+        float   max[3];
+
+        static Bounds empty()
+        {
+            return (Bounds{ { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } });
+        }
+
+        void grow(const Bounds& other)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                min[axis] = std::min(min[axis], other.min[axis]);
+                max[axis] = std::max(max[axis], other.max[axis]);
+            }
+        }
+
+        float halfArea() const
+        {
+            const float dx = max[0] - min[0];
+            const float dy = max[1] - min[1];
+            const float dz = max[2] - min[2];
+            return (dx < 0.f ? 0.f : dx * dy + dy * dz + dz * dx);
+        }
+    };
+
+    double sMillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    void sStore(spatial::BvhNode& node, const Bounds& bounds)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            node.boundsMin[i] = bounds.min[i];
+            node.boundsMax[i] = bounds.max[i];
+        }
+    }
+
+    Bounds sLoad(const spatial::BvhNode& node)
+    {
+        return (Bounds{ { node.boundsMin[0], node.boundsMin[1], node.boundsMin[2] },
+                        { node.boundsMax[0], node.boundsMax[1], node.boundsMax[2] } });
+    }
+
+    class BvhBuilder
+    {
+    public:
+        BvhBuilder(const culling::AabbSoA& bounds, const spatial::BvhBuildSettings& settings,
+                   std::vector<spatial::BvhNode>& nodes, std::vector<uint32_t>& indices, std::vector<uint32_t>& leaves,
+                   uint32_t maxDepth)
+        : _settings(settings)
+        , _nodes(nodes)
+        , _indices(indices)
+        , _leaves(leaves)
+        , _maxDepth(maxDepth)
+        , _depth(0)
+        {
+            const float* pCenter[3] = { bounds.pCenterX, bounds.pCenterY, bounds.pCenterZ };
+            const float* pExtent[3] = { bounds.pExtentX, bounds.pExtentY, bounds.pExtentZ };
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                _min[axis].resize(bounds.count);
+                _max[axis].resize(bounds.count);
+                _centroid[axis].assign(pCenter[axis], pCenter[axis] + bounds.count);
+                for (size_t i = 0; i < bounds.count; ++i)
+                {
+                    _min[axis][i] = pCenter[axis][i] - pExtent[axis][i];
+                    _max[axis][i] = pCenter[axis][i] + pExtent[axis][i];
+                }
+            }
+            _settings.binCount = std::clamp(_settings.binCount, 2u, 64u);
+            _settings.maxLeafSize = std::max(_settings.maxLeafSize, 1u);
+        }
+
+        uint32_t build()
+        {
+            _nodes.clear();
+            _leaves.clear();
+            _indices.resize(_centroid[0].size());
+            for (uint32_t i = 0; i < _indices.size(); ++i)
+                _indices[i] = i;
+            if (_indices.empty())
+                return (0);
+            _nodes.reserve(2 * _indices.size() / _settings.maxLeafSize + 1);
+            _nodes.push_back(spatial::BvhNode());
+
+            // The top levels are split here, their passes over the instances chunked across the
+            // workers. Ranges of up to subtreeSize instances are then built as independent tasks
+            // and spliced in task order, so the tree does not depend on the thread count.
+            const uint32_t subtreeSize = std::max(kMinSubtreeSize, (uint32_t)_indices.size() / kSubtreeTasks);
+            std::vector<Subtree> subtrees;
+            Output top = { _nodes, _leaves, _depth };
+            build(top, 0, 0, (uint32_t)_indices.size(), 1, subtreeSize, &subtrees);
+
+            std::vector<std::vector<spatial::BvhNode>> subtreeNodes(subtrees.size());
+            std::vector<std::vector<uint32_t>> subtreeLeaves(subtrees.size());
+            std::vector<uint32_t> subtreeDepth(subtrees.size(), 0);
+            parallel::parallelFor(subtrees.size(), [&](size_t t)
+            {
+                const Subtree& subtree = subtrees[t];
+                subtreeNodes[t].reserve(2 * subtree.count / _settings.maxLeafSize + 1);
+                subtreeNodes[t].push_back(spatial::BvhNode());
+                Output local = { subtreeNodes[t], subtreeLeaves[t], subtreeDepth[t] };
+                build(local, 0, subtree.first, subtree.count, subtree.depth, 0, nullptr);
+            });
+
+            // Local node 0 is the subtree's root, already allocated above; local node k > 0 goes
+            // to base + k - 1, after every node of the top levels, so children still follow parents.
+            for (size_t t = 0; t < subtrees.size(); ++t)
+            {
+                const uint32_t root = subtrees[t].node;
+                const uint32_t base = (uint32_t)_nodes.size();
+                auto global = [&](uint32_t local) { return (local == 0 ? root : base + local - 1); };
+                for (spatial::BvhNode& node : subtreeNodes[t])
+                {
+                    if (node.count == 0)
+                        node.leftOrFirst = global(node.leftOrFirst);
+                }
+                _nodes[root] = subtreeNodes[t][0];
+                _nodes.insert(_nodes.end(), subtreeNodes[t].begin() + 1, subtreeNodes[t].end());
+                for (uint32_t leaf : subtreeLeaves[t])
+                    _leaves.push_back(global(leaf));
+                _depth = std::max(_depth, subtreeDepth[t]);
+            }
+            return (_depth);
+        }
+
+    private:
+        static constexpr uint32_t kMinSubtreeSize = 4096;
+        static constexpr uint32_t kSubtreeTasks = 256;
+        static constexpr uint32_t kChunkSize = 16384;   // instances per task in the chunked passes
+
+        struct Bin
+        {
+            Bounds      bounds = Bounds::empty();
+            uint32_t    count = 0;
+        };
+
+        struct BinSet
+        {
+            Bin     bins[3][64];
+        };
+
+        // A range left for the subtree tasks; its node is allocated but not filled in.
+        struct Subtree
+        {
+            uint32_t    node;
+            uint32_t    first;
+            uint32_t    count;
+            uint32_t    depth;
+        };
+
+        struct Output
+        {
+            std::vector<spatial::BvhNode>&  nodes;
+            std::vector<uint32_t>&          leaves;
+            uint32_t&                       depth;
+        };
+
+        // Calls fn(begin, end, chunk) over [first, first + count) in chunks of kChunkSize, in
+        // parallel when there is more than one.
+        template <typename Fn>
+        static void sForChunks(uint32_t first, uint32_t count, Fn&& fn)
+        {
+            parallel::parallelFor(sChunkCount(count), [&](size_t chunk)
+            {
+                const uint32_t begin = first + (uint32_t)chunk * kChunkSize;
+                fn(begin, std::min(first + count, begin + kChunkSize), chunk);
+            });
+        }
+
+        static size_t sChunkCount(uint32_t count)
+        {
+            return ((count + kChunkSize - 1) / kChunkSize);
+        }
+
+        void rangeBounds(uint32_t begin, uint32_t end, Bounds& bounds, Bounds& centroids) const
+        {
+            bounds = Bounds::empty();
+            centroids = Bounds::empty();
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float* pMin = _min[axis].data();
+                const float* pMax = _max[axis].data();
+                const float* pCentroid = _centroid[axis].data();
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    bounds.min[axis] = std::min(bounds.min[axis], pMin[i]);
+                    bounds.max[axis] = std::max(bounds.max[axis], pMax[i]);
+                    centroids.min[axis] = std::min(centroids.min[axis], pCentroid[i]);
+                    centroids.max[axis] = std::max(centroids.max[axis], pCentroid[i]);
+                }
+            }
+        }
+
+        // Fills the bins of all three axes, one axis at a time over the range.
+        void fillBins(uint32_t begin, uint32_t end, const Bounds& centroids, const float (&scale)[3], BinSet& set) const
+        {
+            const uint32_t binCount = _settings.binCount;
+            const float* pMin[3] = { _min[0].data(), _min[1].data(), _min[2].data() };
+            const float* pMax[3] = { _max[0].data(), _max[1].data(), _max[2].data() };
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float* pCentroid = _centroid[axis].data();
+                const float lo = centroids.min[axis];
+                const float axisScale = scale[axis];
+                Bin* bins = set.bins[axis];
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    Bin& bin = bins[std::min(binCount - 1, (uint32_t)((pCentroid[i] - lo) * axisScale))];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        bin.bounds.min[k] = std::min(bin.bounds.min[k], pMin[k][i]);
+                        bin.bounds.max[k] = std::max(bin.bounds.max[k], pMax[k][i]);
+                    }
+                    ++bin.count;
+                }
+            }
+        }
+
+        // rangeBounds and fillBins over large ranges: one partial result per chunk, merged in
+        // chunk order. Min, max and counts merge exactly, so the result is the serial one.
+        void chunkedRangeBounds(uint32_t first, uint32_t count, Bounds& bounds, Bounds& centroids) const
+        {
+            if (count <= kChunkSize)
+                return (rangeBounds(first, first + count, bounds, centroids));
+            std::vector<Bounds> partial(2 * sChunkCount(count));
+            sForChunks(first, count, [&](uint32_t begin, uint32_t end, size_t chunk)
+            {
+                rangeBounds(begin, end, partial[2 * chunk], partial[2 * chunk + 1]);
+            });
+            bounds = Bounds::empty();
+            centroids = Bounds::empty();
+            for (size_t chunk = 0; chunk < partial.size(); chunk += 2)
+            {
+                bounds.grow(partial[chunk]);
+                centroids.grow(partial[chunk + 1]);
+            }
+        }
+
+        void chunkedFillBins(uint32_t first, uint32_t count, const Bounds& centroids, const float (&scale)[3], BinSet& set) const
+        {
+            if (count <= kChunkSize)
+                return (fillBins(first, first + count, centroids, scale, set));
+            std::vector<BinSet> partial(sChunkCount(count));
+            sForChunks(first, count, [&](uint32_t begin, uint32_t end, size_t chunk)
+            {
+                fillBins(begin, end, centroids, scale, partial[chunk]);
+            });
+            for (const BinSet& part : partial)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    for (uint32_t b = 0; b < _settings.binCount; ++b)
+                    {
+                        set.bins[axis][b].bounds.grow(part.bins[axis][b].bounds);
+                        set.bins[axis][b].count += part.bins[axis][b].count;
+                    }
+                }
+            }
+        }
+
+        // Returns the split position in [first, first + count), or first when a leaf is cheaper.
+        uint32_t split(uint32_t first, uint32_t count, const Bounds& bounds, const Bounds& centroids)
+        {
+            const uint32_t binCount = _settings.binCount;
+            float bestCost = INFINITY;
+            int bestAxis = -1;
+            uint32_t bestBin = 0;
+
+            float extent[3];
+            float scale[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                extent[axis] = centroids.max[axis] - centroids.min[axis];
+                scale[axis] = extent[axis] > 0.f ? binCount / extent[axis] : 0.f;
+            }
+            BinSet set;
+            chunkedFillBins(first, count, centroids, scale, set);
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (!(extent[axis] > 0.f))
+                    continue;
+                const Bin* bins = set.bins[axis];
+
+                // Sweep from the right to get the cost of every "bins [b, end)" side, then from the left.
+                float rightArea[64];
+                uint32_t rightCount[64];
+                Bounds right = Bounds::empty();
+                uint32_t n = 0;
+                for (uint32_t b = binCount - 1; b > 0; --b)
+                {
+                    right.grow(bins[b].bounds);
+                    n += bins[b].count;
+                    rightArea[b] = right.halfArea();
+                    rightCount[b] = n;
+                }
+                Bounds left = Bounds::empty();
+                n = 0;
+                for (uint32_t b = 1; b < binCount; ++b)
+                {
+                    left.grow(bins[b - 1].bounds);
+                    n += bins[b - 1].count;
+                    const float cost = n * left.halfArea() + rightCount[b] * rightArea[b];
+                    if (n && rightCount[b] && cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = b;
+                    }
+                }
+            }
+
+            const float parentArea = bounds.halfArea();
+            const bool mustSplit = count > _settings.maxLeafSize * 8;
+            if (bestAxis < 0)
+                return (mustSplit ? first + count / 2 : first);
+            if (!mustSplit && parentArea > 0.f && _settings.traversalCost * parentArea + bestCost >= count * parentArea)
+                return (first);
+
+            const float lo = centroids.min[bestAxis];
+            const float axisScale = scale[bestAxis];
+            const float* pCentroid = _centroid[bestAxis].data();
+            return (partition(first, count, [&](uint32_t i)
+            {
+                return (std::min(binCount - 1, (uint32_t)((pCentroid[i] - lo) * axisScale)) < bestBin);
+            }));
+        }
+
+        // std::partition's two-ended sweep over the indices and, along with them, the instance
+        // arrays, so every pass over a range reads it in order.
+        template <typename Pred>
+        uint32_t partition(uint32_t first, uint32_t count, Pred&& pred)
+        {
+            uint32_t left = first;
+            uint32_t right = first + count;
+            while (true)
+            {
+                while (left < right && pred(left))
+                    ++left;
+                if (left == right)
+                    return (left);
+                --right;
+                while (left < right && !pred(right))
+                    --right;
+                if (left == right)
+                    return (left);
+                std::swap(_indices[left], _indices[right]);
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    std::swap(_min[axis][left], _min[axis][right]);
+                    std::swap(_max[axis][left], _max[axis][right]);
+                    std::swap(_centroid[axis][left], _centroid[axis][right]);
+                }
+                ++left;
+            }
+        }
+
+        // Ranges of at most subtreeSize instances are appended to pSubtrees instead of built.
+        void build(Output& out, uint32_t nodeIndex, uint32_t first, uint32_t count, uint32_t depth,
+                   uint32_t subtreeSize, std::vector<Subtree>* pSubtrees)
+        {
+            if (pSubtrees && count <= subtreeSize)
+            {
+                pSubtrees->push_back(Subtree{ nodeIndex, first, count, depth });
+                return;
+            }
+            out.depth = std::max(out.depth, depth);
+            Bounds bounds;
+            Bounds centroids;
+            chunkedRangeBounds(first, count, bounds, centroids);
+            sStore(out.nodes[nodeIndex], bounds);
+
+            if (count <= _settings.maxLeafSize || depth >= _maxDepth)
+            {
+                makeLeaf(out, nodeIndex, first, count);
+                return;
+            }
+            uint32_t mid = split(first, count, bounds, centroids);
+            if (mid == first)
+            {
+                makeLeaf(out, nodeIndex, first, count);
+                return;
+            }
+
+            const uint32_t left = (uint32_t)out.nodes.size();
+            out.nodes.push_back(spatial::BvhNode());
+            out.nodes.push_back(spatial::BvhNode());
+            out.nodes[nodeIndex].leftOrFirst = left;
+            out.nodes[nodeIndex].count = 0;
+            build(out, left, first, mid - first, depth + 1, subtreeSize, pSubtrees);
+            build(out, left + 1, mid, first + count - mid, depth + 1, subtreeSize, pSubtrees);
+        }
+
+        static void makeLeaf(Output& out, uint32_t nodeIndex, uint32_t first, uint32_t count)
+        {
+            out.nodes[nodeIndex].leftOrFirst = first;
+            out.nodes[nodeIndex].count = count;
+            out.leaves.push_back(nodeIndex);
+        }
+
+        spatial::BvhBuildSettings       _settings;
+        std::vector<spatial::BvhNode>&  _nodes;
+        std::vector<uint32_t>&          _indices;
+        std::vector<uint32_t>&          _leaves;
+        std::vector<float>              _min[3];    // instance bounds and centers per axis, in _indices order
+        std::vector<float>              _max[3];
+        std::vector<float>              _centroid[3];
+        uint32_t                        _maxDepth;
+        uint32_t                        _depth;
+    };
+}
+
+namespace spatial
+{
+    SceneBvh::SceneBvh()
+    : _depth(0)
+    , _stats()
+    {
+    }
+
+    void SceneBvh::build(const culling::AabbSoA& bounds, const BvhBuildSettings& settings)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        BvhBuilder builder(bounds, settings, _nodes, _indices, _leaves, kMaxDepth);
+        _depth = builder.build();
+        _stats.buildMs = sMillisecondsSince(start);
+        refit(bounds);
+    }
+
+    void SceneBvh::refit(const culling::AabbSoA& bounds, unsigned threadCount)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        _entryMin.resize(_indices.size());
+        _entryMax.resize(_indices.size());
+
+        // Leaves in parallel, then interior nodes children-first: children are always stored
+        // after their parent, so walking the array backwards visits them in the right order.
+        constexpr size_t kLeavesPerTask = 1024;
+        parallel::parallelFor((_leaves.size() + kLeavesPerTask - 1) / kLeavesPerTask, [&](size_t task)
+        {
+            const size_t end = std::min(_leaves.size(), (task + 1) * kLeavesPerTask);
+            for (size_t l = task * kLeavesPerTask; l < end; ++l)
+            {
+                BvhNode& node = _nodes[_leaves[l]];
+                Bounds leafBounds = Bounds::empty();
+                for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i)
+                {
+                    const uint32_t index = _indices[i];
+                    const Bounds entry = { { bounds.pCenterX[index] - bounds.pExtentX[index],
+                                             bounds.pCenterY[index] - bounds.pExtentY[index],
+                                             bounds.pCenterZ[index] - bounds.pExtentZ[index] },
+                                           { bounds.pCenterX[index] + bounds.pExtentX[index],
+                                             bounds.pCenterY[index] + bounds.pExtentY[index],
+                                             bounds.pCenterZ[index] + bounds.pExtentZ[index] } };
+                    _entryMin[i] = simd_make_float3(entry.min[0], entry.min[1], entry.min[2]);
+                    _entryMax[i] = simd_make_float3(entry.max[0], entry.max[1], entry.max[2]);
+                    leafBounds.grow(entry);
+                }
+                sStore(node, leafBounds);
+            }
+        }, threadCount);
+
+        for (size_t n = _nodes.size(); n-- > 0; )
+        {
+            BvhNode& node = _nodes[n];
+            if (node.count)
+                continue;
+            Bounds nodeBounds = sLoad(_nodes[node.leftOrFirst]);
+            nodeBounds.grow(sLoad(_nodes[node.leftOrFirst + 1]));
+            sStore(node, nodeBounds);
+        }
+        _stats.refitMs = sMillisecondsSince(start);
+    }
+
+    Containment SceneBvh::classify(const culling::Frustum& frustum, const float (&boundsMin)[3], const float (&boundsMax)[3], uint8_t& planeMask)
+    {
+        const simd_float3 lo = simd_make_float3(boundsMin[0], boundsMin[1], boundsMin[2]);
+        const simd_float3 hi = simd_make_float3(boundsMax[0], boundsMax[1], boundsMax[2]);
+        const simd_float3 center = (lo + hi) * 0.5f;
+        const simd_float3 extent = (hi - lo) * 0.5f;
+
+        for (int k = 0; k < 6; ++k)
+        {
+            if (!(planeMask & (1u << k)))
+                continue;
+            const simd_float4 plane = frustum.planes[k];
+            const simd_float3 normal = simd_make_float3(plane.x, plane.y, plane.z);
+            const float distance = simd_dot(normal, center) + plane.w;
+            const float reach = simd_dot(simd_abs(normal), extent);
+            if (distance < -reach)
+                return (Containment::Outside);
+            if (distance >= reach)
+                planeMask &= ~(1u << k);
+        }
+        return (planeMask ? Containment::Partial : Containment::Inside);
+    }
+
+    uint32_t SceneBvh::subtreeFirst(uint32_t node) const
+    {
+        while (_nodes[node].count == 0)
+            node = _nodes[node].leftOrFirst;
+        return (_nodes[node].leftOrFirst);
+    }
+
+    uint32_t SceneBvh::subtreeEnd(uint32_t node) const
+    {
+        while (_nodes[node].count == 0)
+            node = _nodes[node].leftOrFirst + 1;
+        return (_nodes[node].leftOrFirst + _nodes[node].count);
+    }
+
+    size_t SceneBvh::cull(const culling::Frustum& frustum, std::vector<uint32_t>& visibleIndices)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        visibleIndices.clear();
+        _stats.instancesTested = 0;
+        _stats.nodesVisited = traverse(frustum, [&](const uint32_t* pIndices, uint32_t count, Containment containment)
+        {
+            if (containment == Containment::Inside)
+            {
+                visibleIndices.insert(visibleIndices.end(), pIndices, pIndices + count);
+                return;
+            }
+            const uint32_t first = (uint32_t)(pIndices - _indices.data());
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                float lo[3] = { _entryMin[i].x, _entryMin[i].y, _entryMin[i].z };
+                float hi[3] = { _entryMax[i].x, _entryMax[i].y, _entryMax[i].z };
+                uint8_t planeMask = 0x3F;
+                if (classify(frustum, lo, hi, planeMask) != Containment::Outside)
+                    visibleIndices.push_back(_indices[i]);
+            }
+            _stats.instancesTested += count;
+        });
+        _stats.queryMs = sMillisecondsSince(start);
+        return (visibleIndices.size());
+    }
+
+    void benchmarkSceneBvh(FILE* out)
+    {
+        constexpr int kRuns = 5;
+        constexpr float kWorld = 2000.f;
+        const size_t counts[] = { 10000, 100000, 1000000 };
+
+        RMDLCamera camera;
+        camera.initPerspectiveWithPosition(simd::float3{ 0.f, 0.f, 0.f }, simd::float3{ 0.f, 0.f, 1.f },
+                                           simd::float3{ 0.f, 1.f, 0.f }, (float)M_PI / 3.f, 16.f / 9.f, 0.1f, 1000.f);
+        const culling::Frustum frustum = culling::Frustum::fromCamera(camera);
+
+        fprintf(out, "%10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+                "instances", "visible", "depth", "build ms", "refit ms", "bvh ms", "flat ms", "nodes", "tested");
+        for (size_t count : counts)
+        {
+            // A flat world around the camera, instances a few units across.
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> horizontal(-kWorld * 0.5f, kWorld * 0.5f);
+            std::uniform_real_distribution<float> vertical(-50.f, 50.f);
+            std::uniform_real_distribution<float> extent(0.5f, 2.f);
+            std::uniform_real_distribution<float> drift(-0.5f, 0.5f);
+            std::vector<float> cx(count), cy(count), cz(count), ex(count), ey(count), ez(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                cx[i] = horizontal(rng);
+                cy[i] = vertical(rng);
+                cz[i] = horizontal(rng);
+                ex[i] = extent(rng);
+                ey[i] = extent(rng);
+                ez[i] = extent(rng);
+            }
+            const culling::AabbSoA bounds = { cx.data(), cy.data(), cz.data(), ex.data(), ey.data(), ez.data(), count };
+
+            SceneBvh bvh;
+            culling::FrustumCuller flat;
+            std::vector<uint32_t> bvhVisible;
+            std::vector<uint32_t> flatVisible;
+            double buildMs = 1e30;
+            double refitMs = 1e30;
+            double bvhMs = 1e30;
+            double flatMs = 1e30;
+            for (int run = 0; run < kRuns; ++run)
+            {
+                bvh.build(bounds);
+                buildMs = std::min(buildMs, bvh.stats().buildMs);
+            }
+            for (int run = 0; run < kRuns; ++run)
+            {
+                // Every instance moves a little, as a frame of animation would.
+                for (size_t i = 0; i < count; ++i)
+                {
+                    cx[i] += drift(rng);
+                    cz[i] += drift(rng);
+                }
+                bvh.refit(bounds);
+                refitMs = std::min(refitMs, bvh.stats().refitMs);
+                bvh.cull(frustum, bvhVisible);
+                bvhMs = std::min(bvhMs, bvh.stats().queryMs);
+                flat.cull(frustum, bounds, flatVisible);
+                flatMs = std::min(flatMs, flat.stats().milliseconds);
+            }
+
+            // Both reject a box only when it is entirely outside one plane, so the sets must agree.
+            std::vector<uint32_t> sorted = bvhVisible;
+            std::sort(sorted.begin(), sorted.end());
+            fprintf(out, "%10zu %10zu %10u %10.3f %10.3f %10.3f %10.3f %10llu %10llu%s\n",
+                    count, bvhVisible.size(), bvh.depth(), buildMs, refitMs, bvhMs, flatMs,
+                    (unsigned long long)bvh.stats().nodesVisited, (unsigned long long)bvh.stats().instancesTested,
+                    sorted == flatVisible ? "" : "  MISMATCH");
+        }
+    }
+}
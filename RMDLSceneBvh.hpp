@@ -0,0 +1,156 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSceneBvh.hpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 16:41:09      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSCENEBVH_HPP
+# define RMDLSCENEBVH_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstdint>
+# include <cstdio>
+# include <vector>
+
+# include "RMDLFrustumCulling.hpp"
+
+namespace spatial
+{
+    struct BvhBuildSettings
+    {
+        uint32_t    binCount = 16;      // SAH bins per axis
+        uint32_t    maxLeafSize = 4;
+        float       traversalCost = 1.f;    // relative to testing one instance
+    };
+
+    /// 32 bytes. Interior nodes have count 0 and their children at leftOrFirst and leftOrFirst + 1;
+    /// leaves cover indices()[leftOrFirst, leftOrFirst + count).
+    struct BvhNode
+    {
+        float       boundsMin[3];
+        uint32_t    leftOrFirst;
+        float       boundsMax[3];
+        uint32_t    count;
+    };
+
+    static_assert(sizeof(BvhNode) == 32);
+
+    enum class Containment : uint8_t
+    {
+        Outside,
+        Inside,
+        Partial
+    };
+
+    struct BvhStats
+    {
+        double      buildMs;
+        double      refitMs;
+        double      queryMs;
+        uint64_t    nodesVisited;       // by the last cull()
+        uint64_t    instancesTested;    // individually, in partially visible leaves
+    };
+
+    /// Bounding volume hierarchy over scene instance bounds, for hierarchical frustum culling.
+    ///
+    /// build() is a binned SAH build, partitioning the instance indices in place, so every subtree
+    /// owns a contiguous range of indices(). refit() recomputes the bounds bottom-up after instances
+    /// move, keeping the topology; rebuild once refits have made the tree loose.
+    ///
+    /// Traversal classifies each node against the frustum as outside, inside or partial. Outside
+    /// subtrees are skipped and inside subtrees are accepted whole as one index range, with no
+    /// more tests; only partial nodes descend, and each level only re-tests the planes its parent
+    /// straddled.
+    class SceneBvh
+    {
+    public:
+        SceneBvh();
+
+        void    build(const culling::AabbSoA& bounds, const BvhBuildSettings& settings = BvhBuildSettings());
+        void    refit(const culling::AabbSoA& bounds, unsigned threadCount = 0);
+
+        /// Calls visit(pIndices, count, containment) with containment Inside for whole accepted
+        /// subtrees and Partial for leaves that straddle the frustum; Outside is never reported.
+        /// Returns the number of nodes classified.
+        template <typename Visit>
+        uint64_t    traverse(const culling::Frustum& frustum, Visit&& visit) const;
+
+        /// Visible instance indices, in tree order. Instances of partial leaves are tested one by one.
+        size_t  cull(const culling::Frustum& frustum, std::vector<uint32_t>& visibleIndices);
+
+        const std::vector<BvhNode>&     nodes() const { return (_nodes); }
+        const std::vector<uint32_t>&    indices() const { return (_indices); }
+        uint32_t                        depth() const { return (_depth); }
+        const BvhStats&                 stats() const { return (_stats); }
+
+        /// Tests the bounds against the planes whose bit is set in planeMask, clearing the bits of
+        /// planes the bounds are entirely inside of.
+        static Containment  classify(const culling::Frustum& frustum, const float (&boundsMin)[3], const float (&boundsMax)[3], uint8_t& planeMask);
+
+    private:
+        static constexpr uint32_t kMaxDepth = 64;     // deeper ranges become (large) leaves
+
+        uint32_t    subtreeFirst(uint32_t node) const;
+        uint32_t    subtreeEnd(uint32_t node) const;
+
+        std::vector<BvhNode>        _nodes;
+        std::vector<uint32_t>       _indices;
+        std::vector<uint32_t>       _leaves;
+        std::vector<simd_float3>    _entryMin;      // instance bounds in indices() order
+        std::vector<simd_float3>    _entryMax;
+        uint32_t                    _depth;
+        BvhStats                    _stats;
+    };
+
+    /// Builds, refits and culls 10k to 1M instance boxes spread over a 2000 unit world with a
+    /// 60 degree camera at its center, against FrustumCuller over the same boxes, and prints the
+    /// best times to out.
+    void    benchmarkSceneBvh(FILE* out);
+
+    template <typename Visit>
+    uint64_t SceneBvh::traverse(const culling::Frustum& frustum, Visit&& visit) const
+    {
+        if (_nodes.empty())
+            return (0);
+
+        struct Entry
+        {
+            uint32_t    node;
+            uint8_t     planeMask;
+        };
+        Entry stack[kMaxDepth * 2];
+        uint32_t top = 0;
+        uint64_t visited = 0;
+        stack[top++] = { 0, 0x3F };
+
+        while (top)
+        {
+            const Entry entry = stack[--top];
+            const BvhNode& node = _nodes[entry.node];
+            uint8_t planeMask = entry.planeMask;
+            const Containment containment = classify(frustum, node.boundsMin, node.boundsMax, planeMask);
+            ++visited;
+            if (containment == Containment::Outside)
+                continue;
+            if (containment == Containment::Inside)
+            {
+                const uint32_t first = subtreeFirst(entry.node);
+                visit(_indices.data() + first, subtreeEnd(entry.node) - first, Containment::Inside);
+            }
+            else if (node.count)
+                visit(_indices.data() + node.leftOrFirst, node.count, Containment::Partial);
+            else
+            {
+                stack[top++] = { node.leftOrFirst + 1, planeMask };
+                stack[top++] = { node.leftOrFirst, planeMask };
+            }
+        }
+        return (visited);
+    }
+}
+
+#endif /* RMDLSCENEBVH_HPP */
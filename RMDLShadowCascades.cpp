@@ -0,0 +1,133 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLShadowCascades.cpp       +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 17:52:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLShadowCascades.hpp"
+
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace shadow
+{
+    void ShadowCascades::update(RMDLCamera& camera, simd::float3 lightDirection, const CascadeSettings& settings)
+    {
+        const float nearZ = camera.nearPlane();
+        const float farZ = settings.maxDistance > 0.f ? std::min(settings.maxDistance, camera.farPlane()) : camera.farPlane();
+        const simd::float3 eye = camera.position();
+        const simd::float3 forward = simd::normalize(camera.direction());
+
+        // Half size of the view slice per unit of distance (perspective) or in absolute units (parallel).
+        float halfHeight;
+        float halfWidth;
+        if (camera.isPerspective())
+            halfHeight = tanf(camera.viewAngle() * 0.5f);
+        else
+            halfHeight = camera.width() * 0.5f;
+        halfWidth = halfHeight * camera.aspectRatio();
+        const float diagonal = sqrtf(halfWidth * halfWidth + halfHeight * halfHeight);
+
+        const simd::float3 lightDir = simd::normalize(lightDirection);
+        const simd::float3 lightUp = fabsf(lightDir.y) < 0.99f ? simd::float3{ 0.f, 1.f, 0.f } : simd::float3{ 1.f, 0.f, 0.f };
+        const simd::float3 lightRight = simd::normalize(simd::cross(lightUp, lightDir));
+        const simd::float3 lightY = simd::cross(lightDir, lightRight);
+
+        float splitNear = nearZ;
+        for (uint32_t i = 0; i < kCascadeCount; ++i)
+        {
+            const float t = (float)(i + 1) / kCascadeCount;
+            const float logSplit = nearZ * powf(farZ / nearZ, t);
+            const float uniformSplit = nearZ + (farZ - nearZ) * t;
+            const float splitFar = settings.splitLambda * logSplit + (1.f - settings.splitLambda) * uniformSplit;
+
+            // Smallest sphere around the slice's corners with its center on the view axis. The
+            // corners at distance d are d * diagonal (perspective) or diagonal (parallel) off axis.
+            const float nearRadius = camera.isPerspective() ? splitNear * diagonal : diagonal;
+            const float farRadius = camera.isPerspective() ? splitFar * diagonal : diagonal;
+            float centerDistance = (splitFar * splitFar - splitNear * splitNear + farRadius * farRadius - nearRadius * nearRadius)
+                                 / (2.f * (splitFar - splitNear));
+            centerDistance = std::clamp(centerDistance, splitNear, splitFar);
+            const float radius = std::max(sqrtf((centerDistance - splitNear) * (centerDistance - splitNear) + nearRadius * nearRadius),
+                                          sqrtf((splitFar - centerDistance) * (splitFar - centerDistance) + farRadius * farRadius));
+
+            Cascade& cascade = _cascades[i];
+            cascade.splitNear = splitNear;
+            cascade.splitFar = splitFar;
+            cascade.center = eye + forward * centerDistance;
+            // Rounding the radius up to 1/16 keeps it (and the texel size) bit-stable across frames.
+            cascade.radius = ceilf(radius * 16.f) / 16.f;
+            cascade.texelSize = 2.f * cascade.radius / settings.resolution;
+
+            // Snap the center to whole texels in light space; depth along the light is left free.
+            const float x = floorf(simd::dot(cascade.center, lightRight) / cascade.texelSize) * cascade.texelSize;
+            const float y = floorf(simd::dot(cascade.center, lightY) / cascade.texelSize) * cascade.texelSize;
+            const float z = simd::dot(cascade.center, lightDir);
+            const simd::float3 snapped = lightRight * x + lightY * y + lightDir * z;
+            const float pullback = cascade.radius + settings.casterDistance;
+
+            cascade.camera.initParallelWithPosition(snapped - lightDir * pullback, lightDir, lightY,
+                                                    2.f * cascade.radius, 2.f * cascade.radius,
+                                                    0.f, pullback + cascade.radius);
+            splitNear = splitFar;
+        }
+    }
+
+    void ShadowCascades::writeUniforms(RMDLUniforms& uniforms)
+    {
+        for (uint32_t i = 0; i < kCascadeCount; ++i)
+            uniforms.shadowCameraUniforms[i] = _cascades[i].camera.uniforms();
+    }
+
+    void ShadowCascades::cullCasters(const culling::AabbSoA& casters, std::vector<uint32_t> (&visible)[kCascadeCount], unsigned threadCount)
+    {
+        // The light cameras are parallel, so the shared culler tests them as three slabs.
+        culling::Frustum frustums[kCascadeCount];
+        for (uint32_t c = 0; c < kCascadeCount; ++c)
+        {
+            const RMDLCameraUniforms uniforms = _cascades[c].camera.uniforms();
+            frustums[c] = culling::Frustum::fromPlanes(uniforms.frustumPlanes, true);
+        }
+
+        constexpr size_t kChunkSize = 4096;
+        const size_t chunkCount = (casters.count + kChunkSize - 1) / kChunkSize;
+        std::vector<std::vector<uint32_t>> chunkVisible(chunkCount * kCascadeCount);
+
+        parallel::parallelFor(chunkCount, [&](size_t chunk)
+        {
+            const size_t end = std::min(casters.count, (chunk + 1) * kChunkSize);
+            for (size_t base = chunk * kChunkSize; base < end; base += 8)
+            {
+                const size_t lanes = std::min<size_t>(8, end - base);
+                for (uint32_t c = 0; c < kCascadeCount; ++c)
+                {
+                    const simd_int8 inside = culling::visibleMask(frustums[c], casters, base, lanes);
+                    if (!simd_any(inside))
+                        continue;
+                    std::vector<uint32_t>& out = chunkVisible[chunk * kCascadeCount + c];
+                    for (size_t lane = 0; lane < lanes; ++lane)
+                    {
+                        if (inside[lane])
+                            out.push_back((uint32_t)(base + lane));
+                    }
+                }
+            }
+        }, threadCount);
+
+        for (uint32_t c = 0; c < kCascadeCount; ++c)
+        {
+            visible[c].clear();
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                const std::vector<uint32_t>& in = chunkVisible[chunk * kCascadeCount + c];
+                visible[c].insert(visible[c].end(), in.begin(), in.end());
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLShadowCascades.hpp       +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 17:52:40      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSHADOWCASCADES_HPP
+# define RMDLSHADOWCASCADES_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstdint>
+# include <vector>
+
+# include "RMDLCamera.hpp"
+# include "RMDLFrustumCulling.hpp"
+
+namespace shadow
+{
+    /// Matches RMDLUniforms::shadowCameraUniforms.
+    constexpr uint32_t kCascadeCount = 3;
+
+    struct CascadeSettings
+    {
+        float       splitLambda = 0.75f;    // 0: uniform splits, 1: logarithmic
+        float       maxDistance = 0.f;      // shadows end here; 0: the camera's far plane
+        uint32_t    resolution = 2048;      // shadow map texels per side, for snapping
+        float       casterDistance = 100.f; // how far towards the light casters are kept
+    };
+
+    struct Cascade
+    {
+        float           splitNear;      // view distance range covered by this cascade
+        float           splitFar;
+        simd::float3    center;         // bounding sphere of the slice, before snapping
+        float           radius;
+        float           texelSize;      // world units per shadow map texel
+        RMDLCamera      camera;         // parallel light camera
+    };
+
+    /// Cascaded shadow map cameras for the main camera.
+    ///
+    /// The view range is split with the practical scheme (a blend of logarithmic and uniform
+    /// splits). Each slice is enclosed in a bounding sphere rather than a tight box, so the light
+    /// projection keeps the same size while the camera turns; its center is snapped to whole
+    /// shadow map texels in light space so it does not shimmer while the camera moves. Each
+    /// cascade is an RMDLCamera in parallel mode, so its uniforms, including frustumPlanes, come
+    /// from RMDLCamera::uniforms like the main camera's.
+    class ShadowCascades
+    {
+    public:
+        void    update(RMDLCamera& camera, simd::float3 lightDirection, const CascadeSettings& settings = CascadeSettings());
+
+        /// Fills uniforms.shadowCameraUniforms.
+        void    writeUniforms(RMDLUniforms& uniforms);
+
+        const Cascade&  cascade(uint32_t i) const { return (_cascades[i]); }
+
+        /// One pass over the casters for all cascades: visible[i] receives the indices of the
+        /// boxes that can cast into cascade i. The light cameras start casterDistance before the
+        /// cascade, so casters that far towards the light are kept.
+        void    cullCasters(const culling::AabbSoA& casters, std::vector<uint32_t> (&visible)[kCascadeCount], unsigned threadCount = 0);
+
+    private:
+        Cascade     _cascades[kCascadeCount];
+    };
+}
+
+#endif /* RMDLSHADOWCASCADES_HPP */
@@ -0,0 +1,457 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSimd.hpp                 +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 09:14:52      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSIMD_HPP
+# define RMDLSIMD_HPP
+
+// <simd/simd.h> where the SDK has it, and otherwise the part of it the code that runs without a
+// GPU uses, so that the game logic and its benchmarks build with g++ on Linux. The Metal side
+// keeps including <simd/simd.h> directly.
+//
+// The wide vectors are GCC / Clang vector extensions like Apple's, so their operators behave the
+// same; float2 / float3 / float4 and the matrices are plain structs with the same size and
+// alignment. Only the swizzle .xyz of float4 is provided. Neither vector kind converts from a
+// scalar implicitly on GCC: use simdSplat.
+
+# if __has_include(<simd/simd.h>)
+
+#  include <simd/simd.h>
+
+# else
+
+#  include <cmath>
+#  include <cstdint>
+
+// Without AVX, GCC notes on every function that takes a 32-byte vector that its ABI changed.
+// These are all inline and never cross a library boundary.
+#  if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC diagnostic ignored "-Wpsabi"
+#  endif
+
+typedef float       simd_float8 __attribute__((__vector_size__(32)));
+typedef int32_t     simd_int4   __attribute__((__vector_size__(16)));
+typedef uint32_t    simd_uint4  __attribute__((__vector_size__(16)));
+typedef int32_t     simd_int8   __attribute__((__vector_size__(32)));
+typedef uint32_t    simd_uint8  __attribute__((__vector_size__(32)));
+typedef long        simd_long1;
+typedef long        simd_long4  __attribute__((__vector_size__(32)));
+typedef long        simd_long8  __attribute__((__vector_size__(64)));
+
+struct alignas(8) simd_float2
+{
+    float   x, y;
+
+    constexpr float  operator[](int i) const { return (i == 0 ? x : y); }
+    float&           operator[](int i) { return ((&x)[i]); }
+};
+
+struct alignas(16) simd_float3
+{
+    float   x, y, z;
+
+    constexpr float  operator[](int i) const { return (i == 0 ? x : i == 1 ? y : z); }
+    float&           operator[](int i) { return ((&x)[i]); }
+};
+
+struct alignas(16) simd_float4
+{
+    union
+    {
+        struct
+        {
+            float   x, y, z, w;
+        };
+        simd_float3 xyz;
+    };
+
+    constexpr float  operator[](int i) const { return (i == 0 ? x : i == 1 ? y : i == 2 ? z : w); }
+    float&           operator[](int i) { return ((&x)[i]); }
+};
+
+struct simd_float3x3
+{
+    simd_float3 columns[3];
+};
+
+struct simd_float4x3
+{
+    simd_float3 columns[4];
+};
+
+struct simd_float4x4
+{
+    simd_float4 columns[4];
+};
+
+typedef simd_float2     vector_float2;
+typedef simd_float3     vector_float3;
+typedef simd_float4     vector_float4;
+typedef simd_float3x3   matrix_float3x3;
+typedef simd_float4x3   matrix_float4x3;
+typedef simd_float4x4   matrix_float4x4;
+
+constexpr simd_float4x4 matrix_identity_float4x4 = { {
+    { 1.f, 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f, 0.f }, { 0.f, 0.f, 0.f, 1.f } } };
+constexpr simd_float3x3 matrix_identity_float3x3 = { {
+    { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } } };
+
+// Lane-wise arithmetic on the struct vectors, with a scalar on either side.
+
+#  define RMDL_SIMD_LANES_2(op, a, b)  { a.x op b.x, a.y op b.y }
+#  define RMDL_SIMD_LANES_3(op, a, b)  { a.x op b.x, a.y op b.y, a.z op b.z }
+#  define RMDL_SIMD_LANES_4(op, a, b)  { a.x op b.x, a.y op b.y, a.z op b.z, a.w op b.w }
+#  define RMDL_SIMD_SPLAT_2(s)         { s, s }
+#  define RMDL_SIMD_SPLAT_3(s)         { s, s, s }
+#  define RMDL_SIMD_SPLAT_4(s)         { s, s, s, s }
+
+#  define RMDL_SIMD_OPERATOR(N, op) \
+    constexpr simd_float##N operator op(simd_float##N a, simd_float##N b) { return (simd_float##N RMDL_SIMD_LANES_##N(op, a, b)); } \
+    constexpr simd_float##N operator op(simd_float##N a, float s) { const simd_float##N b = RMDL_SIMD_SPLAT_##N(s); return (a op b); } \
+    constexpr simd_float##N operator op(float s, simd_float##N b) { const simd_float##N a = RMDL_SIMD_SPLAT_##N(s); return (a op b); } \
+    constexpr simd_float##N& operator op##=(simd_float##N& a, simd_float##N b) { return (a = a op b); } \
+    constexpr simd_float##N& operator op##=(simd_float##N& a, float s) { return (a = a op s); }
+
+#  define RMDL_SIMD_OPERATORS(N) \
+    RMDL_SIMD_OPERATOR(N, +) \
+    RMDL_SIMD_OPERATOR(N, -) \
+    RMDL_SIMD_OPERATOR(N, *) \
+    RMDL_SIMD_OPERATOR(N, /) \
+    constexpr simd_float##N operator-(simd_float##N a) { return (0.f - a); }
+
+RMDL_SIMD_OPERATORS(2)
+RMDL_SIMD_OPERATORS(3)
+RMDL_SIMD_OPERATORS(4)
+
+#  undef RMDL_SIMD_OPERATORS
+#  undef RMDL_SIMD_OPERATOR
+
+constexpr simd_float2 simd_make_float2(float x, float y) { return (simd_float2{ x, y }); }
+constexpr simd_float3 simd_make_float3(float x, float y, float z) { return (simd_float3{ x, y, z }); }
+constexpr simd_float3 simd_make_float3(simd_float2 xy, float z) { return (simd_float3{ xy.x, xy.y, z }); }
+constexpr simd_float3 simd_make_float3(simd_float4 v) { return (simd_float3{ v.x, v.y, v.z }); }
+constexpr simd_float4 simd_make_float4(float x, float y, float z, float w) { return (simd_float4{ x, y, z, w }); }
+constexpr simd_float4 simd_make_float4(simd_float3 xyz, float w) { return (simd_float4{ xyz.x, xyz.y, xyz.z, w }); }
+
+#  define RMDL_SIMD_LANEWISE(N, name, expr) \
+    inline simd_float##N name(simd_float##N a, simd_float##N b) \
+    { \
+        simd_float##N r = a; \
+        for (int i = 0; i < N; ++i) \
+            r[i] = expr; \
+        return (r); \
+    }
+
+#  define RMDL_SIMD_GEOMETRY(N) \
+    RMDL_SIMD_LANEWISE(N, simd_min, std::fmin(a[i], b[i])) \
+    RMDL_SIMD_LANEWISE(N, simd_max, std::fmax(a[i], b[i])) \
+    inline simd_float##N simd_abs(simd_float##N a) { return (simd_max(a, -a)); } \
+    inline simd_float##N simd_clamp(simd_float##N x, simd_float##N lo, simd_float##N hi) { return (simd_min(simd_max(x, lo), hi)); } \
+    inline simd_float##N simd_clamp(simd_float##N x, float lo, float hi) { return (simd_clamp(x, simd_float##N RMDL_SIMD_SPLAT_##N(lo), simd_float##N RMDL_SIMD_SPLAT_##N(hi))); } \
+    inline simd_float##N simd_mix(simd_float##N x, simd_float##N y, simd_float##N t) { return (x + t * (y - x)); } \
+    inline float simd_dot(simd_float##N a, simd_float##N b) \
+    { \
+        float sum = 0.f; \
+        for (int i = 0; i < N; ++i) \
+            sum += a[i] * b[i]; \
+        return (sum); \
+    } \
+    inline float simd_length_squared(simd_float##N a) { return (simd_dot(a, a)); } \
+    inline float simd_length(simd_float##N a) { return (std::sqrt(simd_dot(a, a))); } \
+    inline float simd_distance(simd_float##N a, simd_float##N b) { return (simd_length(a - b)); } \
+    inline simd_float##N simd_normalize(simd_float##N a) { return (a / simd_length(a)); } \
+    inline float simd_reduce_min(simd_float##N a) \
+    { \
+        float m = a[0]; \
+        for (int i = 1; i < N; ++i) \
+            m = std::fmin(m, a[i]); \
+        return (m); \
+    } \
+    inline float simd_reduce_max(simd_float##N a) \
+    { \
+        float m = a[0]; \
+        for (int i = 1; i < N; ++i) \
+            m = std::fmax(m, a[i]); \
+        return (m); \
+    }
+
+RMDL_SIMD_GEOMETRY(2)
+RMDL_SIMD_GEOMETRY(3)
+RMDL_SIMD_GEOMETRY(4)
+
+#  undef RMDL_SIMD_GEOMETRY
+#  undef RMDL_SIMD_LANEWISE
+#  undef RMDL_SIMD_SPLAT_2
+#  undef RMDL_SIMD_SPLAT_3
+#  undef RMDL_SIMD_SPLAT_4
+#  undef RMDL_SIMD_LANES_2
+#  undef RMDL_SIMD_LANES_3
+#  undef RMDL_SIMD_LANES_4
+
+inline simd_float3 simd_cross(simd_float3 a, simd_float3 b)
+{
+    return (simd_float3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x });
+}
+
+inline simd_float4 simd_float(simd_int4 v)
+{
+    return (simd_float4{ (float)v[0], (float)v[1], (float)v[2], (float)v[3] });
+}
+
+inline simd_float8 simd_float(simd_int8 v) { return (__builtin_convertvector(v, simd_float8)); }
+// Truncates, like Apple's; lanes out of int range are undefined there too.
+inline simd_int8 simd_int(simd_float8 v) { return (__builtin_convertvector(v, simd_int8)); }
+
+// Wide vectors. Comparisons give -1 / 0 lanes as on Apple, and a lane counts as set when its
+// high bit is.
+
+inline simd_float8 simd_min(simd_float8 a, simd_float8 b) { return (a < b ? a : b); }
+inline simd_float8 simd_max(simd_float8 a, simd_float8 b) { return (a > b ? a : b); }
+inline simd_float8 simd_abs(simd_float8 a) { return (a < 0.f ? -a : a); }
+inline simd_int8 simd_clamp(simd_int8 x, simd_int8 lo, simd_int8 hi) { return (x < lo ? lo : x > hi ? hi : x); }
+inline simd_long4 simd_clamp(simd_long4 x, simd_long4 lo, simd_long4 hi) { return (x < lo ? lo : x > hi ? hi : x); }
+inline simd_float8 simd_select(simd_float8 x, simd_float8 y, simd_int8 mask) { return (mask < 0 ? y : x); }
+inline simd_int8 simd_bitselect(simd_int8 x, simd_int8 y, simd_int8 mask) { return ((x & ~mask) | (y & mask)); }
+inline simd_long4 simd_bitselect(simd_long4 x, simd_long4 y, simd_long4 mask) { return ((x & ~mask) | (y & mask)); }
+inline simd_long8 simd_bitselect(simd_long8 x, simd_long8 y, simd_long8 mask) { return ((x & ~mask) | (y & mask)); }
+
+inline simd_float8 simd_precise_rsqrt(simd_float8 a)
+{
+    for (int i = 0; i < 8; ++i)
+        a[i] = 1.f / std::sqrt(a[i]);
+    return (a);
+}
+
+inline float simd_reduce_min(simd_float8 a)
+{
+    float m = a[0];
+    for (int i = 1; i < 8; ++i)
+        m = std::fmin(m, a[i]);
+    return (m);
+}
+
+inline float simd_reduce_max(simd_float8 a)
+{
+    float m = a[0];
+    for (int i = 1; i < 8; ++i)
+        m = std::fmax(m, a[i]);
+    return (m);
+}
+
+#  define RMDL_SIMD_MASK(type, lanes) \
+    inline bool simd_any(type mask) \
+    { \
+        for (int i = 0; i < lanes; ++i) \
+        { \
+            if (mask[i] < 0) \
+                return (true); \
+        } \
+        return (false); \
+    } \
+    inline bool simd_all(type mask) \
+    { \
+        for (int i = 0; i < lanes; ++i) \
+        { \
+            if (mask[i] >= 0) \
+                return (false); \
+        } \
+        return (true); \
+    }
+
+RMDL_SIMD_MASK(simd_int4, 4)
+RMDL_SIMD_MASK(simd_int8, 8)
+RMDL_SIMD_MASK(simd_long4, 4)
+RMDL_SIMD_MASK(simd_long8, 8)
+
+#  undef RMDL_SIMD_MASK
+
+// Matrices, column-major.
+
+constexpr simd_float3x3 simd_matrix(simd_float3 c0, simd_float3 c1, simd_float3 c2) { return (simd_float3x3{ { c0, c1, c2 } }); }
+constexpr simd_float4x3 simd_matrix(simd_float3 c0, simd_float3 c1, simd_float3 c2, simd_float3 c3) { return (simd_float4x3{ { c0, c1, c2, c3 } }); }
+constexpr simd_float4x4 simd_matrix(simd_float4 c0, simd_float4 c1, simd_float4 c2, simd_float4 c3) { return (simd_float4x4{ { c0, c1, c2, c3 } }); }
+
+inline simd_float3x3 simd_transpose(simd_float3x3 m)
+{
+    simd_float3x3 t;
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int r = 0; r < 3; ++r)
+            t.columns[c][r] = m.columns[r][c];
+    }
+    return (t);
+}
+
+inline simd_float4x4 simd_transpose(simd_float4x4 m)
+{
+    simd_float4x4 t;
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int r = 0; r < 4; ++r)
+            t.columns[c][r] = m.columns[r][c];
+    }
+    return (t);
+}
+
+inline simd_float4x4 simd_matrix_from_rows(simd_float4 r0, simd_float4 r1, simd_float4 r2, simd_float4 r3)
+{
+    return (simd_transpose(simd_matrix(r0, r1, r2, r3)));
+}
+
+inline simd_float3 simd_mul(simd_float3x3 m, simd_float3 v)
+{
+    return (m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z);
+}
+
+inline simd_float4 simd_mul(simd_float4x4 m, simd_float4 v)
+{
+    return (m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z + m.columns[3] * v.w);
+}
+
+inline simd_float3x3 simd_mul(simd_float3x3 a, simd_float3x3 b)
+{
+    return (simd_matrix(simd_mul(a, b.columns[0]), simd_mul(a, b.columns[1]), simd_mul(a, b.columns[2])));
+}
+
+inline simd_float4x4 simd_mul(simd_float4x4 a, simd_float4x4 b)
+{
+    return (simd_matrix(simd_mul(a, b.columns[0]), simd_mul(a, b.columns[1]),
+                        simd_mul(a, b.columns[2]), simd_mul(a, b.columns[3])));
+}
+
+inline simd_float3x3 simd_inverse(simd_float3x3 m)
+{
+    const simd_float3 c0 = m.columns[0];
+    const simd_float3 c1 = m.columns[1];
+    const simd_float3 c2 = m.columns[2];
+    const simd_float3 r0 = simd_cross(c1, c2);
+    const simd_float3 r1 = simd_cross(c2, c0);
+    const simd_float3 r2 = simd_cross(c0, c1);
+    const float invDet = 1.f / simd_dot(c0, r0);
+    return (simd_transpose(simd_matrix(r0 * invDet, r1 * invDet, r2 * invDet)));
+}
+
+/// Cofactor expansion, in float like the SDK's.
+inline simd_float4x4 simd_inverse(simd_float4x4 m)
+{
+    float a[16];
+    float inv[16];
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int r = 0; r < 4; ++r)
+            a[c * 4 + r] = m.columns[c][r];
+    }
+    inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+    const float invDet = 1.f / (a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12]);
+    simd_float4x4 r;
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int row = 0; row < 4; ++row)
+            r.columns[c][row] = inv[c * 4 + row] * invDet;
+    }
+    return (r);
+}
+
+inline simd_float4x4 operator*(simd_float4x4 a, simd_float4x4 b) { return (simd_mul(a, b)); }
+inline simd_float4 operator*(simd_float4x4 m, simd_float4 v) { return (simd_mul(m, v)); }
+inline simd_float3x3 operator*(simd_float3x3 a, simd_float3x3 b) { return (simd_mul(a, b)); }
+inline simd_float3 operator*(simd_float3x3 m, simd_float3 v) { return (simd_mul(m, v)); }
+
+// The older names the math utilities still use.
+
+inline float vector_dot(simd_float3 a, simd_float3 b) { return (simd_dot(a, b)); }
+inline float vector_dot(simd_float4 a, simd_float4 b) { return (simd_dot(a, b)); }
+inline simd_float3 vector_cross(simd_float3 a, simd_float3 b) { return (simd_cross(a, b)); }
+inline float vector_length(simd_float3 a) { return (simd_length(a)); }
+inline float vector_length(simd_float4 a) { return (simd_length(a)); }
+inline float vector_length_squared(simd_float3 a) { return (simd_length_squared(a)); }
+inline float vector_length_squared(simd_float4 a) { return (simd_length_squared(a)); }
+inline simd_float3 vector_normalize(simd_float3 a) { return (simd_normalize(a)); }
+inline simd_float4 vector_normalize(simd_float4 a) { return (simd_normalize(a)); }
+inline simd_float3x3 matrix_transpose(simd_float3x3 m) { return (simd_transpose(m)); }
+inline simd_float4x4 matrix_transpose(simd_float4x4 m) { return (simd_transpose(m)); }
+inline simd_float3x3 matrix_invert(simd_float3x3 m) { return (simd_inverse(m)); }
+inline simd_float4x4 matrix_invert(simd_float4x4 m) { return (simd_inverse(m)); }
+inline simd_float3 matrix_multiply(simd_float3x3 m, simd_float3 v) { return (simd_mul(m, v)); }
+inline simd_float4 matrix_multiply(simd_float4x4 m, simd_float4 v) { return (simd_mul(m, v)); }
+inline simd_float3x3 matrix_multiply(simd_float3x3 a, simd_float3x3 b) { return (simd_mul(a, b)); }
+inline simd_float4x4 matrix_multiply(simd_float4x4 a, simd_float4x4 b) { return (simd_mul(a, b)); }
+
+namespace simd
+{
+    using float2 = ::simd_float2;
+    using float3 = ::simd_float3;
+    using float4 = ::simd_float4;
+    using float8 = ::simd_float8;
+    using int4 = ::simd_int4;
+    using int8 = ::simd_int8;
+    using uint4 = ::simd_uint4;
+
+    struct float3x3 : ::simd_float3x3
+    {
+        constexpr float3x3() : ::simd_float3x3{} {}
+        constexpr float3x3(float3 c0, float3 c1, float3 c2) : ::simd_float3x3{ { c0, c1, c2 } } {}
+        constexpr float3x3(const ::simd_float3x3& m) : ::simd_float3x3(m) {}
+    };
+
+    struct float4x3 : ::simd_float4x3
+    {
+        constexpr float4x3() : ::simd_float4x3{} {}
+        constexpr float4x3(float3 c0, float3 c1, float3 c2, float3 c3) : ::simd_float4x3{ { c0, c1, c2, c3 } } {}
+        constexpr float4x3(const ::simd_float4x3& m) : ::simd_float4x3(m) {}
+    };
+
+    struct float4x4 : ::simd_float4x4
+    {
+        constexpr float4x4() : ::simd_float4x4{} {}
+        constexpr float4x4(float4 c0, float4 c1, float4 c2, float4 c3) : ::simd_float4x4{ { c0, c1, c2, c3 } } {}
+        constexpr float4x4(const ::simd_float4x4& m) : ::simd_float4x4(m) {}
+    };
+
+    template <typename T> auto dot(T a, T b) { return (::simd_dot(a, b)); }
+    template <typename T> T min(T a, T b) { return (::simd_min(a, b)); }
+    template <typename T> T max(T a, T b) { return (::simd_max(a, b)); }
+    template <typename T> T abs(T a) { return (::simd_abs(a)); }
+    template <typename T> float length(T a) { return (::simd_length(a)); }
+    template <typename T> float length_squared(T a) { return (::simd_length_squared(a)); }
+    template <typename T> T normalize(T a) { return (::simd_normalize(a)); }
+    inline float3 cross(float3 a, float3 b) { return (::simd_cross(a, b)); }
+    inline float3x3 transpose(const ::simd_float3x3& m) { return (::simd_transpose(m)); }
+    inline float4x4 transpose(const ::simd_float4x4& m) { return (::simd_transpose(m)); }
+    inline float3x3 inverse(const ::simd_float3x3& m) { return (::simd_inverse(m)); }
+    inline float4x4 inverse(const ::simd_float4x4& m) { return (::simd_inverse(m)); }
+}
+
+# endif
+
+/// Every lane set to value. Apple's vectors convert from a scalar implicitly, GCC's do not.
+template <typename V, typename T>
+constexpr V simdSplat(T value)
+{
+    using Lane = decltype(+V{}[0]);
+    return (V{} + (Lane)value);
+}
+
+#endif /* RMDLSIMD_HPP */
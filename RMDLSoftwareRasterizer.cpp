@@ -0,0 +1,494 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSoftwareRasterizer.cpp   +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 15:22:44      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLSoftwareRasterizer.hpp"
+
+#include "RMDLMathUtils.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace
+{
+    struct ClipVertex
+    {
+        simd_float4 position;
+        simd_float2 uv;
+    };
+
+    double sMillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    uint32_t sIndex(const raster::Mesh& mesh, uint32_t i)
+    {
+        if (mesh.indexType == raster::IndexType::UInt16)
+            return (((const uint16_t *)mesh.pIndices)[i]);
+        return (((const uint32_t *)mesh.pIndices)[i]);
+    }
+
+    ClipVertex sFetch(const raster::Mesh& mesh, uint32_t index, const simd_float4x4& transform)
+    {
+        const uint8_t* pVertex = (const uint8_t *)mesh.pVertices + (size_t)index * mesh.vertexStride;
+        float position[3];
+        float uv[2];
+        memcpy(position, pVertex + mesh.positionOffset, sizeof(position));
+        memcpy(uv, pVertex + mesh.texcoordOffset, sizeof(uv));
+
+        ClipVertex v;
+        v.position = simd_mul(transform, simd_make_float4(position[0], position[1], position[2], 1.f));
+        v.uv = simd_make_float2(uv[0], uv[1]);
+        return (v);
+    }
+
+    // Sutherland-Hodgman against Metal's near plane, z >= 0 in clip space. A triangle becomes at
+    // most a quad.
+    int sClipNear(const ClipVertex (&in)[3], ClipVertex (&out)[4])
+    {
+        int count = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            const ClipVertex& a = in[i];
+            const ClipVertex& b = in[(i + 1) % 3];
+            const float da = a.position.z;
+            const float db = b.position.z;
+            if (da >= 0.f)
+                out[count++] = a;
+            if ((da >= 0.f) != (db >= 0.f))
+            {
+                const float t = da / (da - db);
+                out[count].position = a.position + (b.position - a.position) * t;
+                out[count].uv = a.uv + (b.uv - a.uv) * t;
+                ++count;
+            }
+        }
+        return (count);
+    }
+
+    // Channel c of eight RGBA8 texels, in [0, 1].
+    simd_float8 sChannel(simd_uint8 texels, int c)
+    {
+        return (simd_float(simd_int8((texels >> (8 * c)) & 0xFF)) * (1.f / 255.f));
+    }
+
+    // Bilinear, clamp to edge, for eight pixels at once; rgba receives one channel per vector.
+    // Only the lanes in mask fetch their four texels, the filter runs on all eight.
+    void sSample8(const raster::Texture& texture, uint32_t layer, simd_float8 u, simd_float8 v, simd_int8 mask, simd_float8 (&rgba)[4])
+    {
+        // Far outside the texture every tap is an edge texel anyway; the clamp keeps the float to
+        // int conversion in range and turns the NaN of an uncovered lane into a number.
+        constexpr float kLimit = 16777216.f;
+        const uint8_t* pLayer = texture.pTexels + (size_t)std::min(layer, texture.layerCount - 1) * texture.layerBytes;
+        const simd_float8 low = simdSplat<simd_float8>(-kLimit);
+        const simd_float8 high = simdSplat<simd_float8>(kLimit);
+        const simd_float8 x = simd_min(simd_max(u * (float)texture.width - 0.5f, low), high);
+        const simd_float8 y = simd_min(simd_max(v * (float)texture.height - 0.5f, low), high);
+        simd_int8 ix = simd_int(x);
+        simd_int8 iy = simd_int(y);
+        ix += simd_float(ix) > x;   // truncation to floor: -1 where it rounded up
+        iy += simd_float(iy) > y;
+        const simd_float8 fx = x - simd_float(ix);
+        const simd_float8 fy = y - simd_float(iy);
+
+        const simd_int8 zero = {};
+        const simd_int8 lastX = simdSplat<simd_int8>((int)texture.width - 1);
+        const simd_int8 lastY = simdSplat<simd_int8>((int)texture.height - 1);
+        const simd_int8 x0 = simd_clamp(ix, zero, lastX);
+        const simd_int8 x1 = simd_clamp(ix + 1, zero, lastX);
+        const simd_int8 y0 = simd_clamp(iy, zero, lastY);
+        const simd_int8 y1 = simd_clamp(iy + 1, zero, lastY);
+        simd_uint8 t00 = {};
+        simd_uint8 t10 = {};
+        simd_uint8 t01 = {};
+        simd_uint8 t11 = {};
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            if (!mask[lane])
+                continue;
+            const uint8_t* pRow0 = pLayer + (size_t)y0[lane] * texture.rowBytes;
+            const uint8_t* pRow1 = pLayer + (size_t)y1[lane] * texture.rowBytes;
+            uint32_t texel;
+            memcpy(&texel, pRow0 + (size_t)x0[lane] * 4, 4);
+            t00[lane] = texel;
+            memcpy(&texel, pRow0 + (size_t)x1[lane] * 4, 4);
+            t10[lane] = texel;
+            memcpy(&texel, pRow1 + (size_t)x0[lane] * 4, 4);
+            t01[lane] = texel;
+            memcpy(&texel, pRow1 + (size_t)x1[lane] * 4, 4);
+            t11[lane] = texel;
+        }
+
+        for (int c = 0; c < 4; ++c)
+        {
+            const simd_float8 top = sChannel(t00, c) * (1.f - fx) + sChannel(t10, c) * fx;
+            const simd_float8 bottom = sChannel(t01, c) * (1.f - fx) + sChannel(t11, c) * fx;
+            rgba[c] = top * (1.f - fy) + bottom * fy;
+        }
+    }
+}
+
+namespace raster
+{
+    SoftwareRasterizer::SoftwareRasterizer(uint32_t width, uint32_t height)
+    : _width(width)
+    , _height(height)
+    , _tilesX((width + kTileSize - 1) / kTileSize)
+    , _tilesY((height + kTileSize - 1) / kTileSize)
+    , _viewProjection(matrix_identity_float4x4)
+    , _clearColor(simd_make_float4(0.f, 0.f, 0.f, 0.f))
+    , _stats()
+    {
+        _bins.resize((size_t)_tilesX * _tilesY);
+        _pixels.resize((size_t)width * height * 4);
+    }
+
+    void SoftwareRasterizer::submit(const DrawCall& draw)
+    {
+        _draws.push_back(draw);
+    }
+
+    void SoftwareRasterizer::setupBatch(const DrawCall& draw, const Instance& instance, std::vector<Triangle>& triangles) const
+    {
+        const simd_float4x4 transform = simd_mul(_viewProjection, instance.transform);
+        const float width = (float)_width;
+        const float height = (float)_height;
+
+        for (uint32_t i = 0; i + 2 < draw.mesh.indexCount; i += 3)
+        {
+            const ClipVertex in[3] =
+            {
+                sFetch(draw.mesh, sIndex(draw.mesh, i), transform),
+                sFetch(draw.mesh, sIndex(draw.mesh, i + 1), transform),
+                sFetch(draw.mesh, sIndex(draw.mesh, i + 2), transform)
+            };
+            ClipVertex clipped[4];
+            const int clippedCount = sClipNear(in, clipped);
+
+            for (int k = 1; k + 1 < clippedCount; ++k)
+            {
+                const ClipVertex* v[3] = { &clipped[0], &clipped[k], &clipped[k + 1] };
+                if (v[0]->position.w <= 1e-7f || v[1]->position.w <= 1e-7f || v[2]->position.w <= 1e-7f)
+                    continue;
+
+                Triangle t;
+                hit_test::Triangle screen;
+                simd_float2* corners[3] = { &screen.a, &screen.b, &screen.c };
+                for (int j = 0; j < 3; ++j)
+                {
+                    const float invW = 1.f / v[j]->position.w;
+                    const simd_float3 ndc = v[j]->position.xyz * invW;
+                    // y stays up in screen space, so the top-left rule matches hit_test.
+                    *corners[j] = simd_make_float2((ndc.x * 0.5f + 0.5f) * width, (ndc.y * 0.5f + 0.5f) * height);
+                    t.z[j] = ndc.z;
+                    t.invW[j] = invW;
+                    t.uvOverW[j] = v[j]->uv * invW;
+                }
+                t.edges = hit_test::edgeFunctions(screen);
+                if (t.edges.area == 0.f
+                    || (draw.cull == CullMode::Clockwise && t.edges.clockwise)
+                    || (draw.cull == CullMode::CounterClockwise && !t.edges.clockwise))
+                    continue;
+
+                const float minX = std::min({ screen.a.x, screen.b.x, screen.c.x });
+                const float maxX = std::max({ screen.a.x, screen.b.x, screen.c.x });
+                const float minY = std::min({ screen.a.y, screen.b.y, screen.c.y });
+                const float maxY = std::max({ screen.a.y, screen.b.y, screen.c.y });
+                t.minX = (int32_t)std::max(floorf(minX), 0.f);
+                t.maxX = (int32_t)std::min(ceilf(maxX), width - 1.f);
+                t.minY = (int32_t)std::max(floorf(height - maxY), 0.f);
+                t.maxY = (int32_t)std::min(ceilf(height - minY), height - 1.f);
+                if (t.minX > t.maxX || t.minY > t.maxY)
+                    continue;
+
+                t.invArea = 1.f / t.edges.area;
+                t.color = instance.color;
+                t.pTexture = draw.pTexture;
+                t.textureLayer = draw.textureLayer;
+                t.blend = draw.blend;
+                t.depthTest = draw.depthTest;
+                t.depthWrite = draw.depthWrite;
+                triangles.push_back(t);
+            }
+        }
+    }
+
+    uint64_t SoftwareRasterizer::rasterTile(uint32_t tileX, uint32_t tileY, float* pColor, float* pDepth)
+    {
+        const int32_t x0 = (int32_t)(tileX * kTileSize);
+        const int32_t y0 = (int32_t)(tileY * kTileSize);
+        const int32_t x1 = std::min(x0 + (int32_t)kTileSize, (int32_t)_width) - 1;
+        const int32_t y1 = std::min(y0 + (int32_t)kTileSize, (int32_t)_height) - 1;
+        const simd_float8 laneOffset = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+        const simd_int8 laneIndex = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        uint64_t shaded = 0;
+
+        for (uint32_t i = 0; i < kTileSize * kTileSize; ++i)
+        {
+            memcpy(pColor + i * 4, &_clearColor, sizeof(float) * 4);
+            pDepth[i] = 1.f;
+        }
+
+        for (uint32_t index : _bins[(size_t)tileY * _tilesX + tileX])
+        {
+            const Triangle& t = _triangles[index];
+            const int32_t rowBegin = std::max(t.minY, y0);
+            const int32_t rowEnd = std::min(t.maxY, y1);
+            const int32_t columnBegin = x0 + (std::max(t.minX, x0) - x0) / 8 * 8;
+            const int32_t columnEnd = std::min(t.maxX, x1);
+
+            for (int32_t row = rowBegin; row <= rowEnd; ++row)
+            {
+                const simd_float8 y = simdSplat<simd_float8>((float)_height - (float)row - 0.5f);
+                for (int32_t column = columnBegin; column <= columnEnd; column += 8)
+                {
+                    const simd_float8 x = (float)column + laneOffset;
+                    simd_float8 e[3];
+                    simd_int8 mask = hit_test::coverage8(t.edges, x, y, e);
+                    mask &= (column + laneIndex) <= columnEnd;
+                    if (!simd_any(mask))
+                        continue;
+
+                    const simd_float8 l0 = e[0] * t.invArea;
+                    const simd_float8 l1 = e[1] * t.invArea;
+                    const simd_float8 l2 = e[2] * t.invArea;
+                    const simd_float8 z = l0 * t.z[0] + l1 * t.z[1] + l2 * t.z[2];
+                    float* pDepthRow = pDepth + (row - y0) * kTileSize + (column - x0);
+                    simd_float8 depth;
+                    memcpy(&depth, pDepthRow, sizeof(depth));
+                    mask &= (z >= 0.f) & (z <= 1.f);
+                    if (t.depthTest)
+                        mask &= z <= depth;
+                    if (!simd_any(mask))
+                        continue;
+
+                    const simd_float8 w = 1.f / (l0 * t.invW[0] + l1 * t.invW[1] + l2 * t.invW[2]);
+                    const simd_float8 u = (l0 * t.uvOverW[0].x + l1 * t.uvOverW[1].x + l2 * t.uvOverW[2].x) * w;
+                    const simd_float8 v = (l0 * t.uvOverW[0].y + l1 * t.uvOverW[1].y + l2 * t.uvOverW[2].y) * w;
+
+                    simd_float8 rgba[4];
+                    for (int c = 0; c < 4; ++c)
+                        rgba[c] = simdSplat<simd_float8>(t.color[c]);
+                    if (t.pTexture)
+                    {
+                        simd_float8 texel[4];
+                        sSample8(*t.pTexture, t.textureLayer, u, v, mask, texel);
+                        for (int c = 0; c < 4; ++c)
+                            rgba[c] *= texel[c];
+                    }
+
+                    float* pDst = pColor + ((row - y0) * kTileSize + (column - x0)) * 4;
+                    if (t.blend == BlendMode::PremultipliedAlpha)
+                    {
+                        // The row is a multiple of eight pixels long, so all eight can be read.
+                        float dst[32];
+                        memcpy(dst, pDst, sizeof(dst));
+                        const simd_float8 inverseAlpha = 1.f - rgba[3];
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            const simd_float8 d = { dst[c], dst[4 + c], dst[8 + c], dst[12 + c],
+                                                    dst[16 + c], dst[20 + c], dst[24 + c], dst[28 + c] };
+                            if (c < 3)
+                                rgba[c] *= rgba[3];
+                            rgba[c] += d * inverseAlpha;
+                        }
+                    }
+
+                    for (int lane = 0; lane < 8; ++lane)
+                    {
+                        if (!mask[lane])
+                            continue;
+                        const float color[4] = { rgba[0][lane], rgba[1][lane], rgba[2][lane], rgba[3][lane] };
+                        memcpy(pDst + lane * 4, color, sizeof(color));
+                        if (t.depthWrite)
+                            pDepthRow[lane] = z[lane];
+                        ++shaded;
+                    }
+                }
+            }
+        }
+
+        for (int32_t row = y0; row <= y1; ++row)
+        {
+            uint16_t* pOut = _pixels.data() + ((size_t)row * _width + x0) * 4;
+            const float* pIn = pColor + (row - y0) * kTileSize * 4;
+            float16_from_float32(pOut, pIn, (size_t)(x1 - x0 + 1) * 4);
+        }
+        return (shaded);
+    }
+
+    void SoftwareRasterizer::render(unsigned threadCount)
+    {
+        _stats = Stats();
+
+        // Vertex stage, one task per (draw, instance); results are concatenated in submission order.
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::pair<uint32_t, uint32_t>> batches;
+        for (uint32_t d = 0; d < _draws.size(); ++d)
+        {
+            for (uint32_t i = 0; i < _draws[d].instanceCount; ++i)
+                batches.emplace_back(d, i);
+            _stats.inputTriangles += (uint64_t)(_draws[d].mesh.indexCount / 3) * _draws[d].instanceCount;
+        }
+        std::vector<std::vector<Triangle>> batchTriangles(batches.size());
+        parallel::parallelFor(batches.size(), [&](size_t b)
+        {
+            const DrawCall& draw = _draws[batches[b].first];
+            setupBatch(draw, draw.pInstances[batches[b].second], batchTriangles[b]);
+        }, threadCount);
+        _triangles.clear();
+        for (const std::vector<Triangle>& triangles : batchTriangles)
+            _triangles.insert(_triangles.end(), triangles.begin(), triangles.end());
+        _stats.rasterTriangles = _triangles.size();
+        _stats.vertexMs = sMillisecondsSince(start);
+
+        // Binning, one task per row of tiles so each bin is filled by one thread, in order.
+        start = std::chrono::steady_clock::now();
+        parallel::parallelFor(_tilesY, [&](size_t tileY)
+        {
+            const int32_t rowBegin = (int32_t)(tileY * kTileSize);
+            const int32_t rowEnd = rowBegin + (int32_t)kTileSize - 1;
+            std::vector<uint32_t>* pBins = _bins.data() + tileY * _tilesX;
+            for (uint32_t tileX = 0; tileX < _tilesX; ++tileX)
+                pBins[tileX].clear();
+            for (uint32_t index = 0; index < _triangles.size(); ++index)
+            {
+                const Triangle& t = _triangles[index];
+                if (t.maxY < rowBegin || t.minY > rowEnd)
+                    continue;
+                for (int32_t tileX = t.minX / (int32_t)kTileSize; tileX <= t.maxX / (int32_t)kTileSize; ++tileX)
+                    pBins[tileX].push_back(index);
+            }
+        }, threadCount);
+        for (const std::vector<uint32_t>& bin : _bins)
+            _stats.binEntries += bin.size();
+        _stats.binMs = sMillisecondsSince(start);
+
+        // Raster, one task per tile.
+        start = std::chrono::steady_clock::now();
+        std::atomic<uint64_t> shaded(0);
+        parallel::parallelFor(_bins.size(), [&](size_t tile)
+        {
+            float color[kTileSize * kTileSize * 4];
+            float depth[kTileSize * kTileSize];
+            shaded.fetch_add(rasterTile((uint32_t)(tile % _tilesX), (uint32_t)(tile / _tilesX), color, depth), std::memory_order_relaxed);
+        }, threadCount);
+        _stats.shadedPixels = shaded.load();
+        _stats.rasterMs = sMillisecondsSince(start);
+
+        _draws.clear();
+    }
+
+    void benchmarkRasterizer(FILE* out)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr uint32_t kWidth = 1920;
+        constexpr uint32_t kHeight = 1080;
+        constexpr uint32_t kTexels = 64;
+        constexpr int kRuns = 3;
+        const uint32_t counts[] = { 100, 1000, 10000 };
+
+        // The sprite quad: float3 position, float2 texcoord, 32-byte vertices like the game's.
+        struct Vertex
+        {
+            float   position[4];
+            float   texcoord[4];
+        };
+        const Vertex vertices[4] =
+        {
+            { { -0.5f, -0.5f, 0.f }, { 0.f, 1.f } },
+            { {  0.5f, -0.5f, 0.f }, { 1.f, 1.f } },
+            { {  0.5f,  0.5f, 0.f }, { 1.f, 0.f } },
+            { { -0.5f,  0.5f, 0.f }, { 0.f, 0.f } }
+        };
+        const uint16_t indices[6] = { 0, 1, 2, 2, 3, 0 };
+        const Mesh quad = { vertices, sizeof(Vertex), offsetof(Vertex, position), offsetof(Vertex, texcoord),
+                            indices, 6, IndexType::UInt16 };
+
+        std::vector<uint8_t> texels((size_t)kTexels * kTexels * 4);
+        for (uint32_t y = 0; y < kTexels; ++y)
+        {
+            for (uint32_t x = 0; x < kTexels; ++x)
+            {
+                const uint8_t value = ((x / 8 + y / 8) & 1) ? 255 : 64;
+                uint8_t* pTexel = texels.data() + ((size_t)y * kTexels + x) * 4;
+                pTexel[0] = value;
+                pTexel[1] = value;
+                pTexel[2] = value;
+                pTexel[3] = (x + y) & 1 ? 255 : 192;
+            }
+        }
+        const Texture texture = { texels.data(), kTexels, kTexels, 1, kTexels * 4, (size_t)kTexels * kTexels * 4 };
+
+        // The game canvas: 10 x 6 units, sprites 0.5 units wide.
+        const simd_float4x4 viewProjection = math::cx::makeOrtho(-5.f, 5.f, 3.f, -3.f, -1.f, 1.f);
+
+        SoftwareRasterizer serial(kWidth, kHeight);
+        SoftwareRasterizer threaded(kWidth, kHeight);
+        serial.setViewProjection(viewProjection);
+        threaded.setViewProjection(viewProjection);
+
+        fprintf(out, "%10s %10s %12s %10s %10s %10s %10s %10s %10s\n",
+                "sprites", "triangles", "pixels", "vertex ms", "bin ms", "raster ms", "1 thread", "all", "Mpix/s");
+        for (uint32_t count : counts)
+        {
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> x(-5.f, 5.f);
+            std::uniform_real_distribution<float> y(-3.f, 3.f);
+            std::uniform_real_distribution<float> tint(0.5f, 1.f);
+            std::vector<Instance> instances(count);
+            for (Instance& instance : instances)
+            {
+                const math::cx::Matrix4 transform = { {
+                    { 0.5f, 0.f, 0.f, 0.f },
+                    { 0.f, 0.5f, 0.f, 0.f },
+                    { 0.f, 0.f, 1.f, 0.f },
+                    { x(rng), y(rng), 0.f, 1.f } } };
+                instance.transform = transform;
+                instance.color = simd_make_float4(tint(rng), tint(rng), tint(rng), 1.f);
+            }
+            const DrawCall draw = { quad, instances.data(), count, &texture, 0,
+                                    BlendMode::PremultipliedAlpha, CullMode::None, false, false };
+
+            double serialMs = 1e30;
+            double threadedMs = 1e30;
+            Stats best = {};
+            for (int run = 0; run < kRuns; ++run)
+            {
+                serial.submit(draw);
+                auto start = Clock::now();
+                serial.render(1);
+                serialMs = std::min(serialMs, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+                threaded.submit(draw);
+                start = Clock::now();
+                threaded.render();
+                const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                if (ms < threadedMs)
+                {
+                    threadedMs = ms;
+                    best = threaded.stats();
+                }
+            }
+
+            // Tiles are independent, so the thread count must not change a single half.
+            const bool same = memcmp(serial.pixels(), threaded.pixels(), serial.rowBytes() * kHeight) == 0;
+            fprintf(out, "%10u %10llu %12llu %10.3f %10.3f %10.3f %10.3f %10.3f %10.1f%s\n",
+                    count, (unsigned long long)best.rasterTriangles, (unsigned long long)best.shadedPixels,
+                    best.vertexMs, best.binMs, best.rasterMs, serialMs, threadedMs,
+                    (double)best.shadedPixels / (threadedMs * 1000.0), same ? "" : "  MISMATCH");
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSoftwareRasterizer.hpp   +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 15:22:37      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSOFTWARERASTERIZER_HPP
+# define RMDLSOFTWARERASTERIZER_HPP
+
+# include "RMDLSimd.hpp"
+# include <cstddef>
+# include <cstdint>
+# include <cstdio>
+# include <vector>
+
+# include "RMDLPointInTriangle.hpp"
+
+/// Headless CPU reference renderer for the sprite and map pipelines.
+///
+/// Draws are recorded with submit() and executed by render() in three stages:
+///   1. vertex: every (draw, instance) batch is transformed, clipped against the near plane and
+///      set up with hit_test::edgeFunctions, one batch per task;
+///   2. binning: triangles are appended, in submission order, to every 32x32 tile their bounds
+///      touch, one row of tiles per task;
+///   3. raster: each tile is shaded eight pixels at a time with hit_test::coverage8 into a
+///      tile-local float colour and depth buffer, one tile per task, then stored as RGBA16F.
+/// Coverage follows the same top-left rule as hit-testing, so shared edges are drawn once.
+///
+/// Shading is unlit: the bilinearly sampled texel (clamp to edge, like the game's sampler) times
+/// the instance colour. Depth is Metal's [0, 1] with a less-equal test.
+namespace raster
+{
+    constexpr uint32_t kTileSize = 32;
+
+    enum class IndexType : uint8_t
+    {
+        UInt16,
+        UInt32
+    };
+
+    enum class BlendMode : uint8_t
+    {
+        Opaque,
+        PremultipliedAlpha  // the sprite pass: rgb *= a, then src + dst * (1 - a)
+    };
+
+    enum class CullMode : uint8_t
+    {
+        None,
+        Clockwise,          // in screen space, y up
+        CounterClockwise
+    };
+
+    /// CPU view of an IndexedMesh: pass pVertices->contents() and pIndices->contents(). The
+    /// position is read as float3 (xyz) and the texcoord as float2 at the given byte offsets.
+    struct Mesh
+    {
+        const void* pVertices;
+        size_t      vertexStride;
+        size_t      positionOffset;
+        size_t      texcoordOffset;
+        const void* pIndices;
+        uint32_t    indexCount;
+        IndexType   indexType;
+    };
+
+    /// Same layout as shader_types::InstanceData.
+    struct Instance
+    {
+        simd_float4x4   transform;
+        simd_float4     color;
+    };
+
+    /// RGBA8 unorm texels, optionally an array of layers.
+    struct Texture
+    {
+        const uint8_t*  pTexels;
+        uint32_t        width;
+        uint32_t        height;
+        uint32_t        layerCount;
+        size_t          rowBytes;
+        size_t          layerBytes;
+    };
+
+    struct DrawCall
+    {
+        Mesh            mesh;
+        const Instance* pInstances;
+        uint32_t        instanceCount;
+        const Texture*  pTexture;           // nullptr: instance colour only
+        uint32_t        textureLayer;
+        BlendMode       blend;
+        CullMode        cull;
+        bool            depthTest;
+        bool            depthWrite;
+    };
+
+    struct Stats
+    {
+        uint64_t    inputTriangles;
+        uint64_t    rasterTriangles;    // after clipping and culling
+        uint64_t    binEntries;         // (tile, triangle) pairs
+        uint64_t    shadedPixels;
+        double      vertexMs;
+        double      binMs;
+        double      rasterMs;
+    };
+
+    class SoftwareRasterizer
+    {
+    public:
+        SoftwareRasterizer(uint32_t width, uint32_t height);
+
+        uint32_t    width() const { return (_width); }
+        uint32_t    height() const { return (_height); }
+
+        void        setViewProjection(const simd_float4x4& viewProjection) { _viewProjection = viewProjection; }
+        void        setClearColor(simd_float4 color) { _clearColor = color; }
+
+        /// Records a draw. Mesh, instance and texture memory must stay valid until render().
+        void        submit(const DrawCall& draw);
+
+        /// Runs every submitted draw and clears the list. threadCount 0: one per hardware thread.
+        void        render(unsigned threadCount = 0);
+
+        /// RGBA16F, four halves per pixel, rows top to bottom.
+        const uint16_t*     pixels() const { return (_pixels.data()); }
+        size_t              rowBytes() const { return (_width * 4 * sizeof(uint16_t)); }
+        const Stats&        stats() const { return (_stats); }
+
+    private:
+        struct Triangle
+        {
+            hit_test::EdgeFunctions edges;
+            float           invArea;
+            float           z[3];
+            float           invW[3];
+            simd_float2     uvOverW[3];
+            simd_float4     color;
+            const Texture*  pTexture;
+            uint32_t        textureLayer;
+            int32_t         minX, minY, maxX, maxY;     // pixels, rows top to bottom, inclusive
+            BlendMode       blend;
+            bool            depthTest;
+            bool            depthWrite;
+        };
+
+        void        setupBatch(const DrawCall& draw, const Instance& instance, std::vector<Triangle>& triangles) const;
+        uint64_t    rasterTile(uint32_t tileX, uint32_t tileY, float* pColor, float* pDepth);
+
+        uint32_t                            _width;
+        uint32_t                            _height;
+        uint32_t                            _tilesX;
+        uint32_t                            _tilesY;
+        simd_float4x4                       _viewProjection;
+        simd_float4                         _clearColor;
+        std::vector<DrawCall>               _draws;
+        std::vector<Triangle>               _triangles;
+        std::vector<std::vector<uint32_t>>  _bins;
+        std::vector<uint16_t>               _pixels;
+        Stats                               _stats;
+    };
+
+    /// Renders 100 to 10k textured, premultiplied-alpha sprites at 1920x1080 on one thread and
+    /// on every worker, and prints the per-stage times and shaded pixels per second to out.
+    void    benchmarkRasterizer(FILE* out);
+}
+
+#endif /* RMDLSOFTWARERASTERIZER_HPP */
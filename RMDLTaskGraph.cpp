@@ -0,0 +1,307 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTaskGraph.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:52:14      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLTaskGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    constexpr uint32_t kSpinRounds = 64;
+
+    uint64_t sNowNs()
+    {
+        return ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    double sMs(uint64_t ns)
+    {
+        return ((double)ns * 1e-6);
+    }
+}
+
+namespace jobs
+{
+    TaskGraph::TaskGraph(uint32_t maxFramesInFlight, JobSystem& system)
+        : _system(system)
+        , _maxFramesInFlight(std::max(maxFramesInFlight, 1u))
+    {
+    }
+
+    TaskGraph::~TaskGraph()
+    {
+        waitIdle();
+    }
+
+    void TaskGraph::addDependency(TaskId before, TaskId after)
+    {
+        assert(!_instances && before < _tasks.size() && after < _tasks.size() && before != after);
+        _tasks[before].successors.push_back(after);
+        ++_tasks[after].dependencyCount;
+    }
+
+    void TaskGraph::addFrameDependency(TaskId before, TaskId after)
+    {
+        assert(!_instances && before < _tasks.size() && after < _tasks.size());
+        _tasks[before].frameSuccessors.push_back(after);
+        _tasks[after].frameDependencies.push_back(before);
+    }
+
+    void TaskGraph::build()
+    {
+        // Dependencies within a frame must not loop, or the frame never finishes; frame
+        // dependencies point one frame back and cannot.
+        std::vector<uint32_t> inputs(_tasks.size());
+        std::vector<TaskId> ready;
+        for (TaskId t = 0; t < _tasks.size(); ++t)
+        {
+            inputs[t] = _tasks[t].dependencyCount;
+            if (inputs[t] == 0)
+                ready.push_back(t);
+        }
+        size_t ordered = 0;
+        while (!ready.empty())
+        {
+            const TaskId t = ready.back();
+            ready.pop_back();
+            ++ordered;
+            for (TaskId s : _tasks[t].successors)
+            {
+                if (--inputs[s] == 0)
+                    ready.push_back(s);
+            }
+        }
+        assert(ordered == _tasks.size() && "task dependencies form a cycle");
+        (void)ordered;
+
+        const size_t taskCount = _tasks.size();
+        _instances = std::make_unique<Instance[]>(taskCount * _maxFramesInFlight);
+        _frames = std::make_unique<Frame[]>(_maxFramesInFlight);
+        for (uint32_t slot = 0; slot < _maxFramesInFlight; ++slot)
+        {
+            for (TaskId t = 0; t < taskCount; ++t)
+            {
+                Instance& task = instance(t, slot);
+                task.pGraph = this;
+                task.task = t;
+                task.slot = slot;
+                task.job.pFunction = [](const Job& job)
+                {
+                    Instance& self = *(Instance*)job.pContext;
+                    self.pGraph->runTask(self);
+                };
+                task.job.pContext = &task;
+            }
+        }
+
+        _taskTimings.resize(taskCount);
+        for (TaskId t = 0; t < taskCount; ++t)
+            _taskTimings[t].pName = _tasks[t].pName;
+        _taskTotalMs.assign(taskCount, 0.0);
+        _taskCriticalFrames.assign(taskCount, 0);
+    }
+
+    uint64_t TaskGraph::runFrame()
+    {
+        if (!_instances)
+            build();
+        const uint64_t frame = _nextFrame;
+        if (frame >= _maxFramesInFlight)
+            waitFrame(frame - _maxFramesInFlight);
+        ++_nextFrame;
+
+        const uint32_t slot = (uint32_t)(frame % _maxFramesInFlight);
+        const uint32_t previousSlot = (slot + _maxFramesInFlight - 1) % _maxFramesInFlight;
+        Frame& current = _frames[slot];
+        current.frame = frame;
+        current.launchNs = sNowNs();
+        current.tasksLeft.store((uint32_t)_tasks.size(), std::memory_order_relaxed);
+
+        // Every task holds one extra input until the whole frame is set up.
+        for (TaskId t = 0; t < _tasks.size(); ++t)
+        {
+            Instance& task = instance(t, slot);
+            task.remaining.store(_tasks[t].dependencyCount + 1 + (frame > 0 ? (uint32_t)_tasks[t].frameDependencies.size() : 0u),
+                                 std::memory_order_relaxed);
+            task.gate = kNoTask;
+            task.gateCrossFrame = false;
+        }
+        {
+            // A task of the previous frame either is done now, and is not waited for, or will
+            // release this frame's successors when it is. This reads the previous slot before
+            // this slot is reset: with one frame in flight they are the same slot, and the
+            // frame before has just been waited for.
+            std::lock_guard<std::mutex> lock(_frameMutex);
+            if (frame > 0)
+            {
+                for (TaskId t = 0; t < _tasks.size(); ++t)
+                {
+                    for (TaskId before : _tasks[t].frameDependencies)
+                    {
+                        Instance& previous = instance(before, previousSlot);
+                        if (previous.done)
+                            instance(t, slot).remaining.fetch_sub(1, std::memory_order_relaxed);
+                        else
+                            previous.successorsWaiting = true;
+                    }
+                }
+            }
+            for (TaskId t = 0; t < _tasks.size(); ++t)
+            {
+                instance(t, slot).done = false;
+                instance(t, slot).successorsWaiting = false;
+            }
+        }
+        for (TaskId t = 0; t < _tasks.size(); ++t)
+            release(t, slot, kNoTask, false);
+        return (frame);
+    }
+
+    void TaskGraph::release(TaskId task, uint32_t slot, TaskId releaser, bool crossFrame)
+    {
+        Instance& target = instance(task, slot);
+        if (target.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        // The last input to finish gated this task.
+        target.gate = releaser;
+        target.gateCrossFrame = crossFrame;
+        target.readyNs = sNowNs();
+        _system.submit(&target.job, 1, _frames[slot].counter);
+    }
+
+    void TaskGraph::runTask(Instance& task)
+    {
+        const Task& desc = _tasks[task.task];
+        Frame& frame = _frames[task.slot];
+        task.startNs = sNowNs();
+        desc.pFunction(desc.pContext, FrameInfo{ frame.frame, task.slot });
+        task.endNs = sNowNs();
+
+        for (TaskId successor : desc.successors)
+            release(successor, task.slot, task.task, false);
+        if (!desc.frameSuccessors.empty())
+        {
+            bool waiting;
+            {
+                std::lock_guard<std::mutex> lock(_frameMutex);
+                task.done = true;
+                waiting = task.successorsWaiting;
+            }
+            if (waiting)
+            {
+                const uint32_t nextSlot = (task.slot + 1) % _maxFramesInFlight;
+                for (TaskId successor : desc.frameSuccessors)
+                    release(successor, nextSlot, task.task, true);
+            }
+        }
+
+        if (frame.tasksLeft.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            finishFrame(frame, task.slot);
+    }
+
+    void TaskGraph::finishFrame(Frame& frame, uint32_t slot)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_timingMutex);
+            TaskId last = 0;
+            for (TaskId t = 0; t < _tasks.size(); ++t)
+            {
+                if (instance(t, slot).endNs > instance(last, slot).endNs)
+                    last = t;
+            }
+
+            const uint64_t frames = ++_frameTiming.frames;
+            for (TaskId t = 0; t < _tasks.size(); ++t)
+            {
+                const Instance& task = instance(t, slot);
+                TaskTiming& timing = _taskTimings[t];
+                timing.lastMs = sMs(task.endNs - task.startNs);
+                timing.lastWaitMs = sMs(task.startNs - task.readyNs);
+                timing.lastCritical = false;
+                timing.lastGatedByPreviousFrame = task.gateCrossFrame;
+                _taskTotalMs[t] += timing.lastMs;
+                timing.averageMs = _taskTotalMs[t] / (double)frames;
+            }
+
+            // Walk back from the last task through the input that finished last each time.
+            double criticalMs = 0.0;
+            for (TaskId t = last; t != kNoTask; )
+            {
+                const Instance& task = instance(t, slot);
+                _taskTimings[t].lastCritical = true;
+                ++_taskCriticalFrames[t];
+                criticalMs += _taskTimings[t].lastMs;
+                t = task.gateCrossFrame ? kNoTask : task.gate;
+            }
+            for (TaskId t = 0; t < _tasks.size(); ++t)
+                _taskTimings[t].criticalShare = (double)_taskCriticalFrames[t] / (double)frames;
+
+            _frameTiming.lastMs = sMs(instance(last, slot).endNs - frame.launchNs);
+            _frameTotalMs += _frameTiming.lastMs;
+            _frameTiming.averageMs = _frameTotalMs / (double)frames;
+            _frameTiming.lastCriticalPathMs = criticalMs;
+        }
+        frame.completed.store(frame.frame + 1, std::memory_order_release);
+    }
+
+    void TaskGraph::waitFrame(uint64_t frame)
+    {
+        if (frame >= _nextFrame)
+            return;
+        Frame& slot = _frames[frame % _maxFramesInFlight];
+        uint32_t idle = 0;
+        while (slot.completed.load(std::memory_order_acquire) < frame + 1)
+        {
+            if (_system.helpOnce())
+                idle = 0;
+            else if (++idle > kSpinRounds)
+                std::this_thread::yield();
+        }
+        // The last task's job may still be finishing; the slot is reused after this.
+        if (slot.frame == frame)
+            _system.wait(slot.counter);
+    }
+
+    void TaskGraph::waitIdle()
+    {
+        const uint64_t first = _nextFrame > _maxFramesInFlight ? _nextFrame - _maxFramesInFlight : 0;
+        for (uint64_t frame = first; frame < _nextFrame; ++frame)
+            waitFrame(frame);
+    }
+
+    std::vector<TaskTiming> TaskGraph::taskTimings() const
+    {
+        std::lock_guard<std::mutex> lock(_timingMutex);
+        return (_taskTimings);
+    }
+
+    FrameTiming TaskGraph::frameTiming() const
+    {
+        std::lock_guard<std::mutex> lock(_timingMutex);
+        return (_frameTiming);
+    }
+
+    void TaskGraph::printTimings(FILE* out) const
+    {
+        std::lock_guard<std::mutex> lock(_timingMutex);
+        fprintf(out, "%llu frames: %.3f ms average, last %.3f ms, critical path %.3f ms\n",
+                (unsigned long long)_frameTiming.frames, _frameTiming.averageMs, _frameTiming.lastMs,
+                _frameTiming.lastCriticalPathMs);
+        for (const TaskTiming& timing : _taskTimings)
+        {
+            fprintf(out, "  %-16s %8.3f ms average, last %8.3f ms, waited %7.3f ms, critical %5.1f%%%s%s\n",
+                    timing.pName, timing.averageMs, timing.lastMs, timing.lastWaitMs, timing.criticalShare * 100.0,
+                    timing.lastCritical ? " *" : "", timing.lastGatedByPreviousFrame ? " (gated by previous frame)" : "");
+        }
+    }
+}
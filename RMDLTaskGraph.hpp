@@ -0,0 +1,166 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTaskGraph.hpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:52:06      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLTASKGRAPH_HPP
+# define RMDLTASKGRAPH_HPP
+
+# include <atomic>
+# include <cassert>
+# include <cstddef>
+# include <cstdint>
+# include <cstdio>
+# include <memory>
+# include <mutex>
+# include <vector>
+
+# include "NonCopyable.h"
+# include "RMDLJobSystem.hpp"
+
+namespace jobs
+{
+    using TaskId = uint32_t;
+
+    struct FrameInfo
+    {
+        uint64_t    frame;
+        uint32_t    slot;       // frame % maxFramesInFlight, to pick per-frame buffers
+    };
+
+    /// Per task, over the frames finished so far. A task is on the critical path of a frame when
+    /// the chain of tasks that each finished last among the inputs of the next leads to the
+    /// frame's last task: making it faster would have made that frame shorter.
+    struct TaskTiming
+    {
+        const char* pName = nullptr;
+        double      lastMs = 0.0;           // run time
+        double      averageMs = 0.0;
+        double      lastWaitMs = 0.0;       // from its last input finishing to starting
+        double      criticalShare = 0.0;    // of finished frames
+        bool        lastCritical = false;
+        bool        lastGatedByPreviousFrame = false;   // waited on a task of the frame before
+    };
+
+    struct FrameTiming
+    {
+        uint64_t    frames = 0;
+        double      lastMs = 0.0;           // from runFrame() to the last task finishing
+        double      averageMs = 0.0;
+        double      lastCriticalPathMs = 0.0;   // sum of run times along the critical path
+    };
+
+    /// The work of a frame as a graph of tasks, built once and run every frame on a JobSystem.
+    ///
+    /// A task runs once all its dependencies in the same frame are done, and, for frame
+    /// dependencies, once the given task of the previous frame is done; everything else may
+    /// overlap, including frames: while frame N builds its commands frame N + 1 can already
+    /// simulate, as long as at most maxFramesInFlight frames are unfinished. Each frame runs in
+    /// a slot of its own, so state a task hands to the next must be kept per slot.
+    ///
+    /// Tasks are called as fn(const FrameInfo&); fn must outlive the graph. Build the graph,
+    /// then call runFrame() from one thread.
+    class TaskGraph : public NonCopyable
+    {
+    public:
+        explicit TaskGraph(uint32_t maxFramesInFlight, JobSystem& system = JobSystem::shared());
+        ~TaskGraph();
+
+        template <typename Fn>
+        TaskId      addTask(const char* pName, Fn& fn);
+        void        addDependency(TaskId before, TaskId after);
+        /// after, in frame N, also waits for before in frame N - 1.
+        void        addFrameDependency(TaskId before, TaskId after);
+
+        /// Starts the next frame and returns its number without waiting for it, once the frame
+        /// maxFramesInFlight before it is finished; the wait runs queued jobs meanwhile.
+        uint64_t    runFrame();
+        void        waitFrame(uint64_t frame);
+        void        waitIdle();
+
+        std::vector<TaskTiming> taskTimings() const;
+        FrameTiming             frameTiming() const;
+        /// One line per task: average and last run time, wait, critical path share.
+        void                    printTimings(FILE* out) const;
+
+    private:
+        static constexpr TaskId kNoTask = UINT32_MAX;
+
+        struct Task
+        {
+            const char*         pName;
+            void                (*pFunction)(void* pContext, const FrameInfo& frame);
+            void*               pContext;
+            std::vector<TaskId> successors;
+            std::vector<TaskId> frameSuccessors;
+            std::vector<TaskId> frameDependencies;
+            uint32_t            dependencyCount = 0;
+        };
+
+        // One task in one frame slot.
+        struct Instance
+        {
+            TaskGraph*              pGraph;
+            TaskId                  task;
+            uint32_t                slot;
+            Job                     job;
+            std::atomic<uint32_t>   remaining{0};   // inputs not done yet, plus one until launched
+            TaskId                  gate;           // the input that finished last
+            bool                    gateCrossFrame;
+            uint64_t                readyNs;
+            uint64_t                startNs;
+            uint64_t                endNs;
+            bool                    done;           // both under _frameMutex, for frame dependencies
+            bool                    successorsWaiting;
+        };
+
+        struct Frame
+        {
+            uint64_t                frame = 0;
+            uint64_t                launchNs = 0;
+            std::atomic<uint32_t>   tasksLeft{0};
+            std::atomic<uint64_t>   completed{0};   // frame + 1 once finished
+            Counter                 counter;
+        };
+
+        void        build();
+        Instance&   instance(TaskId task, uint32_t slot) { return (_instances[(size_t)slot * _tasks.size() + task]); }
+        void        release(TaskId task, uint32_t slot, TaskId releaser, bool crossFrame);
+        void        runTask(Instance& instance);
+        void        finishFrame(Frame& frame, uint32_t slot);
+
+        JobSystem&                      _system;
+        uint32_t                        _maxFramesInFlight;
+        std::vector<Task>               _tasks;
+        std::unique_ptr<Instance[]>     _instances;
+        std::unique_ptr<Frame[]>        _frames;
+        uint64_t                        _nextFrame = 0;
+        std::mutex                      _frameMutex;
+
+        mutable std::mutex              _timingMutex;
+        std::vector<TaskTiming>         _taskTimings;
+        std::vector<double>             _taskTotalMs;
+        std::vector<uint64_t>           _taskCriticalFrames;
+        FrameTiming                     _frameTiming;
+        double                          _frameTotalMs = 0.0;
+    };
+
+    template <typename Fn>
+    TaskId TaskGraph::addTask(const char* pName, Fn& fn)
+    {
+        assert(!_instances && "tasks must be added before the first runFrame()");
+        Task task;
+        task.pName = pName;
+        task.pFunction = [](void* pContext, const FrameInfo& frame) { (*(Fn*)pContext)(frame); };
+        task.pContext = (void*)&fn;
+        _tasks.push_back(task);
+        return ((TaskId)_tasks.size() - 1);
+    }
+}
+
+#endif /* RMDLTASKGRAPH_HPP */
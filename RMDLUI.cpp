@@ -15,6 +15,8 @@ RMDLUI::~RMDLUI()
 /*void RMDLUI::initialize( const UIConfig& config, MTL::Device* pDevice, MTL::CommandQueue* pCommandQueue )
 {
     _uiConfig = config;
+    _scoreLayout.canvasWidth = (float)config.virtualCanvasWidth;
+    _scoreLayout.canvasHeight = (float)config.virtualCanvasHeight;
     createBuffers(pDevice);
     createResidencySet(pDevice, pCommandQueue);
     showHighScore("HIGH SCORE:", 0, pDevice);
@@ -23,9 +25,7 @@ RMDLUI::~RMDLUI()
 
 void RMDLUI::showHighScore( const char* label, int highscore, MTL::Device* pDevice )
 {
-    _bannerCountdownSecs = 5.0f;
-    float startY = _uiConfig.virtualCanvasHeight * 0.5 * 0.9;
-    _highScorePosition = simd_make_float4(0.0, startY, 0, 1);
+    _scoreLayout.showHighScore();
     std::stringstream ss;
     ss << label << highscore;
     mesh_utils::releaseMesh(&_highScoreMesh);
@@ -37,30 +37,16 @@ void RMDLUI::showCurrentScore( const char* label, int score, MTL::Device* pDevic
     std::stringstream ss;
     ss << label << score;
     const std::string& str = ss.str();
-    const float strWidth = (float)str.size() * 1.0f;
-    const float leftSide = (float)_uiConfig.virtualCanvasWidth * -0.5f;
-    const float leftMargin = (float)_uiConfig.virtualCanvasWidth * 0.025f;
-    const float bottomSide = (float)_uiConfig.virtualCanvasHeight * -0.5f;
-    const float bottomMargin = leftMargin;
-    _currentScorePosition = simd_make_float4(leftSide + leftMargin + strWidth*0.5f, bottomSide + bottomMargin, 0, 1);
+    _scoreLayout.showCurrentScore(str.size());
     mesh_utils::releaseMesh(&_currentScoreMesh);
     _currentScoreMesh = mesh_utils::newTextMesh(str, _uiConfig.firaCode, pDevice);
 }
 
 void RMDLUI::update(double targetTimestamp, uint8_t frameID)
 {
-    if (_lastTimestamp != 0.0)
-    {
-        double deltat = targetTimestamp - _lastTimestamp;
-        _bannerCountdownSecs = std::max(_bannerCountdownSecs - deltat, 0.0);
-        if (_bannerCountdownSecs <= 0.0 && _highScorePosition.y < _uiConfig.virtualCanvasHeight * 0.5 * 1.2)
-        {
-            _highScorePosition.y += 1.f * deltat;
-        }
-    }
-    _lastTimestamp = targetTimestamp;
-    ft_memcpy(_renderData.highScorePositionBuf[frameID]->contents(), &_highScorePosition, sizeof(simd::float4));
-    ft_memcpy(_renderData.currentScorePositionBuf[frameID]->contents(), &_currentScorePosition, sizeof(simd::float4));
+    _scoreLayout.update(targetTimestamp);
+    ft_memcpy(_renderData.highScorePositionBuf[frameID]->contents(), &_scoreLayout.highScorePosition, sizeof(simd::float4));
+    ft_memcpy(_renderData.currentScorePositionBuf[frameID]->contents(), &_scoreLayout.currentScorePosition, sizeof(simd::float4));
 }
 
 void RMDLUI::createBuffers(MTL::Device* pDevice)
@@ -78,7 +64,7 @@ void RMDLUI::createBuffers(MTL::Device* pDevice)
         _renderData.frameDataBuf[i] = NS::TransferPtr(_renderData.resourceHeaps[i]->newBuffer(sizeof(FrameData), MTL::ResourceStorageModeShared));
         _renderData.frameDataBuf[i]->setLabel(MTLSTR("UI Frame Data Buffer"));
         auto pFrameData = (FrameData *)_renderData.frameDataBuf[i]->contents();
-        pFrameData->projectionMatrix = math::makeOrtho(-canvasW/2, canvasW/2, canvasH/2, -canvasH/2, -1, 1);
+        pFrameData->projectionMatrix = math::cx::makeOrtho(-canvasW/2, canvasW/2, canvasH/2, -canvasH/2, -1, 1);
         _renderData.highScorePositionBuf[i] = NS::TransferPtr(_renderData.resourceHeaps[i]->newBuffer(sizeof(simd::float4), MTL::ResourceStorageModeShared));
         _renderData.highScorePositionBuf[i]->setLabel(MTLSTR("UI HighScore Position Buffer"));
         _renderData.currentScorePositionBuf[i] = NS::TransferPtr(_renderData.resourceHeaps[i]->newBuffer(sizeof(simd::float4), MTL::ResourceStorageModeShared));
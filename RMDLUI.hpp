@@ -9,6 +9,7 @@
 #include "RMDLMeshUtils.hpp"
 #include "RMDLConfig_Shared.h"
 #include "RMDLBumpAllocator.hpp"
+#include "RMDLGameLogic.hpp"
 
 #include <memory>
 
@@ -57,10 +58,7 @@ private:
     IndexedMesh     _highScoreMesh;
     IndexedMesh     _currentScoreMesh;
     
-    simd::float4    _highScorePosition;
-    simd::float4    _currentScorePosition;
-    double          _lastTimestamp = 0.0;
-    double          _bannerCountdownSecs = 0.0;
+    ScoreLayout     _scoreLayout;
 };
 
 #endif // RMDLUI_HPP